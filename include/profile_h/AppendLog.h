@@ -0,0 +1,80 @@
+#ifndef APPENDLOG_H
+#define APPENDLOG_H
+
+#include <functional>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+/**
+ * Append-only log shared by all Lina executions using the same file, used by the future and result caches. The file
+ * starts with a magic string followed by checksummed entries (payload size, payload, payload checksum). Entries are
+ * appended under an exclusive file lock and entries appended by other executions are read under a shared lock.
+ *
+ * A torn entry left by a crashed execution is ignored when read and truncated away by the next append. If the file
+ * cannot be opened or locked, nothing is read from or written to it and the caller keeps its entries in memory only.
+ *
+ * This class is not thread-safe, callers must serialise access among their threads.
+ */
+class AppendLog {
+public:
+	// Called for each payload read from the log. Returning false marks the payload as corrupt, stopping the read there
+	typedef std::function<bool(const std::string &)> consumerTy;
+
+private:
+	// Log file descriptor (-1 if no log is open) and position up to where the log was consumed
+	int logFD;
+	uint64_t logOffset;
+
+	static uint32_t checksum(const char *data, size_t size);
+	bool readLog(consumerTy consumer, bool &torn);
+
+public:
+	AppendLog() : logFD(-1), logOffset(0) { }
+	~AppendLog() { close(); }
+
+	// Open the log and consume all its entries. If the magic string is not found (empty, old format or corrupt file),
+	// the log is restarted and false is returned. False is also returned if the log could not be opened or locked
+	bool open(std::string fileName, std::string magicString, consumerTy consumer);
+	void close();
+	bool isOpen() const { return logFD != -1; }
+
+	// Consume entries appended by other executions since the last read
+	bool catchUp(consumerTy consumer);
+	// Consume entries appended by other executions, then call producer, which fills the payload to be appended and
+	// returns whether it should be appended at all. The producer is always called, even if nothing can be appended
+	bool append(consumerTy consumer, std::function<bool(std::string &)> producer);
+
+	template<typename T> static void appendElement(std::string &out, const T &value) {
+		out.append((const char *) &value, sizeof(T));
+	}
+
+	static void appendElement(std::string &out, const std::string &value) {
+		size_t size = value.size();
+		out.append((const char *) &size, sizeof(size_t));
+		out.append(value);
+	}
+
+	template<typename T> static bool extractElement(const std::string &in, size_t &pos, T &value) {
+		if(pos + sizeof(T) > in.size())
+			return false;
+
+		memcpy(&value, &in[pos], sizeof(T));
+		pos += sizeof(T);
+
+		return true;
+	}
+
+	static bool extractElement(const std::string &in, size_t &pos, std::string &value) {
+		size_t size;
+		if(!extractElement(in, pos, size) || pos + size > in.size())
+			return false;
+
+		value = in.substr(pos, size);
+		pos += size;
+
+		return true;
+	}
+};
+
+#endif // End of APPENDLOG_H
@@ -0,0 +1,67 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+// First chunk size of an arena. Following chunks double in size
+#define ARENA_INITIAL_CHUNK_SIZE (1 << 20)
+#define ARENA_MAX_CHUNK_SIZE (64 << 20)
+
+/**
+ * Monotonic memory resource. Allocations bump a pointer inside large chunks, deallocation is a no-op and all
+ * memory is released in one shot when the arena is destroyed (or release() is called).
+ *
+ * Memory of erased elements is only reclaimed on release. Thus only containers that are built once and discarded
+ * together should draw from an arena (e.g. the dependency tables of DDDGBuilder), never structures that are
+ * rebuilt many times during the life of the arena.
+ */
+class Arena {
+	std::vector<char *> chunks;
+	char *curr;
+	size_t left;
+	size_t nextChunkSize;
+	uint64_t bytesAllocated;
+
+	Arena(const Arena &) = delete;
+	Arena &operator=(const Arena &) = delete;
+
+public:
+	Arena();
+	~Arena();
+
+	void *allocate(size_t size, size_t alignment);
+	void release();
+
+	uint64_t getBytesAllocated() const;
+};
+
+// STL allocator that draws from an arena. Containers using it must not outlive the arena
+template<typename T> class ArenaAllocator {
+public:
+	typedef T value_type;
+
+	template<typename U> struct rebind {
+		typedef ArenaAllocator<U> other;
+	};
+
+	Arena *arena;
+
+	ArenaAllocator(Arena &arena) : arena(&arena) { }
+	template<typename U> ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) { }
+
+	T *allocate(size_t n) {
+		return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+	}
+	void deallocate(T *p, size_t n) { }
+
+	template<typename U> bool operator==(const ArenaAllocator<U> &other) const {
+		return arena == other.arena;
+	}
+	template<typename U> bool operator!=(const ArenaAllocator<U> &other) const {
+		return arena != other.arena;
+	}
+};
+
+#endif // End of ARENA_H
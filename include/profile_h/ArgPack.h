@@ -6,6 +6,10 @@ typedef struct {
 	std::string workDir;
 	std::string outWorkDir;
 	std::string configFileName;
+	// One configuration file per kernel, when several kernels are analysed (configFileName is the first)
+	std::vector<std::string> kernelConfigFileNames;
+	// Design space description file. If set, the design points are explored instead of a single estimation
+	std::string exploreFileName;
 	std::vector<std::string> kernelNames;
 
 	int mode;
@@ -31,13 +35,42 @@ typedef struct {
 #ifdef FUTURE_CACHE
 	bool futureCache;
 #endif
+#ifdef RESULT_CACHE
+	bool resultCache;
+#endif
+#ifdef ENABLE_TIMER
+	bool phaseProfile;
+#endif
+	// Structured output of the estimations, written alongside the summary (see ResultWriter)
+	int resultFormat;
+	enum {
+		RESULT_FORMAT_NONE = 0,
+		RESULT_FORMAT_JSONL = 1,
+		RESULT_FORMAT_CSV = 2,
+		RESULT_FORMAT_BINARY = 3
+	};
 	double frequency;
 	double uncertainty;
+	// Clock targets (frequency, uncertainty) to be estimated. More than one element triggers a clock sweep
+	std::vector<std::pair<double, double>> clockTargets;
 	bool memTrace;
 	bool showCFG;
 	bool showCFGDetailed;
 	bool showPreOptDDDG;
 	bool showPostOptDDDG;
+	// Format and filter of the DDDG dumps (see BaseDatapath::dumpGraph())
+	int dddgFormat;
+	enum {
+		DDDG_FORMAT_DOT = 0,
+		DDDG_FORMAT_BINARY = 1
+	};
+	int dddgFilter;
+	enum {
+		DDDG_FILTER_NONE = 0,
+		DDDG_FILTER_ITERATION = 1,
+		DDDG_FILTER_CRITICAL_PATH = 2
+	};
+	uint64_t dddgFilterIteration;
 	bool showScheduling;
 	bool fNPLA;
 	bool fNoTCS;
@@ -51,8 +84,12 @@ typedef struct {
 	bool fNoFPUThresOpt;
 	bool fExtraScalar;
 	bool fRWRWMem;
+	bool fModuloScheduling;
 	bool fArgRes;
 	bool fILL;
+	bool fExtrapolate;
+	// Maximum relative deviation of the samples from the extrapolation fit (see Extrapolator)
+	double extrapolationTolerance;
 
 	std::vector<std::string> targetLoops;
 } ArgPack;
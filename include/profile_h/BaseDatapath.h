@@ -4,20 +4,31 @@
 #include <algorithm>
 #include <assert.h>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <set>
+#include <sstream>
 #include <stdint.h>
 
 #include "profile_h/auxiliary.h"
 #include "profile_h/DDDGBuilder.h"
 #include "profile_h/HardwareProfile.h"
+#include "profile_h/PhaseProfiler.h"
+#include "profile_h/ResultWriter.h"
 
 #include "profile_h/boostincls.h"
 
+// Binary DDDG dumps (--dddg-format=bin), see BaseDatapath::dumpGraph() and misc/largedse/dddg.py
+#define DDDG_BINARY_MAGIC "LINADDG"
+#define DDDG_BINARY_VERSION 2
+// Size of the buffer flushed to the binary DDDG dump at once
+#define DDDG_BINARY_CHUNK_SIZE (1 << 20)
+
 typedef std::unordered_map<std::string, unsigned> staticInstID2OpcodeMapTy;
 extern staticInstID2OpcodeMapTy staticInstID2OpcodeMap;
 
@@ -27,18 +38,35 @@ typedef struct {
 	uint8_t paramID;
 } edgeTy;
 
+typedef struct {
+	unsigned from;
+	unsigned to;
+	unsigned distance;
+} carriedEdgeTy;
+
+// Changes to the DDDG accumulated by a rewrite, applied at once by BaseDatapath::applyEdgeDelta()
+typedef struct {
+	std::vector<Edge> edgesToRemove;
+	std::vector<edgeTy> edgesToAdd;
+	std::vector<unsigned> nodesToRemove;
+} edgeDeltaTy;
+
 class BaseDatapath {
 public:
 	// Additional costs for latency calculation
 	enum {
 		EXTRA_ENTER_EXIT_LOOP_LATENCY = 2
 	};
+	// Topological levels with less nodes than this are scheduled sequentially
+	enum {
+		PARALLEL_LEVEL_MIN_NODES = 4096
+	};
 
 	class TCScheduler {
-		const std::vector<int> &microops;
+		const std::vector<uint8_t> &microops;
 		const Graph &graph;
 		unsigned numOfTotalNodes;
-		const std::unordered_map<unsigned, Vertex> &nameToVertex;
+		const std::vector<Vertex> &nameToVertex;
 		const VertexNameMap &vertexToName;
 		HardwareProfile &profile;
 
@@ -48,9 +76,9 @@ public:
 
 	public:
 		TCScheduler(
-			const std::vector<int> &microops,
+			const std::vector<uint8_t> &microops,
 			const Graph &graph, unsigned numOfTotalNodes,
-			const std::unordered_map<unsigned, Vertex> &nameToVertex, const VertexNameMap &vertexToName,
+			const std::vector<Vertex> &nameToVertex, const VertexNameMap &vertexToName,
 			HardwareProfile &profile
 		);
 
@@ -67,11 +95,11 @@ public:
 		typedef std::map<unsigned, unsigned> executingMapTy;
 		typedef std::vector<unsigned> executedListTy;
 
-		const std::vector<int> &microops;
+		const std::vector<uint8_t> &microops;
 		const std::unordered_map<int, unsigned> &resultSizeList;
 		const Graph &graph;
 		unsigned numOfTotalNodes;
-		const std::unordered_map<unsigned, Vertex> &nameToVertex;
+		const std::vector<Vertex> &nameToVertex;
 		const VertexNameMap &vertexToName;
 		HardwareProfile &profile;
 		const std::unordered_map<int, std::pair<std::string, int64_t>> &baseAddress;
@@ -161,9 +189,9 @@ public:
 	public:
 		RCScheduler(
 			const std::string loopName, const unsigned loopLevel, const unsigned datapathType,
-			const std::vector<int> &microops, const std::unordered_map<int, unsigned> &resultSizeList,
+			const std::vector<uint8_t> &microops, const std::unordered_map<int, unsigned> &resultSizeList,
 			const Graph &graph, unsigned numOfTotalNodes,
-			const std::unordered_map<unsigned, Vertex> &nameToVertex, const VertexNameMap &vertexToName,
+			const std::vector<Vertex> &nameToVertex, const VertexNameMap &vertexToName,
 			HardwareProfile &profile, const std::unordered_map<int, std::pair<std::string, int64_t>> &baseAddress,
 			const std::vector<uint64_t> &asap, const std::vector<uint64_t> &alap, std::vector<uint64_t> &rc
 		);
@@ -172,28 +200,164 @@ public:
 
 		std::pair<uint64_t, double> schedule();
 	};
-	
+
+	class ModuloScheduler {
+		typedef struct {
+			unsigned nodeID;
+			unsigned latency;
+			unsigned distance;
+		} depTy;
+
+		// Scheduling budget per II attempt, as a multiple of the number of nodes
+		enum {
+			BUDGET_RATIO = 6
+		};
+
+		const std::vector<uint8_t> &microops;
+		const Graph &graph;
+		unsigned numOfTotalNodes;
+		const std::vector<Vertex> &nameToVertex;
+		const VertexNameMap &vertexToName;
+		const EdgeWeightMap &edgeToWeight;
+		HardwareProfile &profile;
+		const std::unordered_map<int, std::pair<std::string, int64_t>> &baseAddress;
+		const std::vector<carriedEdgeTy> &loopCarriedEdges;
+
+		std::vector<unsigned> activeNodes;
+		std::vector<unsigned> latencies;
+		std::vector<std::vector<depTy>> preds;
+		std::vector<std::vector<depTy>> succs;
+		std::vector<int64_t> heights;
+
+		// Constrained resources: name, amount of units/ports and the resource used by each node (-1 if none)
+		std::vector<std::string> resourceNames;
+		std::vector<unsigned> resourceAmounts;
+		std::vector<int> nodeResource;
+		std::vector<unsigned> nodeOccupancy;
+
+		// Modulo reservation table: for each resource and each slot, the nodes occupying it
+		std::vector<std::vector<std::vector<unsigned>>> mrt;
+		std::vector<int64_t> schedTime;
+		std::vector<int64_t> lastSchedTime;
+		// Unscheduled nodes, ordered by decreasing height
+		std::set<std::pair<int64_t, unsigned>> unscheduledNodes;
+
+		uint64_t resMII;
+		uint64_t recMII;
+		std::string resMIIName;
+
+		void buildDependencies();
+		void buildResources();
+		void calculateResMII();
+		void calculateRecMII();
+		void calculateHeights();
+
+		unsigned getSlotUsage(unsigned nodeID, int64_t time, uint64_t slot, uint64_t II);
+		bool resourceFits(unsigned nodeID, int64_t time, uint64_t II);
+		void reserve(unsigned nodeID, int64_t time, uint64_t II);
+		void unschedule(unsigned nodeID, uint64_t II);
+		bool tryII(uint64_t II);
+
+	public:
+		ModuloScheduler(
+			const std::vector<uint8_t> &microops,
+			const Graph &graph, unsigned numOfTotalNodes,
+			const std::vector<Vertex> &nameToVertex, const VertexNameMap &vertexToName, const EdgeWeightMap &edgeToWeight,
+			HardwareProfile &profile, const std::unordered_map<int, std::pair<std::string, int64_t>> &baseAddress,
+			const std::vector<carriedEdgeTy> &loopCarriedEdges
+		);
+
+		std::tuple<uint64_t, uint64_t> schedule();
+		uint64_t getResMII() const { return resMII; }
+		uint64_t getRecMII() const { return recMII; }
+		std::string getResMIIName() const { return resMIIName; }
+	};
+
+	// Groups operations of one type (e.g. stores) that depend on each other, i.e. one is ancestor of the other.
+	// Tracked ancestors of an untracked node are only joined if some tracked node descends from it, and in that case
+	// they all end up in the component of that descendant. Thus such nodes merge the components of their tracked
+	// ancestors right away (union-find) and hold a single representative. Nodes that neither are nor reach a tracked
+	// node hold none
+	class DependabilityTracker {
+		unsigned trackedOpcode;
+		std::vector<unsigned> unionParent;
+		// Representative of the components of the tracked ancestors of each node (-1 if none)
+		std::vector<int> ancestorComponent;
+		std::vector<bool> reachesTracked;
+		std::vector<bool> active;
+
+		unsigned find(unsigned nodeID);
+		void join(unsigned nodeID, unsigned otherID);
+
+	public:
+		// Nodes are given in topological order, with their parents in (offsets, sources) form
+		void init(
+			unsigned trackedOpcode, const std::vector<uint8_t> &microops, const std::vector<unsigned> &topologicalOrder,
+			const std::vector<unsigned> &inEdgeOffsets, const std::vector<unsigned> &inEdgeSources
+		);
+		void inherit(unsigned targetID, unsigned sourceID);
+		void finalise(unsigned nodeID, unsigned opcode);
+		// Per-node state is only needed while the DDDG is traversed, the components are kept
+		void release();
+		std::vector<std::vector<unsigned>> getComponents(const std::vector<uint8_t> &microops);
+	};
+
 	class ColorWriter {
-		Graph &graph;
 		VertexNameMap &vertexNameMap;
-		const std::vector<std::string> &bbNames;
-		const std::vector<std::string> &funcNames;
-		std::vector<int> &opcodes;
-		llvm::bbFuncNamePair2lpNameLevelPairMapTy &bbFuncNamePair2lpNameLevelPairMap;
+		std::vector<uint8_t> &opcodes;
+		// "color=..." attribute of each node, empty if its BB is not inside a loop (such nodes are written without attributes)
+		const std::vector<std::string> &colorStrings;
 
 	public:
-		ColorWriter(
-			Graph &graph,
-			VertexNameMap &vertexNameMap,
-			const std::vector<std::string> &bbNames,
-			const std::vector<std::string> &funcNames,
-			std::vector<int> &opcodes,
-			llvm::bbFuncNamePair2lpNameLevelPairMapTy &bbFuncNamePair2lpNameLevelPairMap
-		);
+		ColorWriter(VertexNameMap &vertexNameMap, std::vector<uint8_t> &opcodes, const std::vector<std::string> &colorStrings);
 
+		static std::string getColorString(unsigned color);
 		template<class VE> void operator()(std::ostream &out, const VE &v) const;
 	};
 
+	// DDDG rewrites (e.g. PHI removal, shared load removal) are registered as passes that visit one node at a time.
+	// Consecutive passes with the same visiting order are fused into a single sweep over the DDDG. Within a sweep, all
+	// passes see the edges as they were before the sweep (their changes are accumulated in one edgeDeltaTy and applied
+	// when the sweep ends), thus passes that depend on the edge changes of the previous ones must be barriers.
+	// Microop changes are seen immediately, so fused passes must not read microops changed by each other.
+	// Passes that do not need to visit nodes one at a time (e.g. those that work over sorted address lists) are
+	// registered as bulk passes, which run once and alone in their sweep
+	class RewritePassManager {
+	public:
+		// Node IDs follow the trace order, thus parents are always visited before their children in ascending order
+		enum {
+			ORDER_ASCENDING = 0,
+			ORDER_DESCENDING = 1,
+			ORDER_BULK = 2
+		};
+
+		typedef std::function<void(unsigned, edgeDeltaTy &)> visitFuncTy;
+		typedef std::function<void(edgeDeltaTy &)> bulkFuncTy;
+		typedef std::function<void()> finaliseFuncTy;
+
+	private:
+		typedef struct {
+			std::string name;
+			unsigned order;
+			bool barrier;
+			visitFuncTy visit;
+			bulkFuncTy bulk;
+			finaliseFuncTy finalise;
+		} passTy;
+
+		BaseDatapath &datapath;
+		std::vector<passTy> passes;
+
+		void runSweep(std::vector<passTy>::iterator first, std::vector<passTy>::iterator last);
+
+	public:
+		RewritePassManager(BaseDatapath &datapath);
+
+		void addPass(std::string name, unsigned order, bool barrier, visitFuncTy visit, finaliseFuncTy finalise = nullptr);
+		void addBulkPass(std::string name, bulkFuncTy bulk, finaliseFuncTy finalise = nullptr);
+		void run();
+	};
+
 	class EdgeColorWriter {
 		Graph &graph;
 		EdgeWeightMap &edgeWeightMap;
@@ -214,8 +378,9 @@ private:
 
 	HardwareProfile *profile;
 
-	void findMinimumRankPair(std::pair<unsigned, unsigned> &pair, std::map<unsigned, unsigned> rankMap);
 	static bool prioritiseLargerResIIMem(const std::pair<std::string, double> &first, const std::pair<std::string, double> &second) { return first.second < second.second; }
+	static std::string getClockSweepSuffix(HardwareProfile &profile);
+	static void runInParallel(unsigned from, unsigned to, std::function<void(unsigned, unsigned)> kernel);
 
 public:
 	BaseDatapath(
@@ -229,33 +394,50 @@ public:
 		std::string loopName, unsigned loopLevel, uint64_t loopUnrollFactor, unsigned datapathType
 	);
 
+	BaseDatapath(
+		BaseDatapath &source, double frequency, double uncertainty, uint64_t asapII, std::ostream *summaryFile
+	);
+
 	~BaseDatapath();
 
 	std::string getTargetLoopName() const;
 	unsigned getTargetLoopLevel() const;
 	uint64_t getTargetLoopUnrollFactor() const;
+	unsigned getDatapathType() const;
 	unsigned getNumNodes() const;
 	unsigned getNumEdges() const;
 	uint64_t getMaxII() const;
 	uint64_t getRCIL() const;
 	Pack &getPack();
+	const std::vector<uint64_t> &getSweepASAPII() const;
+	const std::vector<uint64_t> &getSweepCycles() const;
+	const std::vector<Pack> &getSweepPacks() const;
+	std::set<std::string> getReferencedArrays() const;
+	static uint64_t getLoopTotalLatency(std::string loopName, unsigned loopLevel, bool enablePipelining, uint64_t rcIL, uint64_t maxII);
+	uint64_t reestimateWithPartitions(
+		const ConfigurationManager::partitionCfgMapTy &partitionCfgMap,
+		const ConfigurationManager::partitionCfgMapTy &completePartitionCfgMap
+	);
 
 	void postDDDGBuild();
 	void refreshDDDG();
 	void insertMicroop(int microop);
 	void insertDDDGEdge(unsigned from, unsigned to, uint8_t paramID);
+	void insertLoopCarriedEdge(unsigned from, unsigned to, unsigned distance);
 	bool edgeExists(unsigned from, unsigned to);
 	void updateRemoveDDDGEdges(std::set<Edge> &edgesToRemove);
 	void updateAddDDDGEdges(std::vector<edgeTy> &edgesToAdd);
 	void updateRemoveDDDGNodes(std::vector<unsigned> &nodesToRemove);
+	void applyEdgeDelta(edgeDeltaTy &delta);
 
-	std::string constructUniqueID(std::string funcID, std::string instID, std::string bbID);
 
 protected:
 	// Special edge types
 	enum {
 		EDGE_CONTROL = 200,
-		EDGE_PIPE = 201
+		EDGE_PIPE = 201,
+		// Memory dependency (DDDGBuilder inserts these with parameter ID -1)
+		EDGE_MEMORY = 255
 	};
 
 	unsigned datapathType;
@@ -264,17 +446,19 @@ protected:
 	uint64_t numCycles;
 
 	DDDGBuilder *builder;
-	ParsedTraceContainer PC;
+	// Trace container owned by this datapath. Clock sweep datapaths use the one from their source datapath instead
+	ParsedTraceContainer ownPC;
+	ParsedTraceContainer &PC;
 	Pack P;
 
-	// A map from node ID to its microop
-	std::vector<int> microops;
+	// A map from node ID to its microop (all LLVM_IR_* opcodes fit in a byte)
+	std::vector<uint8_t> microops;
 	// The DDDG
 	Graph graph;
 	// Number of nodes in the graph
 	unsigned numOfTotalNodes;
-	// A map from node ID to boost internal ID
-	std::unordered_map<unsigned, Vertex> nameToVertex;
+	// A map from node ID to boost internal ID (dense, since vertices are stored in a vector)
+	std::vector<Vertex> nameToVertex;
 	// A map from boost internal ID to node ID
 	VertexNameMap vertexToName;
 	// A map from edge internal ID to its weight (parameter ID before estimation, node latency after estimation)
@@ -288,11 +472,24 @@ protected:
 	// A set containing the name of all arrays that are not marked for partitioning
 	std::set<std::string> noPartitionArrayName;
 	// Memory disambiguation context variable
-  	std::unordered_set<std::string> dynamicMemoryOps;
+  	std::unordered_set<unsigned> dynamicMemoryOps;
 	// Vector with scheduled times for each node
 	std::vector<uint64_t> asapScheduledTime;
 	std::vector<uint64_t> alapScheduledTime;
 	std::vector<uint64_t> rcScheduledTime;
+	// Cached topological levelisation of the DDDG, invalidated whenever edges change. Nodes of the same level are
+	// independent. In/out edges of each node are stored contiguously (offsets are indexed by node ID)
+	bool topologicalCacheValid;
+	std::vector<unsigned> levelOffsets;
+	std::vector<unsigned> levelNodes;
+	std::vector<unsigned> inEdgeOffsets;
+	std::vector<unsigned> inEdgeSources;
+	std::vector<Edge> inEdges;
+	std::vector<unsigned> outEdgeOffsets;
+	std::vector<unsigned> outEdgeTargets;
+	std::vector<Edge> outEdges;
+	// Dependencies between this DDDG and the next one (i.e. next iteration of the pipelined loop)
+	std::vector<carriedEdgeTy> loopCarriedEdges;
 	// Dependability sets, used for approximating ResMIIMem
 	std::unordered_map<unsigned, std::set<std::string>> loadDependabilityMap;
 	std::unordered_map<unsigned, std::set<std::string>> storeDependabilityMap;
@@ -311,44 +508,92 @@ protected:
 	uint64_t sharedLoadsRemoved;
 	uint64_t repeatedStoresRemoved;
 
-	// Dependency maps, used for approximating ResMIIMem
-	std::unordered_map<unsigned, std::set<unsigned>> loadDepMap;
-	std::unordered_map<unsigned, std::set<unsigned>> storeDepMap;
+	// Dependency trackers, used for approximating ResMIIMem
+	DependabilityTracker loadDeps;
+	DependabilityTracker storeDeps;
+
+	// Results for each clock target when a clock sweep is performed (same order as args.clockTargets)
+	std::vector<uint64_t> sweepASAPII;
+	std::vector<uint64_t> sweepCycles;
+	std::vector<Pack> sweepPacks;
+	// Clock sweep datapaths and their summaries, kept alive so that they can be re-estimated
+	std::vector<std::unique_ptr<BaseDatapath>> sweepDatapaths;
+	std::vector<std::unique_ptr<std::stringstream>> sweepSummaries;
+	// Structured results of clock sweep datapaths are kept until all targets finish, so that they are written
+	// in the same order as the summaries. Extrapolation samples also keep their results here (see Extrapolator)
+	bool deferResults;
+	std::vector<ResultWriter::recordTy> deferredResults;
+
+	// State kept after the first estimation, so that only partition-dependent steps are repeated on re-estimation:
+	// - base addresses before partition assignment;
+	// - hardware profile with the unconstrained resources calculated during ALAP;
+	// - ASAP latency (used for recII calculation).
+	std::unordered_map<int, std::pair<std::string, int64_t>> unpartitionedBaseAddress;
+	// Memory nodes with their interned array IDs and element offsets (see initBaseAddress()), so that partition
+	// assignment is a bulk pass over integers. The bank of each memory node is in memoryNodeBanks and partition names
+	// are built once per (array, bank) pair. calculateResIIMemPort() counts accesses over these lists directly
+	std::vector<std::string> arrayNames;
+	std::vector<unsigned> memoryNodes;
+	std::vector<unsigned> memoryNodeArrays;
+	std::vector<int64_t> memoryNodeOffsets;
+	std::vector<int64_t> memoryNodeBanks;
+	// Partitioning factor of each array for the current partitioning (1 if not partitioned)
+	std::vector<uint64_t> arrayPartitionFactors;
+	std::vector<std::unordered_map<int64_t, std::string>> partitionNames;
+	HardwareProfile *unconstrainedProfile;
+	uint64_t asapLatency;
 
 	void initBaseAddress();
+	void invalidateTopologicalCache();
+	void buildTopologicalCache();
+	const std::vector<unsigned> &getTopologicalOrder();
 
 	uint64_t fpgaEstimationOneMoreSubtraceForRecIICalculation();
+	uint64_t fpgaEstimationOneMoreSubtraceForRecIICalculationPerClock();
 	uint64_t fpgaEstimation();
-
-	void removeInductionDependencies();
-	void removePhiNodes();
-	void enableStoreBufferOptimisation();
-	void initScratchpadPartitions();
+	uint64_t fpgaEstimationPerClock();
+	uint64_t fpgaEstimationPerPartition(
+		const ConfigurationManager::partitionCfgMapTy &partitionCfgMap,
+		const ConfigurationManager::partitionCfgMapTy &completePartitionCfgMap
+	);
+	bool updateEdgeWeightsWithLatencies();
+	std::vector<uint64_t> runClockSweep(uint64_t (BaseDatapath::*perClockFunc)());
+	std::vector<uint64_t> runOnSweepDatapaths(std::function<uint64_t(BaseDatapath &)> perClockFunc);
+
+	void rewriteDDDG();
+	void removeInductionDependencies(RewritePassManager &RPM);
+	void removePhiNodes(RewritePassManager &RPM);
+	void enableStoreBufferOptimisation(RewritePassManager &RPM);
+	void initScratchpadPartitions(const ConfigurationManager::partitionCfgMapTy &partitionMap);
 	void optimiseDDDG();
 	void performMemoryDisambiguation();
-	void removeSharedLoads();
-	void removeRepeatedStores();
-	void reduceTreeHeight(bool (&isAssociativeFunc)(unsigned));
+	void removeSharedLoads(RewritePassManager &RPM);
+	void removeRepeatedStores(RewritePassManager &RPM);
+	void gatherMemoryOps(std::vector<std::pair<int64_t, unsigned>> &addressNodePairs, bool storesOnly);
+	void reduceTreeHeight(RewritePassManager &RPM, bool (&isAssociativeFunc)(unsigned), bool barrier);
 
 	std::tuple<uint64_t, uint64_t> asapScheduling();
 	void alapScheduling(std::tuple<uint64_t, uint64_t> asapResult);
 	void identifyCriticalPaths();
-	std::pair<uint64_t, double> rcScheduling();
+	void prepareRCScheduling();
+	std::pair<uint64_t, double> rcScheduling(
+		const ConfigurationManager::partitionCfgMapTy &partitionCfgMap,
+		const ConfigurationManager::partitionCfgMapTy &completePartitionCfgMap
+	);
+	std::tuple<uint64_t, uint64_t, uint64_t> moduloScheduling();
 	std::tuple<std::string, uint64_t> calculateResIIMem();
 	std::tuple<std::string, uint64_t> calculateResIIMemPort();
 	std::tuple<std::string, uint64_t> calculateResIIMemRec();
 	uint64_t calculateRecII(uint64_t currAsapII);
 	uint64_t getLoopTotalLatency(uint64_t maxII);
 
-	void inheritLoadDepMap(unsigned targetID, unsigned sourceID);
-	void inheritStoreDepMap(unsigned targetID, unsigned sourceID);
-	void addToLoadDepMap(unsigned targetID, unsigned toAddID);
-	void addToStoreDepMap(unsigned targetID, unsigned toAddID);
-
 	void dumpSummary(
 		uint64_t numCycles, uint64_t asapII, double achievedPeriod,
 		uint64_t maxII, std::tuple<std::string, uint64_t> resIIMem, std::tuple<std::string, uint64_t> resIIOp, uint64_t recII
 	);
+	// Dump the DDDG as DOT (optionally only the nodes selected by --dddg-filter) or as a compact binary file with
+	// microops, ASAP/ALAP scheduled times (0 if not yet calculated) and edges. Both are written as they are
+	// generated, without building an intermediate representation
 	void dumpGraph(bool isOptimised = false);
 };
 
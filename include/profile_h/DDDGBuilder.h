@@ -3,6 +3,7 @@
 
 #include <fstream>
 #include <map>
+#include <mutex>
 #include <set>
 #include <stack>
 #include <stdint.h>
@@ -11,13 +12,21 @@
 #include <unordered_map>
 #include <zlib.h>
 
+#include "profile_h/AppendLog.h"
+#include "profile_h/Arena.h"
 #include "profile_h/auxiliary.h"
 #include "profile_h/opcodes.h"
 
 #ifdef FUTURE_CACHE
 #define FILE_FUTURE_CACHE "futurecache.db"
-#define FILE_FUTURE_CACHE_MAGIC_STRING "!BU"
-
+#define FILE_FUTURE_CACHE_MAGIC_STRING "!BV"
+
+/**
+ * The future cache file is an append-only log (see AppendLog) shared by all Lina executions using the same file. Each
+ * entry is appended as soon as it is inserted, and entries appended by other executions are read whenever a lookup
+ * misses. Lookups and insertions are also serialised among the threads of this execution, as kernels may be
+ * analysed concurrently.
+ */
 class FutureCache {
 public:
 	struct elemTy {
@@ -42,14 +51,20 @@ public:
 
 private:
 	std::map<std::string, elemTy> cache;
+	std::mutex mutex;
 	unsigned cacheMiss;
 	unsigned cacheHit;
+	AppendLog cacheLog;
 
 	std::string constructKey(std::string wholeLoopName, unsigned datapathType, long int progressiveTraceCursor, uint64_t progressiveTraceInstCount);
+	bool consumeEntry(const std::string &payload);
 
 public:
 	FutureCache() : cacheMiss(0), cacheHit(0) { };
+	~FutureCache();
 	void dumpSummary(std::ofstream *summaryFile);
+	// Write the cache statistics as a structured result (see ResultWriter)
+	void writeResults();
 
 	bool load();
 	void save();
@@ -99,41 +114,67 @@ struct edgeNodeInfo {
 	int paramID;
 };
 
-typedef std::unordered_multimap<unsigned, edgeNodeInfo> u2eMMap;
+// Dependency tables of DDDGBuilder, allocated from its arena
+typedef std::unordered_multimap<
+	unsigned, edgeNodeInfo, std::hash<unsigned>, std::equal_to<unsigned>, ArenaAllocator<std::pair<const unsigned, edgeNodeInfo>>
+> u2eMMap;
 
-typedef std::unordered_map<int64_t, unsigned> i642uMap;
+typedef std::unordered_map<int64_t, unsigned, std::hash<int64_t>, std::equal_to<int64_t>, ArenaAllocator<std::pair<const int64_t, unsigned>>> i642uMap;
 
 class BaseDatapath;
 
+// Attributes of a static instruction, i.e. an instruction ID executed by a dynamic function instance after a given basic
+// block (see ParsedTraceContainer::appendToStaticInstIDList()). They are computed once and shared by all nodes of the DDDG
+// that execute this instruction, instead of inspecting the name strings of each node
+typedef struct {
+	unsigned functionID;
+	unsigned dynamicFunctionID;
+	unsigned prevBBID;
+	// Instruction ID inside its static function, regardless of the previous basic block
+	unsigned instructionID;
+	uint8_t flags;
+} staticInstTy;
+
 class ParsedTraceContainer {
+public:
+	enum {
+		STATIC_INST_INDUCTION = 0x01
+	};
+
+private:
 	BaseDatapath *datapath;
 
-	std::string funcFileName;
-	std::string instIDFileName;
 	std::string lineNoFileName;
 	std::string memoryTraceFileName;
 	std::string getElementPtrFileName;
-	std::string prevBasicBlockFileName;
 	std::string currBasicBlockFileName;
 	std::string resultSizeFileName;
 
-	gzFile funcFile;
-	gzFile instIDFile;
 	gzFile lineNoFile;
 	gzFile memoryTraceFile;
 	gzFile getElementPtrFile;
-	gzFile prevBasicBlockFile;
 	gzFile currBasicBlockFile;
 	gzFile resultSizeFile;
 
-	std::vector<std::string> funcList;
-	std::vector<std::string> instIDList;
 	std::vector<int> lineNoList;
 	std::unordered_map<int, std::pair<int64_t, unsigned>> memoryTraceList;
 	std::unordered_map<int, std::pair<std::string, int64_t>> getElementPtrList;
-	std::vector<std::string> prevBasicBlockList;
 	std::vector<std::string> currBasicBlockList;
 	std::unordered_map<int, unsigned> resultSizeList;
+	// Static instruction of each node and the attributes of each static instruction. These are small, thus they are
+	// always kept in memory (also when compressed is set)
+	std::vector<unsigned> staticInstIDList;
+	std::vector<staticInstTy> staticInstList;
+	s2uMap staticInstMap;
+	// Names of the (static) functions and IDs of the dynamic functions, basic blocks and instructions referenced by
+	// staticInstList
+	std::vector<std::string> functionNameList;
+	s2uMap functionNameMap;
+	s2uMap dynamicFunctionMap;
+	s2uMap basicBlockMap;
+	s2uMap instructionMap;
+
+	static unsigned getOrInsertID(s2uMap &map, std::string name);
 
 	bool compressed;
 	bool keepAliveRead;
@@ -149,28 +190,29 @@ public:
 	void closeAllFiles();
 	void lock();
 
-	void appendToFuncList(std::string elem);
-	void appendToInstIDList(std::string elem);
 	void appendToLineNoList(int elem);
 	void appendToMemoryTraceList(int key, int64_t elem, unsigned elem2);
 	void appendToGetElementPtrList(int key, std::string elem, int64_t elem2);
-	void appendToPrevBBList(std::string elem);
 	void appendToCurrBBList(std::string elem);
 	void appendToResultSizeList(int key, unsigned elem);
+	void appendToStaticInstIDList(std::string staticFunction, std::string dynamicFunction, std::string instID, std::string prevBB);
 
-	const std::vector<std::string> &getFuncList();
-	const std::vector<std::string> &getInstIDList();
 	const std::vector<int> &getLineNoList();
 	const std::unordered_map<int, std::pair<int64_t, unsigned>> &getMemoryTraceList();
 	const std::unordered_map<int, std::pair<std::string, int64_t>> &getGetElementPtrList();
-	const std::vector<std::string> &getPrevBBList();
 	const std::vector<std::string> &getCurrBBList();
 	const std::unordered_map<int, unsigned> &getResultSizeList();
+	const std::vector<unsigned> &getStaticInstIDList();
+	const std::vector<staticInstTy> &getStaticInstList();
+	const std::vector<std::string> &getFunctionNameList();
 };
 
 class DDDGBuilder {
 	BaseDatapath *datapath;
 	ParsedTraceContainer &PC;
+	// The dependency tables are only used while the DDDG is built and are released in one shot with the builder.
+	// Must be declared before them
+	Arena arena;
 
 	std::string rest;
 	uint8_t prevMicroop, currMicroop;
@@ -192,6 +234,16 @@ class DDDGBuilder {
 	u2eMMap memoryEdgeTable;
 	unsigned numOfRegDeps, numOfMemDeps;
 	i642uMap addressLastWritten;
+	// Candidates for loop-carried dependencies: PHI operands coming from outside the analysed iterations
+	// and loads that were not preceded by a store to the same address
+	std::vector<std::pair<unsigned, std::string>> phiCarriedCandidates;
+	std::vector<std::pair<unsigned, int64_t>> loadCarriedCandidates;
+	unsigned numOfCarriedDeps;
+	// Trace I/O performed by this builder (decompressed bytes read and seeks), reported by the phase profiler
+	uint64_t traceBytesRead, traceSeeks;
+
+	char *traceGets(gzFile &traceFile, char *buffer, int size);
+	z_off_t traceSeek(gzFile &traceFile, z_off_t offset, int whence);
 
 	intervalTy getTraceLineFromTo(gzFile &traceFile);
 	void parseTraceFile(gzFile &traceFile, intervalTy interval);
@@ -203,6 +255,7 @@ class DDDGBuilder {
 	bool lookaheadIsSameLoopLevel(gzFile &traceFile, unsigned loopLevel);
 
 	void writeDDDG();
+	void writeLoopCarriedEdges();
 
 public:
 	DDDGBuilder(BaseDatapath *datapath, ParsedTraceContainer &PC);
@@ -216,6 +269,10 @@ public:
 
 	unsigned getNumOfRegisterDependencies();
 	unsigned getNumOfMemoryDependencies();
+	unsigned getNumOfLoopCarriedDependencies();
+	uint64_t getTraceBytesRead();
+	uint64_t getTraceSeeks();
+	uint64_t getArenaBytes();
 };
 
 #endif
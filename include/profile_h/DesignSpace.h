@@ -0,0 +1,96 @@
+#ifndef DESIGNSPACE_H
+#define DESIGNSPACE_H
+
+#include <istream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Minimal JSON reader, only what is needed to read the design space description files (see misc/largedse)
+class JSONValue {
+	void parseValue(std::istream &in);
+	void parseString(std::istream &in, std::string &str);
+	void parseNumber(std::istream &in);
+	void parseLiteral(std::istream &in, std::string literal);
+	static void skipWhitespace(std::istream &in);
+
+public:
+	enum {
+		JSON_NULL,
+		JSON_BOOL,
+		JSON_NUMBER,
+		JSON_STRING,
+		JSON_ARRAY,
+		JSON_OBJECT
+	};
+
+	unsigned type;
+	bool boolValue;
+	double numberValue;
+	// For numbers, the original text is also kept here
+	std::string stringValue;
+	std::vector<JSONValue> arrayValue;
+	// Objects keep their members in the order they were declared
+	std::vector<std::pair<std::string, JSONValue>> objectValue;
+
+	JSONValue() : type(JSON_NULL), boolValue(false), numberValue(0) { }
+
+	static JSONValue parse(std::istream &in);
+
+	bool has(std::string key) const;
+	const JSONValue &at(std::string key) const;
+	bool isEmpty() const;
+};
+
+// Enumerates the design points described in a design space file, in the same order as misc/largedse/run.py does
+class DesignSpace {
+public:
+	struct loopCfgTy {
+		unsigned id;
+		unsigned depth;
+		// 0 means no unrolling
+		uint64_t unrolling;
+		bool pipelining;
+	};
+	struct arrayCfgTy {
+		enum {
+			PARTITION_NONE,
+			PARTITION_BLOCK,
+			PARTITION_CYCLIC,
+			PARTITION_COMPLETE
+		};
+		std::string name;
+		unsigned type;
+		uint64_t factor;
+	};
+
+private:
+	std::string kernelName;
+	JSONValue root;
+	std::string freqPerKey;
+	unsigned freqPerIdx;
+
+	std::vector<loopCfgTy> loopsCfg;
+	std::vector<arrayCfgTy> arraysCfg;
+	bool started;
+	std::string startCode;
+
+	const JSONValue &getLoopDescription(const loopCfgTy &loop) const;
+	void nextDesignPoint();
+
+public:
+	DesignSpace(std::string fileName, std::string kernelName);
+
+	bool generateDesignPoint();
+	bool bypass() const;
+
+	std::string getPlatform() const;
+	double getFrequency() const;
+	std::string getCode() const;
+	std::string getLoopsCode() const;
+	std::string getArraysCode() const;
+	void writeLoopsConfiguration(std::ostream &out) const;
+	void writeArraysConfiguration(std::ostream &out) const;
+};
+
+#endif // End of DESIGNSPACE_H
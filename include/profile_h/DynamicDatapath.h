@@ -17,7 +17,7 @@ public:
 	DynamicDatapath(
 		std::string kernelName, ConfigurationManager &CM, std::ofstream *summaryFile,
 		std::string loopName, unsigned loopLevel, uint64_t loopUnrollFactor,
-		bool enablePipelining, uint64_t asapII
+		bool enablePipelining, uint64_t asapII, const std::vector<uint64_t> &sweepASAPII = std::vector<uint64_t>()
 	);
 
 	DynamicDatapath(
@@ -25,6 +25,12 @@ public:
 		std::string loopName, unsigned loopLevel, uint64_t loopUnrollFactor, unsigned datapathType
 	);
 
+	DynamicDatapath(
+		std::string kernelName, ConfigurationManager &CM, std::ofstream *summaryFile,
+		std::string loopName, unsigned loopLevel, uint64_t loopUnrollFactor,
+		bool enablePipelining, uint64_t asapII, ResultWriter::recordTy &sample
+	);
+
 	~DynamicDatapath();
 
 	uint64_t getASAPII() const;
@@ -0,0 +1,94 @@
+#ifndef EXTRAPOLATOR_H
+#define EXTRAPOLATOR_H
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "profile_h/DynamicDatapath.h"
+#include "profile_h/ResultWriter.h"
+
+// Loops with smaller unroll factors are always estimated exactly
+#define EXTRAPOLATION_MIN_UNROLL_FACTOR 16
+// Samples are estimated with unroll factors 1, 2, 4, ... (up to this number of samples)
+#define EXTRAPOLATION_NUM_SAMPLES 4
+// Minimum number of samples in the steady state (i.e. used by the fit)
+#define EXTRAPOLATION_MIN_FIT_SAMPLES 3
+// Default relative tolerance for the fit residual (see --extrapolation-tol)
+#define EXTRAPOLATION_DEFAULT_TOLERANCE 0.05
+
+/**
+ * Analytical extrapolation of loops with large unroll factors (--f-extrapolate). The DDDG of an unrolled loop body
+ * grows linearly with the unroll factor and, once past the first few factors, so do most values derived from it:
+ * iteration latency, memory port pressure (resII), functional units of each HardwareProfile class, FFs and LUTs.
+ *
+ * Instead of building and scheduling the DDDG with all unrolled iterations, the loop is estimated with unroll
+ * factors 1, 2, 4 and 8 and each value is fitted as a + b * unroll. Leading samples are dropped while they do not
+ * fit (i.e. before steady state). The total cycles are then calculated from the extrapolated latency and II with
+ * BaseDatapath::getLoopTotalLatency(), together with an error bound from the prediction interval of the fit.
+ *
+ * If no steady state is found where all values deviate from their fit by less than args.extrapolationTolerance,
+ * extrapolate() fails and the loop must be estimated exactly. Floating point values (e.g. memory efficiency) are
+ * not extrapolated, the values of the largest sample are used instead.
+ *
+ * XXX: Changes that only happen past the largest sample (e.g. units becoming limited by DSP usage) are not detected
+ */
+class Extrapolator {
+	struct fitTy {
+		double intercept;
+		double slope;
+		// Largest deviation from the fit, relative to the largest sampled value
+		double residual;
+		// Residual standard error and terms of the prediction interval
+		double stdError;
+		double meanX;
+		double sxx;
+		unsigned n;
+	};
+
+	std::string kernelName;
+	ConfigurationManager &CM;
+	std::ofstream *summaryFile;
+	std::string loopName;
+	unsigned loopLevel;
+	uint64_t unrollFactor;
+	uint64_t loopBound;
+	bool enablePipelining;
+
+	// Summaries of the samples are not written anywhere (this stream is never opened)
+	std::ofstream discardedSummary;
+	std::vector<uint64_t> factors;
+	std::vector<ResultWriter::recordTy> samples;
+	std::set<std::string> referencedArrays;
+
+	ResultWriter::recordTy result;
+	unsigned firstFitSample;
+	uint64_t cyclesBound;
+
+	static std::map<std::string, double> getValues(const ResultWriter::recordTy &record);
+	static fitTy fit(const std::vector<double> &x, const std::vector<double> &y);
+	static double predict(const fitTy &f, double x);
+	static double getPredictionBound(const fitTy &f, double x);
+
+	bool sample(uint64_t factor);
+
+public:
+	Extrapolator(
+		std::string kernelName, ConfigurationManager &CM, std::ofstream *summaryFile,
+		std::string loopName, unsigned loopLevel, uint64_t unrollFactor, uint64_t loopBound, bool enablePipelining
+	);
+
+	static bool isApplicable(uint64_t unrollFactor);
+
+	bool extrapolate();
+
+	uint64_t getCycles() const;
+	std::set<std::string> getReferencedArrays() const;
+
+	void dumpSummary();
+};
+
+#endif // End of EXTRAPOLATOR_H
@@ -48,6 +48,11 @@ protected:
 	bool thresholdSet;
 	std::set<int> limitedBy;
 
+	// Clock target of this profile (frequency in MHz and uncertainty in %)
+	double frequency;
+	double uncertainty;
+	double effectivePeriod;
+
 public:
 #ifdef CONSTRAIN_INT_OP
 	// XXX: You can find the definition at lib/Build_DDDG/HardwareProfileParams.cpp
@@ -64,16 +69,22 @@ public:
 #endif
 	};
 
-	HardwareProfile();
+	HardwareProfile(double frequency, double uncertainty);
 	virtual ~HardwareProfile() { }
 	static HardwareProfile *createInstance();
+	static HardwareProfile *createInstance(double frequency, double uncertainty);
+	virtual HardwareProfile *clone() const = 0;
 	virtual void clear();
 
+	double getFrequency() { return frequency; }
+	double getUncertainty() { return uncertainty; }
+	double getEffectivePeriod() { return effectivePeriod; }
+
 	virtual unsigned getLatency(unsigned opcode) = 0;
 	virtual double getInCycleLatency(unsigned opcode) = 0;
 	virtual bool isPipelined(unsigned opcode) = 0;
 	virtual void calculateRequiredResources(
-		std::vector<int> &microops,
+		std::vector<uint8_t> &microops,
 		const ConfigurationManager::arrayInfoCfgMapTy &arrayInfoCfgMap,
 		std::unordered_map<int, std::pair<std::string, int64_t>> &baseAddress,
 		std::map<uint64_t, std::set<unsigned>> &maxTimesNodesMap
@@ -217,7 +228,7 @@ protected:
 	unsigned memLogicFF, memLogicLUT;
 
 public:
-	XilinxHardwareProfile();
+	XilinxHardwareProfile(double frequency, double uncertainty);
 
 	void clear();
 
@@ -226,7 +237,7 @@ public:
 	bool isPipelined(unsigned opcode);
 	bool canBeLiveOp(unsigned opcode);
 	void calculateRequiredResources(
-		std::vector<int> &microops,
+		std::vector<uint8_t> &microops,
 		const ConfigurationManager::arrayInfoCfgMapTy &arrayInfoCfgMap,
 		std::unordered_map<int, std::pair<std::string, int64_t>> &baseAddress,
 		std::map<uint64_t, std::set<unsigned>> &maxTimesNodesMap
@@ -273,6 +284,8 @@ class XilinxVC707HardwareProfile : public XilinxHardwareProfile {
 	};
 
 public:
+	XilinxVC707HardwareProfile(double frequency, double uncertainty) : XilinxHardwareProfile(frequency, uncertainty) { }
+	HardwareProfile *clone() const { return new XilinxVC707HardwareProfile(*this); }
 	void setResourceLimits();
 };
 
@@ -285,6 +298,8 @@ class XilinxZC702HardwareProfile : public XilinxHardwareProfile {
 	};
 
 public:
+	XilinxZC702HardwareProfile(double frequency, double uncertainty) : XilinxHardwareProfile(frequency, uncertainty) { }
+	HardwareProfile *clone() const { return new XilinxZC702HardwareProfile(*this); }
 	void setResourceLimits();
 };
 
@@ -296,11 +311,10 @@ class XilinxZCUHardwareProfile : public XilinxHardwareProfile {
 	static const std::unordered_map<unsigned, std::map<unsigned, unsigned>> timeConstrainedFFs;
 	static const std::unordered_map<unsigned, std::map<unsigned, unsigned>> timeConstrainedLUTs;
 
-	double effectivePeriod;
 	std::unordered_map<unsigned, std::pair<unsigned, double>> effectiveLatencies;
 
 public:
-	XilinxZCUHardwareProfile();
+	XilinxZCUHardwareProfile(double frequency, double uncertainty);
 	unsigned getLatency(unsigned opcode);
 	double getInCycleLatency(unsigned opcode);
 };
@@ -315,7 +329,8 @@ class XilinxZCU102HardwareProfile : public XilinxZCUHardwareProfile {
 	};
 
 public:
-	XilinxZCU102HardwareProfile() { }
+	XilinxZCU102HardwareProfile(double frequency, double uncertainty) : XilinxZCUHardwareProfile(frequency, uncertainty) { }
+	HardwareProfile *clone() const { return new XilinxZCU102HardwareProfile(*this); }
 	void setResourceLimits();
 };
 
@@ -329,7 +344,8 @@ class XilinxZCU104HardwareProfile : public XilinxZCUHardwareProfile {
 	};
 
 public:
-	XilinxZCU104HardwareProfile() { }
+	XilinxZCU104HardwareProfile(double frequency, double uncertainty) : XilinxZCUHardwareProfile(frequency, uncertainty) { }
+	HardwareProfile *clone() const { return new XilinxZCU104HardwareProfile(*this); }
 	void setResourceLimits();
 };
 
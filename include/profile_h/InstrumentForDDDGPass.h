@@ -5,6 +5,8 @@
 #include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <stdlib.h>
 #include <string>
@@ -30,9 +32,12 @@
 
 #include "profile_h/BaseDatapath.h"
 #include "profile_h/DDDGBuilder.h"
+#include "profile_h/DesignSpace.h"
 #include "profile_h/DynamicDatapath.h"
+#include "profile_h/Extrapolator.h"
 #include "profile_h/Multipath.h"
 #include "profile_h/Passes.h"
+#include "profile_h/ResultCache.h"
 #include "profile_h/SlotTracker.h"
 #include "profile_h/TraceFunctions.h"
 #include "profile_h/auxiliary.h"
@@ -83,11 +88,53 @@ class InstrumentForDDDG : public ModulePass {
 #endif
 	};
 
+	struct loopTargetTy {
+		std::string wholeLoopName;
+		int loopLevel;
+		unsigned targetUnrollFactor;
+		unsigned unrollFactor;
+		unsigned loopBound;
+		bool enablePipelining;
+	};
+	// Design points that share the same loop configuration (i.e. same DDDGs)
+	struct designGroupTy {
+		std::string loopsCode;
+		std::string loopsCfg;
+		// Pairs of frequency and its design point code prefix
+		std::vector<std::pair<double, std::string>> frequencies;
+		// Pairs of design point code suffix and its array/partition configuration
+		std::vector<std::pair<std::string, std::string>> partitionings;
+	};
+
+	// Kernel analysed by loopBasedTraceAnalysis(), with its own configuration, summary and trace segment
+	struct kernelAnalysisTy {
+		std::string kernelName;
+		std::unique_ptr<ConfigurationManager> CM;
+		std::vector<std::string> pipelineLoopLevelVec;
+		std::string summaryFileName;
+		std::ofstream summaryFile;
+		// Progressive trace cursor at the beginning of this kernel in the trace
+		long int traceCursor;
+		uint64_t traceInstCount;
+#ifdef RESULT_CACHE
+		bool useResultCache = false;
+		ResultCache resultCache;
+#endif
+	};
+
 	std::vector<std::string> pipelineLoopLevelVec;
+	std::string summaryFileName;
 	std::ofstream summaryFile;
 
 	void extractMemoryTraceForAccessPattern();
 	int shouldTrace(std::string call);
+	bool isTargetLoop(std::string loopName);
+	loopTargetTy getLoopTarget(std::string loopName, std::vector<unsigned> &levelUnrollVec, std::vector<std::string> &pipelineLoopLevelVec);
+#ifdef PROGRESSIVE_TRACE_CURSOR
+	void indexTraceSegments(std::vector<std::unique_ptr<kernelAnalysisTy>> &kernels);
+#endif
+	void analyseKernel(kernelAnalysisTy &kernel);
+	void exploreDesignGroup(std::string kernelName, designGroupTy &group, double uncertainty, std::ofstream &exploreFile);
 
 #ifdef DBG_PRINT_ALL
 	void printDatabase(void);
@@ -109,10 +156,12 @@ public:
 
 	void updateUnrollingDatabase(const std::vector<ConfigurationManager::unrollingCfgTy> &unrollingCfg);
 
+	void performEstimation();
 	void loopBasedTraceAnalysis();
+	void designSpaceExploration();
 
-	void openSummaryFile(std::string kernelName);
-	void closeSummaryFile();
+	void openSummaryFile(std::string kernelName, std::string &summaryFileName, std::ofstream &summaryFile);
+	void closeSummaryFile(std::ofstream &summaryFile);
 };
 
 // Embedded Profiler Engine
@@ -20,6 +20,8 @@ class Multipath {
 
 	std::vector<std::tuple<unsigned, unsigned, uint64_t, uint64_t>> latencies;
 	Pack P;
+	// Arrays accessed by any of the datapaths
+	std::set<std::string> referencedArrays;
 
 	void _Multipath();
 
@@ -42,6 +44,8 @@ public:
 	~Multipath();
 
 	uint64_t getCycles() const;
+	Pack &getPack();
+	const std::set<std::string> &getReferencedArrays() const;
 
 #ifdef DBG_PRINT_ALL
 	void printDatabase();
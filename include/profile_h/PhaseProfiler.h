@@ -0,0 +1,90 @@
+#ifndef PHASEPROFILER_H
+#define PHASEPROFILER_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "profile_h/auxiliary.h"
+
+#ifdef ENABLE_TIMER
+#define FILE_PHASES_SUFFIX "_phases.json"
+
+/**
+ * Records wall time, CPU time and peak resident set size of the execution phases of Lina (bitcode load, passes,
+ * traced execution, DDDG construction, optimisations, scheduling, etc.), per loop and per datapath type. Phases are
+ * timed with PHASE_SCOPE() (the phase ends when the scope ends) and may carry counters (e.g. number of nodes).
+ * Repeated executions of the same phase for the same loop and datapath type are accumulated.
+ *
+ * CPU time is the time of the calling thread, thus work offloaded to helper threads (see
+ * BaseDatapath::runInParallel()) is not accounted for. The peak RSS is the peak of the whole process observed at
+ * the end of the phase.
+ *
+ * Results are written as JSON to <kernel>_phases.json when --phase-profile is set.
+ */
+class PhaseProfiler {
+	struct phaseTy {
+		std::string phase;
+		std::string loopName;
+		unsigned loopLevel;
+		int datapathType;
+		uint64_t calls;
+		double wallMs;
+		double cpuMs;
+		long peakRSSKB;
+		std::vector<std::pair<std::string, uint64_t>> counters;
+	};
+
+	std::mutex mutex;
+	std::chrono::steady_clock::time_point start;
+	// Phases are kept in order of first execution
+	std::vector<phaseTy> phases;
+	std::map<std::tuple<std::string, std::string, unsigned, int>, size_t> phaseIndex;
+
+	static std::string escape(std::string str);
+
+public:
+	class Scope {
+		bool active;
+		std::string phase;
+		std::string loopName;
+		unsigned loopLevel;
+		int datapathType;
+		std::chrono::steady_clock::time_point wallStart;
+		double cpuStart;
+		std::vector<std::pair<std::string, uint64_t>> counters;
+
+	public:
+		Scope(std::string phase, std::string loopName = "", unsigned loopLevel = 0, int datapathType = -1);
+		~Scope();
+
+		void addCounter(std::string name, uint64_t value);
+	};
+
+	PhaseProfiler();
+
+	static double getThreadCPUTimeMs();
+	static double getProcessCPUTimeMs();
+	static long getPeakRSSKB();
+
+	void record(
+		std::string phase, std::string loopName, unsigned loopLevel, int datapathType,
+		double wallMs, double cpuMs, const std::vector<std::pair<std::string, uint64_t>> &counters
+	);
+	void dump(std::string kernelName);
+};
+
+extern PhaseProfiler phaseProfiler;
+
+#define PHASE_SCOPE(VAR, ...) PhaseProfiler::Scope VAR(__VA_ARGS__)
+#define PHASE_COUNTER(VAR, NAME, VALUE) VAR.addCounter(NAME, VALUE)
+#else
+#define PHASE_SCOPE(VAR, ...)
+#define PHASE_COUNTER(VAR, NAME, VALUE)
+#endif
+
+#endif // End of PHASEPROFILER_H
@@ -0,0 +1,83 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <fstream>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "profile_h/AppendLog.h"
+#include "profile_h/auxiliary.h"
+
+using namespace llvm;
+
+#ifdef RESULT_CACHE
+#define FILE_RESULT_CACHE "resultcache.db"
+#define FILE_RESULT_CACHE_MAGIC_STRING "!RC"
+// Increment this value whenever the estimation changes in a way that invalidates previously cached results
+#define RESULT_CACHE_VERSION 1
+
+/**
+ * The result cache saves the summary and cycle count of each estimated loop, keyed by a hash of the inputs that
+ * effectively affect the estimation: resolved unroll factors, pipelining, platform, effective clock periods,
+ * analysis flags and the partitioning of the arrays that are accessed by the loop. Design points that differ only
+ * in these "ineffective" parameters (e.g. unroll factors clamped to the loop bound or partitioning of arrays not
+ * touched by the loop) are estimated only once.
+ *
+ * Since the arrays accessed by a loop are only known after its DDDG is built, lookup is performed in two steps:
+ * the base key (everything but the partitioning) maps to the set of arrays accessed, which is then used to
+ * construct the full key of the result.
+ *
+ * As the future cache, the file is an append-only log (see AppendLog) shared by all Lina executions using the same
+ * working directory.
+ */
+class ResultCache {
+public:
+	struct resultTy {
+		// One value per clock target
+		std::vector<uint64_t> cycles;
+		std::string summary;
+		// Progressive trace cursor before and after the estimation
+		long int cursorBefore;
+		uint64_t instCountBefore;
+		long int cursorAfter;
+		uint64_t instCountAfter;
+	};
+
+private:
+	// Pairs of canonical key and serialised value, indexed by the hash of the canonical key
+	std::unordered_map<std::string, std::pair<std::string, std::string>> cache;
+	unsigned cacheMiss;
+	unsigned cacheHit;
+	AppendLog cacheLog;
+
+	static std::string hashKey(const std::string &canonicalKey);
+	bool consumeEntry(const std::string &payload);
+	bool findEntry(const std::string &canonicalKey, std::string &value);
+	void insertEntry(const std::string &canonicalKey, const std::string &value);
+
+public:
+	ResultCache() : cacheMiss(0), cacheHit(0) { };
+	~ResultCache();
+	void dumpSummary(std::ofstream *summaryFile);
+
+	bool load();
+	void save();
+
+	std::string constructBaseKey(
+		std::string kernelName, std::string wholeLoopName, unsigned loopLevel,
+		const std::vector<unsigned> &levelUnrollVec, uint64_t unrollFactor, bool enablePipelining
+	);
+	std::string constructFullKey(std::string baseKey, const std::set<std::string> &referencedArrays, const ConfigurationManager &CM);
+	std::string rewriteSummary(const std::string &summary, const std::set<std::string> &referencedArrays, const ConfigurationManager &CM);
+
+	bool findReferencedArrays(std::string baseKey, std::set<std::string> &referencedArrays);
+	bool find(std::string fullKey, resultTy &result);
+	void insert(std::string baseKey, const std::set<std::string> &referencedArrays, std::string fullKey, const resultTy &result);
+	void clear() { cache.clear(); cacheMiss = 0; cacheHit = 0; }
+};
+#endif
+
+#endif // End of RESULTCACHE_H
@@ -0,0 +1,127 @@
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <fstream>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "profile_h/auxiliary.h"
+
+#define FILE_RESULTS_JSONL_SUFFIX "_results.jsonl"
+#define FILE_RESULTS_CSV_SUFFIX "_results.csv"
+#define FILE_RESULTS_BINARY_SUFFIX "_results.bin"
+
+#define RESULTS_BINARY_MAGIC "LINARES"
+#define RESULTS_BINARY_VERSION 1
+
+/**
+ * Structured output of the estimations, written alongside the text summary when --result-format is set. Each
+ * estimation (one per loop, datapath/multipath and clock target, see BaseDatapath::dumpSummary() and
+ * Multipath::dumpSummary()) generates one record with the same values that the summary presents, so that design
+ * space exploration scripts do not have to parse the summary file.
+ *
+ * Available formats:
+ * - jsonl: one JSON object per line, with all values, named Pack values (e.g. per-array partitioning) and the
+ *   merged resource lists/trees used to calculate DSPs, FFs and LUTs. Cache statistics are also written as records;
+ * - csv: fixed columns only (no named values, resources or cache statistics);
+ * - binary: same content as jsonl, length-prefixed and in native byte order. See misc/largedse/results.py.
+ *
+ * When a design space is explored (--explore), each record also carries the code of its design point.
+ */
+class ResultWriter {
+public:
+	enum {
+		RECORD_ESTIMATION = 0,
+		RECORD_CACHE = 1
+	};
+
+	// Pack value not covered by the fixed fields, already formatted as in the summary
+	typedef struct {
+		std::string name;
+		bool numeric;
+		std::string value;
+	} fieldTy;
+
+	// Merged resource list/tree (e.g. shared fadd units)
+	typedef struct {
+		std::string name;
+		uint64_t fus;
+		uint64_t dsps;
+		uint64_t ffs;
+		uint64_t luts;
+	} resourceTy;
+
+	struct recordTy {
+		std::string point;
+		std::string loopName;
+		unsigned loopLevel = 0;
+		// -1 for multipath (non-perfect loop nest)
+		int datapathType = -1;
+		double frequency = 0;
+		double uncertainty = 0;
+		double effectivePeriod = 0;
+		double achievedPeriod = 0;
+		uint64_t unrollFactor = 0;
+		bool pipelining = false;
+		uint64_t cycles = 0;
+		uint64_t asapIL = 0;
+		uint64_t rcIL = 0;
+		uint64_t II = 0;
+		uint64_t resIIMem = 0;
+		std::string resIIMemArray;
+		uint64_t resIIOp = 0;
+		std::string resIIOpUnit;
+		uint64_t recII = 0;
+		std::string limitedBy;
+		uint64_t sharedLoads = 0;
+		uint64_t repeatedStores = 0;
+		uint64_t dsps = 0;
+		uint64_t ffs = 0;
+		uint64_t luts = 0;
+		uint64_t bram18k = 0;
+		std::vector<fieldTy> fields;
+		std::vector<resourceTy> resources;
+	};
+
+private:
+	std::mutex mutex;
+	std::ofstream out;
+	// Design point code per clock frequency, used when a design space is explored
+	std::vector<std::pair<double, std::string>> points;
+
+	static std::string escape(std::string str);
+	static std::string quote(std::string str);
+	static std::string getDatapathTypeName(int datapathType);
+
+	void writeJSONL(const recordTy &record);
+	void writeCSV(const recordTy &record);
+	void writeBinary(const recordTy &record);
+
+	void writeBinaryU64(uint64_t value);
+	void writeBinaryDouble(double value);
+	void writeBinaryString(const std::string &value);
+
+public:
+	bool isActive() const;
+
+	void open(std::string kernelName);
+	void close();
+
+	void setDesignPoints(const std::vector<std::pair<double, std::string>> &points);
+	void clearDesignPoints();
+
+	// Whether a Pack value with this merge type and element type is written as a number. Sets (MERGE_SET) are
+	// written as strings, with their elements separated by ", "
+	static bool isNumeric(unsigned mergeType, unsigned type);
+	// Add the merged resource lists/trees in P (i.e. the "_shared" and "_unshared" values) to the record
+	static void addResources(recordTy &record, llvm::Pack &P);
+
+	void write(recordTy record);
+	void writeCacheStats(std::string cacheName, uint64_t cacheMiss, uint64_t cacheHit);
+};
+
+extern ResultWriter resultWriter;
+
+#endif // End of RESULTWRITER_H
@@ -0,0 +1,34 @@
+#ifndef STATICDATABASE_H
+#define STATICDATABASE_H
+
+#include <fstream>
+#include <stdint.h>
+#include <string>
+
+#include "profile_h/BaseDatapath.h"
+#include "profile_h/DDDGBuilder.h"
+#include "profile_h/auxiliary.h"
+
+#define FILE_STATIC_DATABASE "staticdatabase.db"
+#define FILE_STATIC_DATABASE_MAGIC_STRING "!SD"
+// Increment this value whenever the layout of the static database file changes
+#define STATIC_DATABASE_VERSION 1
+
+/**
+ * The static database holds the global maps populated by the IR passes (function name mapper, loop number,
+ * basic block ID, load/store ID, loop info extraction and trace instrumentation) that are used by the
+ * estimation. It is saved next to the dynamic trace, so that estimation-only executions can load it instead
+ * of parsing the bitcode and running all passes again.
+ *
+ * The database is bound to the kernel name and to the size and modification time of the bitcode file. If
+ * any of these does not match, load() fails and the passes must be executed as usual.
+ */
+class StaticDatabase {
+	static void clear();
+
+public:
+	static bool load();
+	static void save();
+};
+
+#endif // End of STATICDATABASE_H
@@ -0,0 +1,104 @@
+#ifndef SYNTHETIC_DATAPATH_H
+#define SYNTHETIC_DATAPATH_H
+
+#include <ostream>
+#include <random>
+#include <string>
+#include "profile_h/BaseDatapath.h"
+
+using namespace llvm;
+
+/**
+ * Datapath whose DDDG is generated synthetically instead of being built from a dynamic trace. Used by
+ * lina-microbench to time the DDDG optimisations and schedulers in isolation, with graphs of controlled shape
+ * and size. Every node has the same trace information that DDDGBuilder would generate (function, instruction ID,
+ * basic blocks, result size, memory address and getelementptr base), so that the stages run unmodified.
+ *
+ * Available shapes:
+ * - chain: a single dependency chain of arithmetic operations, optionally consuming loads and feeding stores;
+ * - reduction: a sequential accumulation of products (i.e. a dot product), the input of tree height reduction;
+ * - stencil: 5-point stencil over a square mesh, where neighbouring points share most of their loads;
+ * - random: random DAG where each operation consumes values generated within a sliding window.
+ *
+ * Memory operations access the arrays arr0, arr1, ... (see writeConfiguration()) through getelementptr nodes.
+ */
+class SyntheticDatapath : public BaseDatapath {
+public:
+	enum {
+		SHAPE_CHAIN,
+		SHAPE_REDUCTION,
+		SHAPE_STENCIL,
+		SHAPE_RANDOM,
+		SHAPE_COUNT
+	};
+
+	enum {
+		STAGE_REMOVE_SHARED_LOADS,
+		STAGE_REMOVE_REPEATED_STORES,
+		STAGE_TREE_HEIGHT_REDUCTION,
+		STAGE_ASAP,
+		STAGE_ALAP,
+		// Resource-constrained scheduling, without timing constraints (i.e. --fno-tcs)
+		STAGE_RC_SCHEDULING,
+		// Resource-constrained scheduling, with timing constraints (i.e. RCScheduler driving TCScheduler)
+		STAGE_TC_SCHEDULING,
+		STAGE_COUNT
+	};
+
+	typedef struct {
+		unsigned shape;
+		// Approximate number of nodes to be generated
+		unsigned numOfNodes;
+		// Ratio of memory operations among the generated values (chain and random only)
+		double memRatio;
+		// Ratio of stores among the memory operations (chain and random only)
+		double storeRatio;
+		unsigned numOfArrays;
+		// Number of 32-bit words of each array
+		uint64_t arraySize;
+		// Cyclic partitioning factor applied to all arrays (1 for no partitioning)
+		uint64_t partitionFactor;
+		// Maximum distance (in generated values) between an operation and its operands (random only)
+		unsigned window;
+		bool floatingPoint;
+		unsigned seed;
+	} shapeCfgTy;
+
+private:
+	ConfigurationManager &CM;
+	shapeCfgTy cfg;
+	// All nodes belong to the first call of the kernel
+	std::string staticFunction;
+	std::string dynamicFunction;
+	std::mt19937 rng;
+	std::tuple<uint64_t, uint64_t> asapResult;
+
+	unsigned insertNode(int microop);
+	unsigned insertLoad(unsigned array, uint64_t index);
+	unsigned insertStore(unsigned value, unsigned array, uint64_t index);
+	unsigned insertOp(bool multiply, unsigned op1, unsigned op2);
+	unsigned insertOp(bool multiply, unsigned op1);
+
+	double uniform();
+	unsigned pickArray();
+
+	void generateChain();
+	void generateReduction();
+	void generateStencil();
+	void generateRandom();
+
+public:
+	SyntheticDatapath(std::string kernelName, ConfigurationManager &CM, std::string loopName, const shapeCfgTy &cfg);
+
+	static std::string getArrayName(unsigned array);
+	static std::string getShapeName(unsigned shape);
+	static std::string getStageName(unsigned stage);
+	static void writeConfiguration(const shapeCfgTy &cfg, std::ostream &configFile);
+
+	// Perform everything that the stage depends on (e.g. latencies as edge weights, ASAP/ALAP)
+	void prepareStage(unsigned stage);
+	// Run the stage alone. Returns a stage-dependent value (e.g. removed nodes or cycle count) for sanity checks
+	uint64_t runStage(unsigned stage);
+};
+
+#endif // End of SYNTHETIC_DATAPATH_H
@@ -0,0 +1,33 @@
+#ifndef THREADBUDGET_H
+#define THREADBUDGET_H
+
+#include <functional>
+#include <mutex>
+
+/**
+ * Process-wide limit on the number of helper threads. Concurrency is nested (kernels, then clock targets of a sweep,
+ * then chunks of each DDDG level), thus spawning threads unconditionally at each level would create
+ * kernels * targets * cores threads at once. Each level instead requests slots from this budget, which is sized to
+ * std::thread::hardware_concurrency() (the main thread included), and runs the remaining work inline.
+ *
+ * Slots are never waited for: a request is granted as many slots as are free, possibly none. This avoids deadlocks
+ * between nested levels, since a thread holding slots never blocks waiting for more.
+ */
+class ThreadBudget {
+	std::mutex mutex;
+	unsigned freeSlots;
+
+	ThreadBudget();
+
+	unsigned acquire(unsigned wanted);
+	void release(unsigned slots);
+
+public:
+	static ThreadBudget &getInstance();
+
+	// Run task(i) for i in [0, numOfTasks). Tasks are pulled by the calling thread and by as many helper threads as
+	// the budget allows (up to maxHelpers, none if the budget is exhausted). Returns when all tasks are finished
+	void run(unsigned numOfTasks, unsigned maxHelpers, std::function<void(unsigned)> task);
+};
+
+#endif // End of THREADBUDGET_H
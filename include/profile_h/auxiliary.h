@@ -38,6 +38,11 @@ extern std::ofstream debugFile;
 // You can see it working in DDDGBuilder.cpp
 #define FUTURE_CACHE
 
+// Design space explorations contain many design points whose effective configuration is the same for a given loop
+// (e.g. unroll factors clamped to the loop bound, partitioning of arrays not accessed by the loop). The result cache
+// saves the estimation of each loop so that such points are not estimated again. See ResultCache.h
+#define RESULT_CACHE
+
 // If enabled, sanity checks are performed in the multipath vector
 //#define CHECK_MULTIPATH_STATE
 
@@ -67,6 +72,7 @@ extern std::ofstream debugFile;
 #define FILE_DYNAMIC_TRACE "dynamic_trace.gz"
 #define FILE_MEM_TRACE "mem_trace.txt"
 #define FILE_SUMMARY_SUFFIX "_summary.log"
+#define FILE_EXPLORE_SUFFIX "_explore.csv"
 
 // XXX: For now, I'm using the old separators as defined in the original lin-analyzer to simplify correctness comparison and also portability
 #define LEGACY_SEPARATOR
@@ -76,8 +82,9 @@ extern std::ofstream debugFile;
 
 extern ArgPack args;
 #ifdef PROGRESSIVE_TRACE_CURSOR
-extern long int progressiveTraceCursor;
-extern uint64_t progressiveTraceInstCount;
+// Each kernel is analysed by its own thread with its own trace cursor (see InstrumentForDDDG::loopBasedTraceAnalysis())
+extern thread_local long int progressiveTraceCursor;
+extern thread_local uint64_t progressiveTraceInstCount;
 #endif
 
 extern const std::string functionNameMapperMDKindName;
@@ -96,6 +103,8 @@ std::string mangleFunctionName(std::string functionName);
 std::string demangleFunctionName(std::string mangledName);
 std::string mangleArrayName(std::string arrayName);
 std::string demangleArrayName(std::string mangledName);
+// Size and modification time of a file, used to bind cached data to the files it was computed from
+bool getFileStamp(std::string fileName, uint64_t &size, uint64_t &modTime);
 
 unsigned nextPowerOf2(unsigned x);
 uint64_t nextPowerOf2(uint64_t x);
@@ -211,6 +220,7 @@ public:
 
 	void clear();
 	void parseAndPopulate(std::vector<std::string> &pipelineLoopLevelVec);
+	void parseAndPopulate(std::vector<std::string> &pipelineLoopLevelVec, std::istream &configFile);
 	void parseToFiles();
 
 	std::string getCfgKernel() { return kernelName; }
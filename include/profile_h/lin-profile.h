@@ -19,6 +19,9 @@
 #include "profile_h/FunctionNameMapperPass.h"
 #include "profile_h/InstrumentForDDDGPass.h"
 #include "profile_h/LoopNumberPass.h"
+#include "profile_h/PhaseProfiler.h"
+#include "profile_h/ResultCache.h"
+#include "profile_h/StaticDatabase.h"
 #include "profile_h/auxiliary.h"
 
 static llvm::cl::opt<std::string>
@@ -0,0 +1,566 @@
+#include "profile_h/DesignSpace.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "llvm/Support/raw_ostream.h"
+
+// The design space file is user input: errors are reported and execution stops, as with invalid command line options
+static void fail(std::string message) {
+	llvm::errs() << "Invalid design space file: " << message << "\n";
+	exit(-1);
+}
+
+static const JSONValue &expect(const JSONValue &value, unsigned type, std::string what) {
+	if(type != value.type) {
+		std::string typeNames[] = {"null", "boolean", "number", "string", "array", "object"};
+		fail("\"" + what + "\" must be " + ((JSONValue::JSON_ARRAY == type || JSONValue::JSON_OBJECT == type)? "an " : "a ") + typeNames[type]);
+	}
+
+	return value;
+}
+
+void JSONValue::skipWhitespace(std::istream &in) {
+	while(std::isspace(in.peek()))
+		in.get();
+}
+
+void JSONValue::parseValue(std::istream &in) {
+	skipWhitespace(in);
+
+	int c = in.peek();
+	if('{' == c) {
+		type = JSON_OBJECT;
+		in.get();
+
+		skipWhitespace(in);
+		if('}' == in.peek()) {
+			in.get();
+			return;
+		}
+
+		while(true) {
+			std::string key;
+			skipWhitespace(in);
+			parseString(in, key);
+
+			skipWhitespace(in);
+			int separator = in.get();
+			if(separator != ':')
+				fail("expected \":\" after object key \"" + key + "\"");
+
+			objectValue.push_back(std::make_pair(key, JSONValue()));
+			objectValue.back().second.parseValue(in);
+
+			skipWhitespace(in);
+			separator = in.get();
+			if('}' == separator)
+				break;
+			if(separator != ',')
+				fail("expected \",\" or \"}\" after object member \"" + key + "\"");
+		}
+	}
+	else if('[' == c) {
+		type = JSON_ARRAY;
+		in.get();
+
+		skipWhitespace(in);
+		if(']' == in.peek()) {
+			in.get();
+			return;
+		}
+
+		while(true) {
+			arrayValue.push_back(JSONValue());
+			arrayValue.back().parseValue(in);
+
+			skipWhitespace(in);
+			int separator = in.get();
+			if(']' == separator)
+				break;
+			if(separator != ',')
+				fail("expected \",\" or \"]\" after array element");
+		}
+	}
+	else if('"' == c) {
+		type = JSON_STRING;
+		parseString(in, stringValue);
+	}
+	else if('t' == c) {
+		type = JSON_BOOL;
+		parseLiteral(in, "true");
+		boolValue = true;
+	}
+	else if('f' == c) {
+		type = JSON_BOOL;
+		parseLiteral(in, "false");
+		boolValue = false;
+	}
+	else if('n' == c) {
+		type = JSON_NULL;
+		parseLiteral(in, "null");
+	}
+	else {
+		type = JSON_NUMBER;
+		parseNumber(in);
+	}
+}
+
+void JSONValue::parseString(std::istream &in, std::string &str) {
+	int c = in.get();
+	if(c != '"')
+		fail("expected string");
+
+	str.clear();
+	while(true) {
+		c = in.get();
+		if(EOF == c)
+			fail("unterminated string");
+
+		if('"' == c)
+			break;
+
+		if('\\' == c) {
+			c = in.get();
+			switch(c) {
+				case 'b':
+					str.push_back('\b');
+					break;
+				case 'f':
+					str.push_back('\f');
+					break;
+				case 'n':
+					str.push_back('\n');
+					break;
+				case 'r':
+					str.push_back('\r');
+					break;
+				case 't':
+					str.push_back('\t');
+					break;
+				case 'u': {
+					char hex[5] = {0, 0, 0, 0, 0};
+					in.read(hex, 4);
+					if(in.gcount() != 4 || !std::isxdigit(hex[0]) || !std::isxdigit(hex[1]) || !std::isxdigit(hex[2]) || !std::isxdigit(hex[3]))
+						fail("invalid \\u escape in string");
+					unsigned codePoint = std::strtoul(hex, nullptr, 16);
+
+					// Only the basic multilingual plane is supported, encoded as UTF-8
+					if(codePoint < 0x80) {
+						str.push_back(codePoint);
+					}
+					else if(codePoint < 0x800) {
+						str.push_back(0xC0 | (codePoint >> 6));
+						str.push_back(0x80 | (codePoint & 0x3F));
+					}
+					else {
+						str.push_back(0xE0 | (codePoint >> 12));
+						str.push_back(0x80 | ((codePoint >> 6) & 0x3F));
+						str.push_back(0x80 | (codePoint & 0x3F));
+					}
+					break;
+				}
+				default:
+					if(EOF == c)
+						fail("unterminated string");
+					str.push_back(c);
+					break;
+			}
+		}
+		else {
+			str.push_back(c);
+		}
+	}
+}
+
+void JSONValue::parseNumber(std::istream &in) {
+	stringValue.clear();
+	while(std::isdigit(in.peek()) || '-' == in.peek() || '+' == in.peek() || '.' == in.peek() || 'e' == in.peek() || 'E' == in.peek())
+		stringValue.push_back(in.get());
+
+	if(!(stringValue.size())) {
+		int c = in.peek();
+		fail((EOF == c)? std::string("unexpected end of file") : "unexpected character \"" + std::string(1, (char) c) + "\"");
+	}
+
+	char *end;
+	numberValue = std::strtod(stringValue.c_str(), &end);
+	if(*end != '\0')
+		fail("invalid number \"" + stringValue + "\"");
+}
+
+void JSONValue::parseLiteral(std::istream &in, std::string literal) {
+	for(auto &it : literal) {
+		int c = in.get();
+		if(c != it)
+			fail("invalid literal, expected \"" + literal + "\"");
+	}
+}
+
+JSONValue JSONValue::parse(std::istream &in) {
+	JSONValue value;
+
+	value.parseValue(in);
+	skipWhitespace(in);
+	if(in.peek() != EOF)
+		fail("trailing characters found");
+
+	return value;
+}
+
+bool JSONValue::has(std::string key) const {
+	for(auto &it : objectValue) {
+		if(key == it.first)
+			return true;
+	}
+
+	return false;
+}
+
+const JSONValue &JSONValue::at(std::string key) const {
+	for(auto &it : objectValue) {
+		if(key == it.first)
+			return it.second;
+	}
+
+	fail("\"" + key + "\" not found");
+	return *this;
+}
+
+bool JSONValue::isEmpty() const {
+	return (JSON_OBJECT == type && !objectValue.size()) || (JSON_ARRAY == type && !arrayValue.size());
+}
+
+static unsigned findUnsigned(const std::vector<JSONValue> &values, uint64_t value) {
+	for(unsigned i = 0; i < values.size(); i++) {
+		if(value == (uint64_t) values[i].numberValue)
+			return i;
+	}
+
+	fail("value " + std::to_string(value) + " not found");
+	return 0;
+}
+
+DesignSpace::DesignSpace(std::string fileName, std::string kernelName) : kernelName(kernelName) {
+	std::ifstream designFile;
+
+	designFile.open(fileName);
+	if(!(designFile.is_open())) {
+		llvm::errs() << "Error opening design space file: " << fileName << "\n";
+		exit(-1);
+	}
+	root = JSONValue::parse(designFile);
+	designFile.close();
+
+	// The whole description is validated here, so that the design points can be enumerated without further checks
+	expect(root, JSONValue::JSON_OBJECT, "root");
+	if(root.has("platform"))
+		expect(root.at("platform"), JSONValue::JSON_STRING, "platform");
+
+	if(root.has("periods"))
+		freqPerKey = "periods";
+	else if(root.has("frequencies"))
+		freqPerKey = "frequencies";
+	else
+		fail("at least \"periods\" or \"frequencies\" must be supplied");
+	if(!(expect(root.at(freqPerKey), JSONValue::JSON_ARRAY, freqPerKey).arrayValue.size()))
+		fail("no " + freqPerKey + " supplied");
+	for(auto &it : root.at(freqPerKey).arrayValue) {
+		if(expect(it, JSONValue::JSON_NUMBER, freqPerKey).numberValue <= 0)
+			fail("\"" + freqPerKey + "\" must be positive");
+	}
+	freqPerIdx = 0;
+
+	const std::vector<JSONValue> &loops = expect(root.at("loops"), JSONValue::JSON_ARRAY, "loops").arrayValue;
+	for(unsigned i = 0; i < loops.size(); i++) {
+		unsigned depth = 1;
+		const JSONValue *nest = &(loops[i]);
+		do {
+			expect(*nest, JSONValue::JSON_OBJECT, "loops");
+			if(JSONValue::JSON_NUMBER != nest->at("line").type)
+				expect(nest->at("line"), JSONValue::JSON_STRING, "line");
+			expect(nest->at("bound"), JSONValue::JSON_NUMBER, "bound");
+			expect(nest->at("pipelining"), JSONValue::JSON_BOOL, "pipelining");
+			for(auto &it : expect(nest->at("unrolling"), JSONValue::JSON_ARRAY, "unrolling").arrayValue)
+				expect(it, JSONValue::JSON_NUMBER, "unrolling");
+
+			loopsCfg.push_back({i, depth, 0, false});
+
+			depth++;
+			nest = &(expect(nest->at("nest"), JSONValue::JSON_OBJECT, "nest"));
+		} while(!(nest->isEmpty()));
+	}
+
+	for(auto &it : expect(root.at("arrays"), JSONValue::JSON_OBJECT, "arrays").objectValue) {
+		expect(it.second, JSONValue::JSON_OBJECT, it.first);
+		expect(it.second.at("size"), JSONValue::JSON_NUMBER, "size");
+		expect(it.second.at("words"), JSONValue::JSON_NUMBER, "words");
+		expect(it.second.at("complete"), JSONValue::JSON_BOOL, "complete");
+		for(auto &it2 : expect(it.second.at("block"), JSONValue::JSON_ARRAY, "block").arrayValue)
+			expect(it2, JSONValue::JSON_NUMBER, "block");
+		for(auto &it2 : expect(it.second.at("cyclic"), JSONValue::JSON_ARRAY, "cyclic").arrayValue)
+			expect(it2, JSONValue::JSON_NUMBER, "cyclic");
+		if(it.second.has("forcescope"))
+			expect(it.second.at("forcescope"), JSONValue::JSON_STRING, "forcescope");
+
+		arraysCfg.push_back({it.first, arrayCfgTy::PARTITION_NONE, 0});
+	}
+
+	if(root.has("inarrays")) {
+		for(auto &it : expect(root.at("inarrays"), JSONValue::JSON_OBJECT, "inarrays").objectValue) {
+			expect(it.second, JSONValue::JSON_OBJECT, it.first);
+			expect(it.second.at("size"), JSONValue::JSON_NUMBER, "size");
+			expect(it.second.at("words"), JSONValue::JSON_NUMBER, "words");
+			if(it.second.has("readonly"))
+				expect(it.second.at("readonly"), JSONValue::JSON_BOOL, "readonly");
+		}
+	}
+
+	started = false;
+}
+
+const JSONValue &DesignSpace::getLoopDescription(const loopCfgTy &loop) const {
+	const JSONValue *description = &(root.at("loops").arrayValue.at(loop.id));
+	for(unsigned i = 1; i < loop.depth; i++)
+		description = &(description->at("nest"));
+
+	return *description;
+}
+
+// Design points are enumerated like an odometer: unrolling factors change first, then pipelining flags, partitionings and finally periods
+void DesignSpace::nextDesignPoint() {
+	// Alternate unrolling factors
+	for(auto &it : loopsCfg) {
+		const std::vector<JSONValue> &unrollings = getLoopDescription(it).at("unrolling").arrayValue;
+
+		if(!(it.unrolling)) {
+			if(unrollings.size()) {
+				it.unrolling = unrollings[0].numberValue;
+				return;
+			}
+		}
+		else {
+			unsigned currIdx = findUnsigned(unrollings, it.unrolling);
+
+			if(unrollings.size() == currIdx + 1) {
+				it.unrolling = 0;
+			}
+			else {
+				it.unrolling = unrollings[currIdx + 1].numberValue;
+				return;
+			}
+		}
+	}
+
+	// Alternate pipelining flags
+	for(auto &it : loopsCfg) {
+		if(!(it.pipelining)) {
+			if(getLoopDescription(it).at("pipelining").boolValue) {
+				it.pipelining = true;
+				return;
+			}
+		}
+		else {
+			it.pipelining = false;
+		}
+	}
+
+	// Alternate partitionings
+	for(auto &it : arraysCfg) {
+		const JSONValue &description = root.at("arrays").at(it.name);
+		const std::vector<JSONValue> &blocks = description.at("block").arrayValue;
+		const std::vector<JSONValue> &cyclics = description.at("cyclic").arrayValue;
+		bool complete = description.at("complete").boolValue;
+		unsigned currIdx;
+
+		switch(it.type) {
+			case arrayCfgTy::PARTITION_NONE:
+				if(blocks.size()) {
+					it.type = arrayCfgTy::PARTITION_BLOCK;
+					it.factor = blocks[0].numberValue;
+					return;
+				}
+				else if(cyclics.size()) {
+					it.type = arrayCfgTy::PARTITION_CYCLIC;
+					it.factor = cyclics[0].numberValue;
+					return;
+				}
+				else if(complete) {
+					it.type = arrayCfgTy::PARTITION_COMPLETE;
+					it.factor = 0;
+					return;
+				}
+				break;
+			case arrayCfgTy::PARTITION_BLOCK:
+				currIdx = findUnsigned(blocks, it.factor);
+
+				if(blocks.size() != currIdx + 1) {
+					it.factor = blocks[currIdx + 1].numberValue;
+					return;
+				}
+				else if(cyclics.size()) {
+					it.type = arrayCfgTy::PARTITION_CYCLIC;
+					it.factor = cyclics[0].numberValue;
+					return;
+				}
+				else if(complete) {
+					it.type = arrayCfgTy::PARTITION_COMPLETE;
+					it.factor = 0;
+					return;
+				}
+
+				it.type = arrayCfgTy::PARTITION_NONE;
+				it.factor = 0;
+				break;
+			case arrayCfgTy::PARTITION_CYCLIC:
+				currIdx = findUnsigned(cyclics, it.factor);
+
+				if(cyclics.size() != currIdx + 1) {
+					it.factor = cyclics[currIdx + 1].numberValue;
+					return;
+				}
+				else if(complete) {
+					it.type = arrayCfgTy::PARTITION_COMPLETE;
+					it.factor = 0;
+					return;
+				}
+
+				it.type = arrayCfgTy::PARTITION_NONE;
+				it.factor = 0;
+				break;
+			case arrayCfgTy::PARTITION_COMPLETE:
+				it.type = arrayCfgTy::PARTITION_NONE;
+				it.factor = 0;
+				break;
+		}
+	}
+
+	// Alternate periods/frequencies
+	if(root.at(freqPerKey).arrayValue.size() == freqPerIdx + 1)
+		freqPerIdx = 0;
+	else
+		freqPerIdx++;
+}
+
+bool DesignSpace::generateDesignPoint() {
+	if(started) {
+		nextDesignPoint();
+		return startCode != getCode();
+	}
+
+	startCode = getCode();
+	started = true;
+	return true;
+}
+
+// Pipelining a fully unrolled loop or a loop that has pipelined/unrolled nested loops makes no sense, such points are skipped
+bool DesignSpace::bypass() const {
+	for(auto &it : loopsCfg) {
+		if(!(it.pipelining))
+			continue;
+
+		if(it.unrolling && it.unrolling == (uint64_t) getLoopDescription(it).at("bound").numberValue)
+			return true;
+
+		for(auto &it2 : loopsCfg) {
+			if(it2.id == it.id && it2.depth > it.depth && (it2.pipelining || it2.unrolling))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+std::string DesignSpace::getPlatform() const {
+	return root.has("platform")? root.at("platform").stringValue : "";
+}
+
+double DesignSpace::getFrequency() const {
+	double value = root.at(freqPerKey).arrayValue.at(freqPerIdx).numberValue;
+	return ("periods" == freqPerKey)? 1000.0 / value : value;
+}
+
+// Codes are the same as the ones generated by misc/largedse/run.py, so that results can be compared directly
+std::string DesignSpace::getCode() const {
+	std::string code = ("periods" == freqPerKey)? "p" : "f";
+	return code + root.at(freqPerKey).arrayValue.at(freqPerIdx).stringValue + getLoopsCode() + getArraysCode();
+}
+
+std::string DesignSpace::getLoopsCode() const {
+	std::stringstream code;
+
+	for(auto &it : loopsCfg)
+		code << "_l" << it.id << "." << it.depth << "." << (it.pipelining? 1 : 0) << "." << it.unrolling;
+
+	return code.str();
+}
+
+std::string DesignSpace::getArraysCode() const {
+	std::stringstream code;
+
+	for(auto &it : arraysCfg) {
+		code << "_a" << it.name << ".";
+		switch(it.type) {
+			case arrayCfgTy::PARTITION_BLOCK:
+				code << "block";
+				break;
+			case arrayCfgTy::PARTITION_CYCLIC:
+				code << "cyclic";
+				break;
+			case arrayCfgTy::PARTITION_COMPLETE:
+				code << "complete";
+				break;
+			default:
+				code << "none";
+				break;
+		}
+		code << "." << it.factor;
+	}
+
+	return code.str();
+}
+
+void DesignSpace::writeLoopsConfiguration(std::ostream &out) const {
+	for(auto &it : loopsCfg) {
+		if(it.pipelining)
+			out << "pipeline," << kernelName << "," << it.id << "," << it.depth << "\n";
+		if(it.unrolling)
+			out << "unrolling," << kernelName << "," << it.id << "," << it.depth << "," << getLoopDescription(it).at("line").stringValue << "," << it.unrolling << "\n";
+	}
+}
+
+// Arrays that are not partitioned by the design space are still written, since array information is mandatory
+void DesignSpace::writeArraysConfiguration(std::ostream &out) const {
+	const JSONValue &arrays = root.at("arrays");
+
+	for(auto &it : arrays.objectValue) {
+		uint64_t wordSize = it.second.at("size").numberValue;
+		uint64_t totalSize = ((uint64_t) it.second.at("words").numberValue) * wordSize;
+		std::string scope = it.second.has("forcescope")? it.second.at("forcescope").stringValue : "arg";
+		out << "array," << it.first << "," << totalSize << "," << wordSize << "," << scope << "\n";
+	}
+
+	if(root.has("inarrays")) {
+		for(auto &it : root.at("inarrays").objectValue) {
+			uint64_t wordSize = it.second.at("size").numberValue;
+			uint64_t totalSize = ((uint64_t) it.second.at("words").numberValue) * wordSize;
+			bool readOnly = it.second.has("readonly") && it.second.at("readonly").boolValue;
+			out << "array," << it.first << "," << totalSize << "," << wordSize << "," << (readOnly? "rovar" : "rwvar") << "\n";
+		}
+	}
+
+	for(auto &it : arraysCfg) {
+		const JSONValue &description = arrays.at(it.name);
+		uint64_t wordSize = description.at("size").numberValue;
+		uint64_t totalSize = ((uint64_t) description.at("words").numberValue) * wordSize;
+
+		if(arrayCfgTy::PARTITION_COMPLETE == it.type)
+			out << "partition,complete," << it.name << "," << totalSize << "\n";
+		else if(arrayCfgTy::PARTITION_BLOCK == it.type)
+			out << "partition,block," << it.name << "," << totalSize << "," << wordSize << "," << it.factor << "\n";
+		else if(arrayCfgTy::PARTITION_CYCLIC == it.type)
+			out << "partition,cyclic," << it.name << "," << totalSize << "," << wordSize << "," << it.factor << "\n";
+	}
+}
@@ -0,0 +1,197 @@
+#include "profile_h/PhaseProfiler.h"
+
+#ifdef ENABLE_TIMER
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+#include <time.h>
+
+using namespace llvm;
+
+PhaseProfiler phaseProfiler;
+
+PhaseProfiler::Scope::Scope(std::string phase, std::string loopName, unsigned loopLevel, int datapathType) :
+	active(args.phaseProfile), phase(phase), loopName(loopName), loopLevel(loopLevel), datapathType(datapathType)
+{
+	if(!active)
+		return;
+
+	wallStart = std::chrono::steady_clock::now();
+	cpuStart = getThreadCPUTimeMs();
+}
+
+PhaseProfiler::Scope::~Scope() {
+	if(!active)
+		return;
+
+	double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+	double cpuMs = getThreadCPUTimeMs() - cpuStart;
+
+	phaseProfiler.record(phase, loopName, loopLevel, datapathType, wallMs, cpuMs, counters);
+}
+
+void PhaseProfiler::Scope::addCounter(std::string name, uint64_t value) {
+	if(active)
+		counters.push_back(std::make_pair(name, value));
+}
+
+PhaseProfiler::PhaseProfiler() : start(std::chrono::steady_clock::now()) { }
+
+double PhaseProfiler::getThreadCPUTimeMs() {
+	struct timespec ts;
+
+	if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+		return 0;
+
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+double PhaseProfiler::getProcessCPUTimeMs() {
+	struct timespec ts;
+
+	if(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts))
+		return 0;
+
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+long PhaseProfiler::getPeakRSSKB() {
+	struct rusage usage;
+
+	if(getrusage(RUSAGE_SELF, &usage))
+		return 0;
+
+	// On Linux, ru_maxrss is in kilobytes
+	return usage.ru_maxrss;
+}
+
+std::string PhaseProfiler::escape(std::string str) {
+	std::stringstream escaped;
+
+	for(auto &it : str) {
+		if('"' == it || '\\' == it)
+			escaped << '\\' << it;
+		else if((unsigned char) it < 0x20)
+			escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (unsigned) it << std::dec;
+		else
+			escaped << it;
+	}
+
+	return escaped.str();
+}
+
+void PhaseProfiler::record(
+	std::string phase, std::string loopName, unsigned loopLevel, int datapathType,
+	double wallMs, double cpuMs, const std::vector<std::pair<std::string, uint64_t>> &counters
+) {
+	long peakRSSKB = getPeakRSSKB();
+	std::tuple<std::string, std::string, unsigned, int> key = std::make_tuple(phase, loopName, loopLevel, datapathType);
+
+	// Phases of clock sweeps are recorded by several threads
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::map<std::tuple<std::string, std::string, unsigned, int>, size_t>::iterator found = phaseIndex.find(key);
+	if(phaseIndex.end() == found) {
+		phaseTy newPhase;
+		newPhase.phase = phase;
+		newPhase.loopName = loopName;
+		newPhase.loopLevel = loopLevel;
+		newPhase.datapathType = datapathType;
+		newPhase.calls = 0;
+		newPhase.wallMs = 0;
+		newPhase.cpuMs = 0;
+		newPhase.peakRSSKB = 0;
+
+		found = phaseIndex.insert(std::make_pair(key, phases.size())).first;
+		phases.push_back(newPhase);
+	}
+
+	phaseTy &entry = phases[found->second];
+	entry.calls++;
+	entry.wallMs += wallMs;
+	entry.cpuMs += cpuMs;
+	if(peakRSSKB > entry.peakRSSKB)
+		entry.peakRSSKB = peakRSSKB;
+
+	// Counters are accumulated by name
+	for(auto &it : counters) {
+		bool merged = false;
+
+		for(auto &it2 : entry.counters) {
+			if(it2.first == it.first) {
+				it2.second += it.second;
+				merged = true;
+				break;
+			}
+		}
+
+		if(!merged)
+			entry.counters.push_back(it);
+	}
+}
+
+void PhaseProfiler::dump(std::string kernelName) {
+	if(!(args.phaseProfile))
+		return;
+
+	std::ofstream out(args.outWorkDir + kernelName + FILE_PHASES_SUFFIX);
+	if(!(out.is_open())) {
+		errs() << "Could not open phase profile output file\n";
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	out << std::fixed << std::setprecision(3);
+	out << "{\n";
+	out << "\t\"kernel\": \"" << escape(kernelName) << "\",\n";
+	out << "\t\"total\": {\"wallMs\": " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() <<
+		", \"cpuMs\": " << getProcessCPUTimeMs() << ", \"peakRSSKB\": " << getPeakRSSKB() << "},\n";
+	out << "\t\"phases\": [";
+
+	for(unsigned i = 0; i < phases.size(); i++) {
+		phaseTy &phase = phases[i];
+
+		out << (i? ",\n" : "\n") << "\t\t{\"phase\": \"" << escape(phase.phase) << "\"";
+
+		// Phases not related to a specific loop (e.g. passes) have no loop information
+		if(phase.loopName.size())
+			out << ", \"loop\": \"" << escape(phase.loopName) << "\", \"loopLevel\": " << phase.loopLevel;
+
+		if(phase.datapathType >= 0) {
+			out << ", \"datapathType\": \"";
+			switch(phase.datapathType) {
+				case DatapathType::NORMAL_LOOP:
+					out << "normal";
+					break;
+				case DatapathType::PERFECT_LOOP:
+					out << "perfect";
+					break;
+				case DatapathType::NON_PERFECT_BEFORE:
+					out << "before";
+					break;
+				case DatapathType::NON_PERFECT_BETWEEN:
+					out << "between";
+					break;
+				case DatapathType::NON_PERFECT_AFTER:
+					out << "after";
+					break;
+			}
+			out << "\"";
+		}
+
+		out << ", \"calls\": " << phase.calls << ", \"wallMs\": " << phase.wallMs << ", \"cpuMs\": " << phase.cpuMs << ", \"peakRSSKB\": " << phase.peakRSSKB;
+
+		out << ", \"counters\": {";
+		for(unsigned j = 0; j < phase.counters.size(); j++)
+			out << (j? ", " : "") << "\"" << escape(phase.counters[j].first) << "\": " << phase.counters[j].second;
+		out << "}}";
+	}
+
+	out << "\n\t]\n";
+	out << "}\n";
+
+	out.close();
+}
+#endif
@@ -0,0 +1,300 @@
+#include "profile_h/ResultWriter.h"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using namespace llvm;
+
+ResultWriter resultWriter;
+
+std::string ResultWriter::escape(std::string str) {
+	std::stringstream escaped;
+
+	for(auto &it : str) {
+		if('"' == it || '\\' == it)
+			escaped << '\\' << it;
+		else if((unsigned char) it < 0x20)
+			escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (unsigned) it << std::dec;
+		else
+			escaped << it;
+	}
+
+	return escaped.str();
+}
+
+// CSV string fields are always quoted, with embedded quotes doubled
+std::string ResultWriter::quote(std::string str) {
+	std::string quoted("\"");
+
+	for(auto &it : str) {
+		if('"' == it)
+			quoted += '"';
+		quoted += it;
+	}
+
+	return quoted + "\"";
+}
+
+std::string ResultWriter::getDatapathTypeName(int datapathType) {
+	switch(datapathType) {
+		case DatapathType::NORMAL_LOOP:
+			return "normal";
+		case DatapathType::PERFECT_LOOP:
+			return "perfect";
+		case DatapathType::NON_PERFECT_BEFORE:
+			return "before";
+		case DatapathType::NON_PERFECT_BETWEEN:
+			return "between";
+		case DatapathType::NON_PERFECT_AFTER:
+			return "after";
+		default:
+			return "multipath";
+	}
+}
+
+bool ResultWriter::isActive() const {
+	return args.resultFormat != ArgPack::RESULT_FORMAT_NONE;
+}
+
+void ResultWriter::open(std::string kernelName) {
+	if(!isActive())
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if(out.is_open())
+		out.close();
+
+	switch(args.resultFormat) {
+		case ArgPack::RESULT_FORMAT_JSONL:
+			out.open(args.outWorkDir + kernelName + FILE_RESULTS_JSONL_SUFFIX);
+			break;
+		case ArgPack::RESULT_FORMAT_CSV:
+			out.open(args.outWorkDir + kernelName + FILE_RESULTS_CSV_SUFFIX);
+			break;
+		case ArgPack::RESULT_FORMAT_BINARY:
+			out.open(args.outWorkDir + kernelName + FILE_RESULTS_BINARY_SUFFIX, std::ios::binary);
+			break;
+	}
+
+	assert(out.is_open() && "Could not open result output file");
+
+	if(ArgPack::RESULT_FORMAT_CSV == args.resultFormat) {
+		out << "point,loop,level,type,frequency,uncertainty,effectivePeriod,achievedPeriod,unroll,pipelining,"
+			"cycles,asapIL,rcIL,ii,resIIMem,resIIMemArray,resIIOp,resIIOpUnit,recII,limitedBy,sharedLoads,repeatedStores,"
+			"dsps,ffs,luts,bram18k\n";
+	}
+	else if(ArgPack::RESULT_FORMAT_BINARY == args.resultFormat) {
+		uint32_t version = RESULTS_BINARY_VERSION;
+		out.write(RESULTS_BINARY_MAGIC, sizeof(RESULTS_BINARY_MAGIC) - 1);
+		out.write((const char *) &version, sizeof(version));
+	}
+}
+
+void ResultWriter::close() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if(out.is_open())
+		out.close();
+	points.clear();
+}
+
+void ResultWriter::setDesignPoints(const std::vector<std::pair<double, std::string>> &points) {
+	std::lock_guard<std::mutex> lock(mutex);
+	this->points = points;
+}
+
+void ResultWriter::clearDesignPoints() {
+	std::lock_guard<std::mutex> lock(mutex);
+	points.clear();
+}
+
+bool ResultWriter::isNumeric(unsigned mergeType, unsigned type) {
+	if(Pack::TYPE_STRING == type)
+		return false;
+
+	switch(mergeType) {
+		case Pack::MERGE_MAX:
+		case Pack::MERGE_MIN:
+		case Pack::MERGE_SUM:
+		case Pack::MERGE_MULSUM:
+		case Pack::MERGE_EQUAL:
+			return true;
+		default:
+			return false;
+	}
+}
+
+void ResultWriter::addResources(recordTy &record, Pack &P) {
+	for(auto &it : P.getStructure()) {
+		std::string name = std::get<0>(it);
+
+		if(Pack::TYPE_RESOURCENET != std::get<2>(it))
+			continue;
+
+		// Same packing as in BaseDatapath::dumpSummary(): FUs, DSPs, FFs and LUTs with 10 characters each
+		std::string value = P.mergeElements<Pack::resourceNodeTy>(name);
+		resourceTy resource;
+		resource.name = ('_' == name[0])? name.substr(1) : name;
+		resource.fus = stol(value.substr(0, 10));
+		resource.dsps = stol(value.substr(10, 10));
+		resource.ffs = stol(value.substr(20, 10));
+		resource.luts = stol(value.substr(30, 10));
+		record.resources.push_back(resource);
+	}
+}
+
+void ResultWriter::write(recordTy record) {
+	if(!isActive())
+		return;
+
+	// Records of clock sweeps may be written by several threads
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for(auto &it : points) {
+		if(std::fabs(it.first - record.frequency) < 1e-6) {
+			record.point = it.second;
+			break;
+		}
+	}
+
+	switch(args.resultFormat) {
+		case ArgPack::RESULT_FORMAT_JSONL:
+			writeJSONL(record);
+			break;
+		case ArgPack::RESULT_FORMAT_CSV:
+			writeCSV(record);
+			break;
+		case ArgPack::RESULT_FORMAT_BINARY:
+			writeBinary(record);
+			break;
+	}
+}
+
+void ResultWriter::writeCacheStats(std::string cacheName, uint64_t cacheMiss, uint64_t cacheHit) {
+	if(!isActive())
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// CSV files only have estimation records
+	if(ArgPack::RESULT_FORMAT_JSONL == args.resultFormat) {
+		out << "{\"record\": \"cache\", \"cache\": \"" << escape(cacheName) << "\", \"miss\": " << cacheMiss << ", \"hit\": " << cacheHit << "}\n";
+	}
+	else if(ArgPack::RESULT_FORMAT_BINARY == args.resultFormat) {
+		out.put(RECORD_CACHE);
+		writeBinaryString(cacheName);
+		writeBinaryU64(cacheMiss);
+		writeBinaryU64(cacheHit);
+	}
+}
+
+void ResultWriter::writeJSONL(const recordTy &record) {
+	out << std::fixed << std::setprecision(6);
+	out << "{\"record\": \"estimation\"";
+	if(record.point.size())
+		out << ", \"point\": \"" << escape(record.point) << "\"";
+	out << ", \"loop\": \"" << escape(record.loopName) << "\", \"level\": " << record.loopLevel;
+	out << ", \"type\": \"" << getDatapathTypeName(record.datapathType) << "\"";
+	out << ", \"frequency\": " << record.frequency << ", \"uncertainty\": " << record.uncertainty;
+	out << ", \"effectivePeriod\": " << record.effectivePeriod << ", \"achievedPeriod\": " << record.achievedPeriod;
+	out << ", \"unroll\": " << record.unrollFactor << ", \"pipelining\": " << (record.pipelining? "true" : "false");
+	out << ", \"cycles\": " << record.cycles << ", \"asapIL\": " << record.asapIL << ", \"rcIL\": " << record.rcIL;
+	out << ", \"ii\": " << record.II;
+	out << ", \"resIIMem\": " << record.resIIMem << ", \"resIIMemArray\": \"" << escape(record.resIIMemArray) << "\"";
+	out << ", \"resIIOp\": " << record.resIIOp << ", \"resIIOpUnit\": \"" << escape(record.resIIOpUnit) << "\"";
+	out << ", \"recII\": " << record.recII << ", \"limitedBy\": \"" << escape(record.limitedBy) << "\"";
+	out << ", \"sharedLoads\": " << record.sharedLoads << ", \"repeatedStores\": " << record.repeatedStores;
+	out << ", \"dsps\": " << record.dsps << ", \"ffs\": " << record.ffs << ", \"luts\": " << record.luts << ", \"bram18k\": " << record.bram18k;
+
+	out << ", \"values\": {";
+	for(unsigned i = 0; i < record.fields.size(); i++) {
+		const fieldTy &field = record.fields[i];
+		out << (i? ", " : "") << "\"" << escape(field.name) << "\": ";
+		if(field.numeric)
+			out << field.value;
+		else
+			out << "\"" << escape(field.value) << "\"";
+	}
+	out << "}";
+
+	out << ", \"resources\": [";
+	for(unsigned i = 0; i < record.resources.size(); i++) {
+		const resourceTy &resource = record.resources[i];
+		out << (i? ", " : "") << "{\"name\": \"" << escape(resource.name) << "\", \"fus\": " << resource.fus <<
+			", \"dsps\": " << resource.dsps << ", \"ffs\": " << resource.ffs << ", \"luts\": " << resource.luts << "}";
+	}
+	out << "]}\n";
+}
+
+void ResultWriter::writeCSV(const recordTy &record) {
+	out << std::fixed << std::setprecision(6);
+	out << quote(record.point) << "," << quote(record.loopName) << "," << record.loopLevel << "," << quote(getDatapathTypeName(record.datapathType)) << ",";
+	out << record.frequency << "," << record.uncertainty << "," << record.effectivePeriod << "," << record.achievedPeriod << ",";
+	out << record.unrollFactor << "," << (record.pipelining? 1 : 0) << ",";
+	out << record.cycles << "," << record.asapIL << "," << record.rcIL << "," << record.II << ",";
+	out << record.resIIMem << "," << quote(record.resIIMemArray) << "," << record.resIIOp << "," << quote(record.resIIOpUnit) << ",";
+	out << record.recII << "," << quote(record.limitedBy) << "," << record.sharedLoads << "," << record.repeatedStores << ",";
+	out << record.dsps << "," << record.ffs << "," << record.luts << "," << record.bram18k << "\n";
+}
+
+void ResultWriter::writeBinary(const recordTy &record) {
+	out.put(RECORD_ESTIMATION);
+	writeBinaryString(record.point);
+	writeBinaryString(record.loopName);
+	writeBinaryU64(record.loopLevel);
+	writeBinaryString(getDatapathTypeName(record.datapathType));
+	writeBinaryDouble(record.frequency);
+	writeBinaryDouble(record.uncertainty);
+	writeBinaryDouble(record.effectivePeriod);
+	writeBinaryDouble(record.achievedPeriod);
+	writeBinaryU64(record.unrollFactor);
+	writeBinaryU64(record.pipelining? 1 : 0);
+	writeBinaryU64(record.cycles);
+	writeBinaryU64(record.asapIL);
+	writeBinaryU64(record.rcIL);
+	writeBinaryU64(record.II);
+	writeBinaryU64(record.resIIMem);
+	writeBinaryString(record.resIIMemArray);
+	writeBinaryU64(record.resIIOp);
+	writeBinaryString(record.resIIOpUnit);
+	writeBinaryU64(record.recII);
+	writeBinaryString(record.limitedBy);
+	writeBinaryU64(record.sharedLoads);
+	writeBinaryU64(record.repeatedStores);
+	writeBinaryU64(record.dsps);
+	writeBinaryU64(record.ffs);
+	writeBinaryU64(record.luts);
+	writeBinaryU64(record.bram18k);
+
+	writeBinaryU64(record.fields.size());
+	for(auto &it : record.fields) {
+		writeBinaryString(it.name);
+		out.put(it.numeric? 1 : 0);
+		writeBinaryString(it.value);
+	}
+
+	writeBinaryU64(record.resources.size());
+	for(auto &it : record.resources) {
+		writeBinaryString(it.name);
+		writeBinaryU64(it.fus);
+		writeBinaryU64(it.dsps);
+		writeBinaryU64(it.ffs);
+		writeBinaryU64(it.luts);
+	}
+}
+
+void ResultWriter::writeBinaryU64(uint64_t value) {
+	out.write((const char *) &value, sizeof(value));
+}
+
+void ResultWriter::writeBinaryDouble(double value) {
+	out.write((const char *) &value, sizeof(value));
+}
+
+void ResultWriter::writeBinaryString(const std::string &value) {
+	uint32_t size = value.size();
+	out.write((const char *) &size, sizeof(size));
+	out.write(value.data(), size);
+}
@@ -2,6 +2,8 @@
 
 #include "llvm/IR/Verifier.h"
 
+#include <sys/stat.h>
+
 using namespace llvm;
 
 #ifdef DBG_FILE
@@ -113,6 +115,18 @@ std::string demangleArrayName(std::string mangledName) {
 	return (mangledName2ArrayNameMap.end() == arrayFound)? mangledName : arrayFound->second;
 }
 
+bool getFileStamp(std::string fileName, uint64_t &size, uint64_t &modTime) {
+	struct stat fileStat;
+
+	if(stat(fileName.c_str(), &fileStat))
+		return false;
+
+	size = fileStat.st_size;
+	modTime = fileStat.st_mtime;
+
+	return true;
+}
+
 unsigned nextPowerOf2(unsigned x) {
 	x--;
 	x |= (x >> 1);
@@ -226,10 +240,24 @@ void ConfigurationManager::clear() {
 
 void ConfigurationManager::parseAndPopulate(std::vector<std::string> &pipelineLoopLevelVec) {
 	std::ifstream configFile;
+	std::string configFileName = args.configFileName;
 
-	configFile.open(args.configFileName);
+	// Each kernel may have its own configuration file
+	if(args.kernelConfigFileNames.size() > 1) {
+		std::vector<std::string>::iterator found = std::find(args.kernelNames.begin(), args.kernelNames.end(), demangleFunctionName(kernelName));
+		assert(found != args.kernelNames.end() && "Kernel of configuration manager is not among the kernels being analysed");
+		configFileName = args.kernelConfigFileNames.at(found - args.kernelNames.begin());
+	}
+
+	configFile.open(configFileName);
 	assert(configFile.is_open() && "Error opening configuration file");
 
+	parseAndPopulate(pipelineLoopLevelVec, configFile);
+
+	configFile.close();
+}
+
+void ConfigurationManager::parseAndPopulate(std::vector<std::string> &pipelineLoopLevelVec, std::istream &configFile) {
 	std::string line;
 	std::vector<std::string> pipeliningCfgStr;
 	std::vector<std::string> unrollingCfgStr;
@@ -278,8 +306,6 @@ void ConfigurationManager::parseAndPopulate(std::vector<std::string> &pipelineLo
 		}
 	}
 
-	configFile.close();
-
 	std::map<std::string, uint64_t> wholeLoopName2CompUnrollFactorMap;
 
 	if(pipeliningCfgStr.size()) {
@@ -875,7 +901,7 @@ template<> std::string Pack::mergeElements<std::string>(std::string name) {
 					firstElem = false;
 				}
 				else {
-					aggrString += it;
+					aggrString += ", " + it;
 				}
 			}
 
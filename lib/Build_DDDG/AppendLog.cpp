@@ -0,0 +1,155 @@
+#include "profile_h/AppendLog.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+uint32_t AppendLog::checksum(const char *data, size_t size) {
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+
+	for(size_t i = 0; i < size; i++) {
+		hash ^= (uint8_t) data[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+// Reads all entries appended to the log after logOffset. Returns false if the log could not be read. If a torn
+// or corrupt entry is found, "torn" is set and logOffset points to the end of the last valid entry
+bool AppendLog::readLog(consumerTy consumer, bool &torn) {
+	torn = false;
+
+	struct stat logStat;
+	if(fstat(logFD, &logStat))
+		return false;
+
+	// The log never shrinks below what was consumed, unless it was modified externally
+	uint64_t logSize = logStat.st_size;
+	if(logSize <= logOffset)
+		return logSize == logOffset;
+
+	std::string buffer(logSize - logOffset, '\0');
+	if(pread(logFD, &buffer[0], buffer.size(), logOffset) != (ssize_t) buffer.size())
+		return false;
+
+	size_t pos = 0;
+	while(pos < buffer.size()) {
+		size_t entryPos = pos;
+		uint32_t payloadSize;
+		if(!extractElement(buffer, entryPos, payloadSize) || entryPos + payloadSize + sizeof(uint32_t) > buffer.size())
+			break;
+
+		uint32_t storedChecksum;
+		size_t checksumPos = entryPos + payloadSize;
+		extractElement(buffer, checksumPos, storedChecksum);
+		if(storedChecksum != checksum(&buffer[entryPos], payloadSize))
+			break;
+
+		if(!consumer(buffer.substr(entryPos, payloadSize)))
+			break;
+
+		// checksumPos now points to the end of this entry
+		logOffset += checksumPos - pos;
+		pos = checksumPos;
+	}
+
+	torn = pos < buffer.size();
+
+	return true;
+}
+
+bool AppendLog::open(std::string fileName, std::string magicString, consumerTy consumer) {
+	close();
+
+	logFD = ::open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+	if(-1 == logFD)
+		return false;
+
+	// Without the lock, another execution could be restarting or appending to the log
+	if(flock(logFD, LOCK_EX)) {
+		close();
+		return false;
+	}
+
+	bool found = true;
+
+	/* Check for magic bits. If not found, restart the log */
+	std::string magicBits(magicString.size(), '\0');
+	if(pread(logFD, &magicBits[0], magicBits.size(), 0) != (ssize_t) magicBits.size() || magicString != magicBits) {
+		found = false;
+
+		if(ftruncate(logFD, 0) || pwrite(logFD, magicString.c_str(), magicString.size(), 0) != (ssize_t) magicString.size()) {
+			close();
+			return false;
+		}
+	}
+
+	bool torn;
+	logOffset = magicString.size();
+	readLog(consumer, torn);
+
+	flock(logFD, LOCK_UN);
+
+	return found;
+}
+
+// Closing the descriptor also releases any lock held on it
+void AppendLog::close() {
+	if(logFD != -1) {
+		::close(logFD);
+		logFD = -1;
+	}
+
+	logOffset = 0;
+}
+
+bool AppendLog::catchUp(consumerTy consumer) {
+	if(-1 == logFD || flock(logFD, LOCK_SH))
+		return false;
+
+	bool torn;
+	bool success = readLog(consumer, torn);
+
+	flock(logFD, LOCK_UN);
+
+	return success;
+}
+
+bool AppendLog::append(consumerTy consumer, std::function<bool(std::string &)> producer) {
+	std::string payload;
+
+	// If the log is not open or could not be locked, the entry is kept only in memory
+	if(-1 == logFD || flock(logFD, LOCK_EX)) {
+		producer(payload);
+		return false;
+	}
+
+	// Catch up with the log first. A torn entry at its end is removed before appending
+	bool torn;
+	bool appendable = readLog(consumer, torn);
+	if(appendable && torn)
+		appendable = !ftruncate(logFD, logOffset);
+
+	bool written = false;
+
+	// If the log could not be read or repaired, the entry is kept only in memory as well
+	if(producer(payload) && appendable) {
+		std::string entry;
+		uint32_t payloadSize = payload.size();
+		appendElement(entry, payloadSize);
+		entry.append(payload);
+		uint32_t entryChecksum = checksum(payload.c_str(), payload.size());
+		appendElement(entry, entryChecksum);
+
+		written = pwrite(logFD, entry.c_str(), entry.size(), logOffset) == (ssize_t) entry.size();
+		if(written)
+			logOffset += entry.size();
+	}
+
+	flock(logFD, LOCK_UN);
+
+	return written;
+}
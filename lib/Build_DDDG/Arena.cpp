@@ -0,0 +1,65 @@
+#include "profile_h/Arena.h"
+
+#include <cstdlib>
+#include <new>
+
+Arena::Arena() {
+	curr = nullptr;
+	left = 0;
+	nextChunkSize = ARENA_INITIAL_CHUNK_SIZE;
+	bytesAllocated = 0;
+}
+
+Arena::~Arena() {
+	release();
+}
+
+void *Arena::allocate(size_t size, size_t alignment) {
+	size_t padding = (alignment - ((uintptr_t) curr % alignment)) % alignment;
+
+	if(!curr || padding + size > left) {
+		// Allocations larger than a chunk get a dedicated chunk, the current chunk is kept for the following ones
+		if(size + alignment > nextChunkSize) {
+			char *chunk = static_cast<char *>(std::malloc(size + alignment));
+			if(!chunk)
+				throw std::bad_alloc();
+			chunks.push_back(chunk);
+			bytesAllocated += size + alignment;
+
+			return chunk + (alignment - ((uintptr_t) chunk % alignment)) % alignment;
+		}
+
+		curr = static_cast<char *>(std::malloc(nextChunkSize));
+		if(!curr)
+			throw std::bad_alloc();
+		chunks.push_back(curr);
+		left = nextChunkSize;
+		bytesAllocated += nextChunkSize;
+
+		if(nextChunkSize < ARENA_MAX_CHUNK_SIZE)
+			nextChunkSize *= 2;
+
+		padding = (alignment - ((uintptr_t) curr % alignment)) % alignment;
+	}
+
+	void *result = curr + padding;
+	curr += padding + size;
+	left -= padding + size;
+
+	return result;
+}
+
+void Arena::release() {
+	for(auto &it : chunks)
+		std::free(it);
+
+	chunks.clear();
+	curr = nullptr;
+	left = 0;
+	nextChunkSize = ARENA_INITIAL_CHUNK_SIZE;
+	bytesAllocated = 0;
+}
+
+uint64_t Arena::getBytesAllocated() const {
+	return bytesAllocated;
+}
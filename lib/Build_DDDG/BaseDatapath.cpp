@@ -1,33 +1,17 @@
 #include "profile_h/BaseDatapath.h"
 
 #include <fstream>
+#include <memory>
 #include <sstream>
+#include <thread>
 
 #include "llvm/Support/GraphWriter.h"
 #include "profile_h/colors.h"
 #include "profile_h/opcodes.h"
+#include "profile_h/ThreadBudget.h"
 
-void BaseDatapath::findMinimumRankPair(std::pair<unsigned, unsigned> &pair, std::map<unsigned, unsigned> rankMap) {
-	unsigned minRank = numOfTotalNodes;
-
-	for(auto &it : rankMap) {
-		unsigned nodeRank = it.second;
-		if(nodeRank < minRank) {
-			pair.first = it.first;
-			minRank = nodeRank;
-		}
-	}
-
-	minRank = numOfTotalNodes;
-
-	for(auto &it : rankMap) {
-		unsigned nodeRank = it.second;
-		if(it.first != pair.first && nodeRank < minRank) {
-			pair.second = it.first;
-			minRank = nodeRank;
-		}
-	}
-}
+// Phases of a datapath are recorded per loop and datapath type
+#define DATAPATH_PHASE_SCOPE(VAR, NAME) PHASE_SCOPE(VAR, NAME, loopName, loopLevel, datapathType)
 
 BaseDatapath::BaseDatapath(
 	std::string kernelName, ConfigurationManager &CM, std::ofstream *summaryFile,
@@ -36,10 +20,11 @@ BaseDatapath::BaseDatapath(
 ) :
 	kernelName(kernelName), CM(CM), summaryFile(summaryFile),
 	loopName(loopName), loopLevel(loopLevel), loopUnrollFactor(loopUnrollFactor), datapathType(DatapathType::NORMAL_LOOP),
-	enablePipelining(enablePipelining), asapII(asapII), PC(kernelName)
+	enablePipelining(enablePipelining), asapII(asapII), ownPC(kernelName), PC(ownPC)
 {
 	builder = nullptr;
 	profile = nullptr;
+	unconstrainedProfile = nullptr;
 	microops.clear();
 
 	// Create hardware profile based on selected platform
@@ -47,14 +32,23 @@ BaseDatapath::BaseDatapath(
 
 	VERBOSE_PRINT(errs() << "\tBuild initial DDDG\n");
 
-	builder = new DDDGBuilder(this, PC);
-	builder->buildInitialDDDG();
-	delete builder;
-	builder = nullptr;
+	{
+		DATAPATH_PHASE_SCOPE(phase, "dddgBuild");
+
+		builder = new DDDGBuilder(this, PC);
+		builder->buildInitialDDDG();
+		PHASE_COUNTER(phase, "arenaBytes", builder->getArenaBytes());
+		delete builder;
+		builder = nullptr;
+
+		postDDDGBuild();
 
-	postDDDGBuild();
+		PHASE_COUNTER(phase, "nodes", getNumNodes());
+		PHASE_COUNTER(phase, "edges", getNumEdges());
+	}
 
 	numCycles = 0;
+	asapLatency = 0;
 	maxII = 0;
 	rcIL = 0;
 
@@ -69,6 +63,10 @@ BaseDatapath::BaseDatapath(
 
 	sharedLoadsRemoved = 0;
 	repeatedStoresRemoved = 0;
+
+	deferResults = false;
+
+	topologicalCacheValid = false;
 }
 
 // This constructor does not perform DDDG generation. It should be generated externally via
@@ -79,16 +77,18 @@ BaseDatapath::BaseDatapath(
 ) :
 	kernelName(kernelName), CM(CM), summaryFile(summaryFile),
 	loopName(loopName), loopLevel(loopLevel), loopUnrollFactor(loopUnrollFactor), datapathType(datapathType),
-	enablePipelining(false), asapII(0), PC(kernelName)
+	enablePipelining(false), asapII(0), ownPC(kernelName), PC(ownPC)
 {
 	builder = nullptr;
 	profile = nullptr;
+	unconstrainedProfile = nullptr;
 	microops.clear();
 
 	// Create hardware profile based on selected platform
 	profile = HardwareProfile::createInstance();
 
 	numCycles = 0;
+	asapLatency = 0;
 	rcIL = 0;
 
 	///FIXME: We set numOfPortsPerPartition to 1000, so that we do not have memory port limitations. 
@@ -102,6 +102,58 @@ BaseDatapath::BaseDatapath(
 
 	sharedLoadsRemoved = 0;
 	repeatedStoresRemoved = 0;
+
+	deferResults = false;
+
+	topologicalCacheValid = false;
+}
+
+// This constructor is used for clock sweeps. It copies the DDDG (and related context) from a datapath
+// that is already built and partially optimised, so that it can be scheduled with another clock target.
+// The trace container is shared with the source datapath, thus it must outlive this object
+BaseDatapath::BaseDatapath(
+	BaseDatapath &source, double frequency, double uncertainty, uint64_t asapII, std::ostream *summaryFile
+) :
+	kernelName(source.kernelName), CM(source.CM), summaryFile(summaryFile),
+	loopName(source.loopName), loopLevel(source.loopLevel), loopUnrollFactor(source.loopUnrollFactor), datapathType(source.datapathType),
+	enablePipelining(source.enablePipelining), asapII(asapII), ownPC(source.kernelName), PC(source.PC)
+{
+	builder = nullptr;
+	profile = nullptr;
+	unconstrainedProfile = nullptr;
+
+	// Create hardware profile based on selected platform and this clock target
+	profile = HardwareProfile::createInstance(frequency, uncertainty);
+
+	microops = source.microops;
+	graph = source.graph;
+	refreshDDDG();
+	functionNames = source.functionNames;
+	baseAddress = source.baseAddress;
+	arrayNames = source.arrayNames;
+	memoryNodes = source.memoryNodes;
+	memoryNodeArrays = source.memoryNodeArrays;
+	memoryNodeOffsets = source.memoryNodeOffsets;
+	noPartitionArrayName = source.noPartitionArrayName;
+	dynamicMemoryOps = source.dynamicMemoryOps;
+	loopCarriedEdges = source.loopCarriedEdges;
+
+	numCycles = 0;
+	asapLatency = 0;
+	maxII = 0;
+	rcIL = 0;
+
+	numOfPortsPerPartition = source.numOfPortsPerPartition;
+
+	// Reset resource counting in profile
+	profile->clear();
+
+	sharedLoadsRemoved = 0;
+	repeatedStoresRemoved = 0;
+
+	deferResults = true;
+
+	topologicalCacheValid = false;
 }
 
 BaseDatapath::~BaseDatapath() {
@@ -109,6 +161,8 @@ BaseDatapath::~BaseDatapath() {
 		delete builder;
 	if(profile)
 		delete profile;
+	if(unconstrainedProfile)
+		delete unconstrainedProfile;
 }
 
 std::string BaseDatapath::getTargetLoopName() const {
@@ -123,6 +177,10 @@ uint64_t BaseDatapath::getTargetLoopUnrollFactor() const {
 	return loopUnrollFactor;
 }
 
+unsigned BaseDatapath::getDatapathType() const {
+	return datapathType;
+}
+
 unsigned BaseDatapath::getNumNodes() const {
 	return boost::num_vertices(graph);
 }
@@ -143,19 +201,34 @@ Pack &BaseDatapath::getPack() {
 	return P;
 }
 
+const std::vector<uint64_t> &BaseDatapath::getSweepASAPII() const {
+	return sweepASAPII;
+}
+
+const std::vector<uint64_t> &BaseDatapath::getSweepCycles() const {
+	return sweepCycles;
+}
+
+const std::vector<Pack> &BaseDatapath::getSweepPacks() const {
+	return sweepPacks;
+}
+
+std::set<std::string> BaseDatapath::getReferencedArrays() const {
+	std::set<std::string> referencedArrays;
+
+	// Base addresses are replaced by partition names during resource-constrained scheduling
+	const std::unordered_map<int, std::pair<std::string, int64_t>> &addresses = unpartitionedBaseAddress.size()? unpartitionedBaseAddress : baseAddress;
+	for(auto &it : addresses)
+		referencedArrays.insert(it.second.first);
+
+	return referencedArrays;
+}
+
 void BaseDatapath::postDDDGBuild() {
 	refreshDDDG();
 
-	for(auto &it : PC.getFuncList()) {
-#ifdef LEGACY_SEPARATOR
-		size_t tagPos = it.find("-");
-#else
-		size_t tagPos = it.find(GLOBAL_SEPARATOR);
-#endif
-		std::string functionName = it.substr(0, tagPos);
-
-		functionNames.insert(functionName);
-	}
+	const std::vector<std::string> &functionNameList = PC.getFunctionNameList();
+	functionNames.insert(functionNameList.begin(), functionNameList.end());
 
 #ifdef BYTE_OPS
 	for(auto &it : PC.getResultSizeList()) {
@@ -181,19 +254,29 @@ void BaseDatapath::refreshDDDG() {
 	// that was read from getTraceLineFromTo()
 	numOfTotalNodes = getNumNodes();
 
+	nameToVertex.assign(boost::num_vertices(graph), 0);
 	BGL_FORALL_VERTICES(v, graph, Graph) nameToVertex[boost::get(boost::vertex_index, graph, v)] = v;
 	vertexToName = boost::get(boost::vertex_index, graph);
 
 	edgeToWeight = boost::get(boost::edge_weight, graph);
+
+	invalidateTopologicalCache();
 }
 
 void BaseDatapath::insertMicroop(int microop) {
+	assert(microop >= 0 && microop <= UINT8_MAX && "Microop does not fit in the microop list");
 	microops.push_back(microop);
 }
 
 void BaseDatapath::insertDDDGEdge(unsigned from, unsigned to, uint8_t paramID) {
-	if(from != to)
+	if(from != to) {
 		boost::add_edge(from, to, EdgeProperty(paramID), graph);
+		invalidateTopologicalCache();
+	}
+}
+
+void BaseDatapath::insertLoopCarriedEdge(unsigned from, unsigned to, unsigned distance) {
+	loopCarriedEdges.push_back({from, to, distance});
 }
 
 bool BaseDatapath::edgeExists(unsigned from, unsigned to) {
@@ -201,79 +284,292 @@ bool BaseDatapath::edgeExists(unsigned from, unsigned to) {
 }
 
 void BaseDatapath::updateRemoveDDDGEdges(std::set<Edge> &edgesToRemove) {
-	for(auto &it : edgesToRemove)
-		boost::remove_edge(it, graph);
+	edgeDeltaTy delta;
+	delta.edgesToRemove.assign(edgesToRemove.begin(), edgesToRemove.end());
+	applyEdgeDelta(delta);
 }
 
 void BaseDatapath::updateAddDDDGEdges(std::vector<edgeTy> &edgesToAdd) {
-	for(auto &it : edgesToAdd) {
-		if(it.from != it.to && !edgeExists(it.from, it.to))
-			boost::get(boost::edge_weight, graph)[boost::add_edge(it.from, it.to, graph).first] = it.paramID;
-	}
+	edgeDeltaTy delta;
+	delta.edgesToAdd = edgesToAdd;
+	applyEdgeDelta(delta);
 }
 
 void BaseDatapath::updateRemoveDDDGNodes(std::vector<unsigned> &nodesToRemove) {
-	for(auto &it : nodesToRemove)
+	edgeDeltaTy delta;
+	delta.nodesToRemove = nodesToRemove;
+	applyEdgeDelta(delta);
+}
+
+// Edges are removed, then added, then nodes are disconnected
+void BaseDatapath::applyEdgeDelta(edgeDeltaTy &delta) {
+	// The same edge may be marked more than once (e.g. by both of its nodes)
+	std::sort(delta.edgesToRemove.begin(), delta.edgesToRemove.end());
+	delta.edgesToRemove.erase(std::unique(delta.edgesToRemove.begin(), delta.edgesToRemove.end()), delta.edgesToRemove.end());
+	for(auto &it : delta.edgesToRemove)
+		boost::remove_edge(it, graph);
+
+	// Edges to add are sorted by source and merged with the current out-edges of each source, instead of looking up
+	// each edge individually. Edges that already exist, repeated edges (first one prevails) and self-loops are dropped
+	std::vector<edgeTy> &edgesToAdd = delta.edgesToAdd;
+	std::vector<unsigned> sortedEdges(edgesToAdd.size());
+	for(unsigned i = 0; i < sortedEdges.size(); i++)
+		sortedEdges[i] = i;
+	std::stable_sort(sortedEdges.begin(), sortedEdges.end(), [&edgesToAdd](unsigned a, unsigned b) {
+		return (edgesToAdd[a].from != edgesToAdd[b].from)? edgesToAdd[a].from < edgesToAdd[b].from : edgesToAdd[a].to < edgesToAdd[b].to;
+	});
+
+	std::vector<bool> addEdge(edgesToAdd.size(), false);
+	std::vector<unsigned> existingTargets;
+	for(unsigned i = 0; i < sortedEdges.size();) {
+		unsigned from = edgesToAdd[sortedEdges[i]].from;
+
+		existingTargets.clear();
+		OutEdgeIterator outEdgei, outEdgeEnd;
+		for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(nameToVertex[from], graph); outEdgei != outEdgeEnd; outEdgei++)
+			existingTargets.push_back(vertexToName[boost::target(*outEdgei, graph)]);
+		std::sort(existingTargets.begin(), existingTargets.end());
+
+		std::vector<unsigned>::iterator existing = existingTargets.begin();
+		unsigned first = i;
+		for(; i < sortedEdges.size() && from == edgesToAdd[sortedEdges[i]].from; i++) {
+			unsigned to = edgesToAdd[sortedEdges[i]].to;
+
+			if(from == to || (i != first && to == edgesToAdd[sortedEdges[i - 1]].to))
+				continue;
+
+			while(existing != existingTargets.end() && *existing < to)
+				existing++;
+			if(existing != existingTargets.end() && to == *existing)
+				continue;
+
+			addEdge[sortedEdges[i]] = true;
+		}
+	}
+
+	// Edges are inserted in their original order, so that the out/in-edge lists are the same as if added one by one
+	for(unsigned i = 0; i < edgesToAdd.size(); i++) {
+		if(addEdge[i])
+			boost::get(boost::edge_weight, graph)[boost::add_edge(edgesToAdd[i].from, edgesToAdd[i].to, graph).first] = edgesToAdd[i].paramID;
+	}
+
+	for(auto &it : delta.nodesToRemove)
 		boost::clear_vertex(nameToVertex[it], graph);
+
+	invalidateTopologicalCache();
+}
+
+void BaseDatapath::invalidateTopologicalCache() {
+	topologicalCacheValid = false;
+}
+
+void BaseDatapath::buildTopologicalCache() {
+	if(topologicalCacheValid)
+		return;
+
+	std::vector<unsigned> nodeLevel(numOfTotalNodes, 0);
+	std::vector<unsigned> numParents(numOfTotalNodes, 0);
+	std::vector<unsigned> readyNodes;
+	unsigned numOfLevels = 0;
+
+	inEdgeOffsets.assign(numOfTotalNodes + 1, 0);
+	outEdgeOffsets.assign(numOfTotalNodes + 1, 0);
+	inEdgeSources.clear();
+	inEdges.clear();
+	outEdgeTargets.clear();
+	outEdges.clear();
+
+	// Store in/out edges contiguously
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
+		Vertex currNode = nameToVertex[nodeID];
+
+		InEdgeIterator inEdgei, inEdgeEnd;
+		for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(currNode, graph); inEdgei != inEdgeEnd; inEdgei++) {
+			inEdgeSources.push_back(vertexToName[boost::source(*inEdgei, graph)]);
+			inEdges.push_back(*inEdgei);
+		}
+		inEdgeOffsets[nodeID + 1] = inEdges.size();
+
+		OutEdgeIterator outEdgei, outEdgeEnd;
+		for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(currNode, graph); outEdgei != outEdgeEnd; outEdgei++) {
+			outEdgeTargets.push_back(vertexToName[boost::target(*outEdgei, graph)]);
+			outEdges.push_back(*outEdgei);
+		}
+		outEdgeOffsets[nodeID + 1] = outEdges.size();
+
+		numParents[nodeID] = inEdgeOffsets[nodeID + 1] - inEdgeOffsets[nodeID];
+		if(!numParents[nodeID])
+			readyNodes.push_back(nodeID);
+	}
+
+	// Kahn's algorithm: the level of a node is one more than the deepest of its parents
+	unsigned numOfVisitedNodes = 0;
+	while(readyNodes.size()) {
+		unsigned nodeID = readyNodes.back();
+		readyNodes.pop_back();
+		numOfVisitedNodes++;
+
+		if(nodeLevel[nodeID] + 1 > numOfLevels)
+			numOfLevels = nodeLevel[nodeID] + 1;
+
+		for(unsigned i = outEdgeOffsets[nodeID]; i < outEdgeOffsets[nodeID + 1]; i++) {
+			unsigned childNodeID = outEdgeTargets[i];
+
+			if(nodeLevel[nodeID] + 1 > nodeLevel[childNodeID])
+				nodeLevel[childNodeID] = nodeLevel[nodeID] + 1;
+
+			if(!(--numParents[childNodeID]))
+				readyNodes.push_back(childNodeID);
+		}
+	}
+#ifdef CHECK_VISITED_NODES
+	assert(numOfVisitedNodes == numOfTotalNodes && "DDDG has cycles, topological levels could not be calculated");
+#endif
+
+	// Bucket nodes per level, keeping ascending node ID inside each level
+	levelOffsets.assign(numOfLevels + 1, 0);
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++)
+		levelOffsets[nodeLevel[nodeID] + 1]++;
+	for(unsigned level = 0; level < numOfLevels; level++)
+		levelOffsets[level + 1] += levelOffsets[level];
+
+	std::vector<unsigned> levelCursor(levelOffsets.begin(), levelOffsets.end() - 1);
+	levelNodes.assign(numOfTotalNodes, 0);
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++)
+		levelNodes[levelCursor[nodeLevel[nodeID]]++] = nodeID;
+
+	topologicalCacheValid = true;
+}
+
+const std::vector<unsigned> &BaseDatapath::getTopologicalOrder() {
+	buildTopologicalCache();
+
+	// Nodes sorted by level are in topological order
+	return levelNodes;
+}
+
+void BaseDatapath::runInParallel(unsigned from, unsigned to, std::function<void(unsigned, unsigned)> kernel) {
+	unsigned numOfThreads = std::thread::hardware_concurrency();
+	unsigned numOfNodes = to - from;
+
+	if(numOfThreads < 2 || numOfNodes < PARALLEL_LEVEL_MIN_NODES) {
+		kernel(from, to);
+		return;
+	}
+
+	if(numOfNodes / numOfThreads < PARALLEL_LEVEL_MIN_NODES / 4)
+		numOfThreads = numOfNodes / (PARALLEL_LEVEL_MIN_NODES / 4);
+
+	// Chunks are shared by the calling thread and the helper threads granted by the budget. If the budget is
+	// exhausted (e.g. by concurrent kernels or clock targets), all chunks run inline
+	unsigned chunkSize = (numOfNodes + numOfThreads - 1) / numOfThreads;
+	unsigned numOfChunks = (numOfNodes + chunkSize - 1) / chunkSize;
+	ThreadBudget::getInstance().run(numOfChunks, numOfThreads - 1, [from, to, chunkSize, &kernel] (unsigned i) {
+		unsigned chunkFrom = from + i * chunkSize;
+		kernel(chunkFrom, (chunkFrom + chunkSize < to)? chunkFrom + chunkSize : to);
+	});
 }
 
 void BaseDatapath::initBaseAddress() {
+	DATAPATH_PHASE_SCOPE(phase, "initBaseAddress");
+
 	const ConfigurationManager::partitionCfgMapTy &partitionMap = CM.getPartitionCfgMap();
 	const ConfigurationManager::partitionCfgMapTy &completePartitionMap = CM.getCompletePartitionCfgMap();
 	const std::unordered_map<int, std::pair<std::string, int64_t>> &getElementPtrMap = PC.getGetElementPtrList();
+	const std::unordered_map<int, std::pair<int64_t, unsigned>> &memoryTraceList = PC.getMemoryTraceList();
 
-	VertexIterator vi, viEnd;
-	for(std::tie(vi, viEnd) = vertices(graph); vi != viEnd; vi++) {
-		if(!boost::degree(*vi, graph))
-			continue;
+	// Array names are interned, base addresses are propagated as (array ID, address) pairs
+	s2uMap arrayIDs;
+	arrayNames.clear();
+	memoryNodes.clear();
+	memoryNodeArrays.clear();
+	memoryNodeOffsets.clear();
+	partitionNames.clear();
+	// Resolved base address of each getelementptr, load and store (-1 as array ID if not resolved)
+	std::vector<std::pair<int, int64_t>> resolved(numOfTotalNodes, std::make_pair(-1, 0));
+
+	auto internAddress = [this, &arrayIDs, &getElementPtrMap](unsigned nodeID) {
+		std::unordered_map<int, std::pair<std::string, int64_t>>::const_iterator found = getElementPtrMap.find(nodeID);
+		if(getElementPtrMap.end() == found)
+			return std::make_pair(-1, (int64_t) 0);
+
+		s2uMap::iterator arrayID = arrayIDs.insert(std::make_pair(found->second.first, arrayNames.size())).first;
+		if(arrayID->second == arrayNames.size())
+			arrayNames.push_back(found->second.first);
+
+		return std::make_pair((int) arrayID->second, found->second.second);
+	};
 
-		Vertex currNode = *vi;
-		unsigned nodeID = vertexToName[currNode];
+	// A node takes the base address of the first getelementptr/load parent that generates its address (which is
+	// already resolved, since parents come first in topological order), or of an alloca parent. If there is no such
+	// parent, the node's own getelementptr information is used. This is the same as walking the whole chain of
+	// getelementptr/loads up from each memory node, but each chain link is visited only once
+	for(auto &nodeID : getTopologicalOrder()) {
+		Vertex currNode = nameToVertex[nodeID];
 		int nodeMicroop = microops.at(nodeID);
 
-		if(!isMemoryOp(nodeMicroop))
+		if(!boost::degree(currNode, graph))
+			continue;
+		if(LLVM_IR_GetElementPtr != nodeMicroop && !isMemoryOp(nodeMicroop))
 			continue;
 
-		bool modified = false;
-
-		while(true) {
-			bool foundParent = false;
+		bool foundParent = false;
 
-			InEdgeIterator inEdgei, inEdgeEnd;
-			for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(currNode, graph); inEdgei != inEdgeEnd; inEdgei++) {
-				int paramID = edgeToWeight[*inEdgei];
-				if((isLoadOp(nodeMicroop) && paramID != 1) || (LLVM_IR_GetElementPtr == nodeMicroop && paramID != 1) || (isStoreOp(nodeMicroop) && paramID != 2))
-					continue;
+		InEdgeIterator inEdgei, inEdgeEnd;
+		for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(currNode, graph); inEdgei != inEdgeEnd; inEdgei++) {
+			int paramID = edgeToWeight[*inEdgei];
+			if((isLoadOp(nodeMicroop) && paramID != 1) || (LLVM_IR_GetElementPtr == nodeMicroop && paramID != 1) || (isStoreOp(nodeMicroop) && paramID != 2))
+				continue;
 
-				unsigned parentID = vertexToName[boost::source(*inEdgei, graph)];
-				int parentMicroop = microops.at(parentID);
-				if(LLVM_IR_GetElementPtr == parentMicroop || isLoadOp(parentMicroop)) {
-					baseAddress[nodeID] = getElementPtrMap.at(parentID);
-					currNode = boost::source(*inEdgei, graph);
-					nodeMicroop = parentMicroop;
-					foundParent = true;
-					modified = true;
-					break;
-				}
-				else if(LLVM_IR_Alloca == parentMicroop) {
-					baseAddress[nodeID] = getElementPtrMap.at(parentID);
-					modified = true;
-					break;
-				}
+			unsigned parentID = vertexToName[boost::source(*inEdgei, graph)];
+			int parentMicroop = microops.at(parentID);
+			if(LLVM_IR_GetElementPtr == parentMicroop || isLoadOp(parentMicroop)) {
+				resolved[nodeID] = resolved[parentID];
+				foundParent = true;
+				break;
 			}
-
-			if(!foundParent)
+			else if(LLVM_IR_Alloca == parentMicroop) {
+				resolved[nodeID] = internAddress(parentID);
+				foundParent = true;
 				break;
+			}
 		}
 
-		if(!modified)
-			baseAddress[nodeID] = getElementPtrMap.at(nodeID);
+		if(!foundParent)
+			resolved[nodeID] = internAddress(nodeID);
+	}
+
+	std::vector<bool> arrayChecked(arrayNames.size(), false);
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
+		if(!isMemoryOp(microops.at(nodeID)) || !boost::degree(nameToVertex[nodeID], graph))
+			continue;
+
+		int arrayID = resolved[nodeID].first;
+		// Without a base address, the node can be assigned neither to an array nor to a partition, and the memory lists
+		// below would be indexed with an invalid array ID
+		if(-1 == arrayID) {
+			errs() << "Base address of memory node " << std::to_string(nodeID) << " not found in getelementptr list\n";
+			exit(-1);
+		}
+		baseAddress[nodeID] = std::make_pair(arrayNames[arrayID], resolved[nodeID].second);
+
+		// Element offset inside the array, used for partition assignment
+		// XXX: Sub-byte accesses (e.g. i1) are considered byte-sized
+		const std::pair<int64_t, unsigned> &access = memoryTraceList.at(nodeID);
+		unsigned dataSize = (access.second >> 3)? access.second >> 3 : 1;
+		memoryNodes.push_back(nodeID);
+		memoryNodeArrays.push_back(arrayID);
+		memoryNodeOffsets.push_back((access.first - resolved[nodeID].second) / dataSize);
 
 		// Check if base address is inside a partition request. If not, add to a no-partition vector
 		// XXX: A partition sanity check was implemented in the original version.
 		// I've removed it because since my map and partition configuration are constructed together ("atomically"),
 		// I don't think that are possibilities of a partition not existing in the database
-		std::string baseAddr = baseAddress[nodeID].first;
+		if(arrayChecked[arrayID])
+			continue;
+		arrayChecked[arrayID] = true;
+
+		const std::string &baseAddr = arrayNames[arrayID];
 		if(partitionMap.end() == partitionMap.find(baseAddr) && completePartitionMap.end() == completePartitionMap.find(baseAddr))
 			noPartitionArrayName.insert(baseAddr);
 	}
@@ -285,39 +581,22 @@ void BaseDatapath::initBaseAddress() {
 uint64_t BaseDatapath::fpgaEstimationOneMoreSubtraceForRecIICalculation() {
 	VERBOSE_PRINT(errs() << "\tStarting RecII calculation\n");
 
-	VERBOSE_PRINT(errs() << "\tRemoving induction dependencies\n");
-	removeInductionDependencies();
-	VERBOSE_PRINT(errs() << "\tRemoving PHI nodes\n");
-	removePhiNodes();
+	rewriteDDDG();
 
-	if(args.fSBOpt) {
-		VERBOSE_PRINT(errs() << "\tOptimising store buffers\n");
-		enableStoreBufferOptimisation();
+	// From this point on, everything depends on the clock target
+	if(args.clockTargets.size() > 1) {
+		VERBOSE_PRINT(errs() << "\tStarting clock sweep with " << std::to_string(args.clockTargets.size()) << " targets\n");
+		sweepASAPII = runClockSweep(&BaseDatapath::fpgaEstimationOneMoreSubtraceForRecIICalculationPerClock);
+		return sweepASAPII.at(0);
 	}
 
+	return fpgaEstimationOneMoreSubtraceForRecIICalculationPerClock();
+}
+
+uint64_t BaseDatapath::fpgaEstimationOneMoreSubtraceForRecIICalculationPerClock() {
 	// Put the node latency using selected architecture as edge weights in the graph
 	VERBOSE_PRINT(errs() << "\tUpdating DDDG edges with operation latencies according to selected hardware\n");
-	bool nonNullFound = false;
-	EdgeIterator edgei, edgeEnd;
-	for(std::tie(edgei, edgeEnd) = boost::edges(graph); edgei != edgeEnd; edgei++) {
-		uint8_t weight = edgeToWeight[*edgei];
-
-		// XXX: Up to this point no control edges were added so far, I think
-		if(EDGE_CONTROL == weight) {
-			boost::put(boost::edge_weight, graph, *edgei, 0);
-		}
-		else {
-			unsigned nodeID = vertexToName[boost::source(*edgei, graph)];
-			unsigned opcode = microops.at(nodeID);
-			unsigned latency = profile->getLatency(opcode);
-			boost::put(boost::edge_weight, graph, *edgei, latency);
-
-			if(latency)
-				nonNullFound = true;
-		}
-	}
-
-	if(!nonNullFound) {
+	if(!updateEdgeWeightsWithLatencies()) {
 		VERBOSE_PRINT(errs() << "\tThis DDDG has no latency\n");
 		return 0;
 	}
@@ -331,39 +610,42 @@ uint64_t BaseDatapath::fpgaEstimationOneMoreSubtraceForRecIICalculation() {
 uint64_t BaseDatapath::fpgaEstimation() {
 	VERBOSE_PRINT(errs() << "\tStarting IL and II calculation\n");
 
-	VERBOSE_PRINT(errs() << "\tRemoving induction dependencies\n");
-	removeInductionDependencies();
-	VERBOSE_PRINT(errs() << "\tRemoving PHI nodes\n");
-	removePhiNodes();
+	rewriteDDDG();
 
-	if(args.fSBOpt) {
-		VERBOSE_PRINT(errs() << "\tOptimising store buffers\n");
-		enableStoreBufferOptimisation();
+	// From this point on, everything depends on the clock target
+	if(args.clockTargets.size() > 1) {
+		VERBOSE_PRINT(errs() << "\tStarting clock sweep with " << std::to_string(args.clockTargets.size()) << " targets\n");
+		sweepCycles = runClockSweep(&BaseDatapath::fpgaEstimationPerClock);
+		return sweepCycles.at(0);
 	}
 
-	// Put the node latency using selected architecture as edge weights in the graph
-	VERBOSE_PRINT(errs() << "\tUpdating DDDG edges with operation latencies according to selected hardware\n");
-	bool nonNullFound = false;
-	EdgeIterator edgei, edgeEnd;
-	for(std::tie(edgei, edgeEnd) = boost::edges(graph); edgei != edgeEnd; edgei++) {
-		uint8_t weight = edgeToWeight[*edgei];
+	return fpgaEstimationPerClock();
+}
 
-		// XXX: Up to this point no control edges were added so far, I think
-		if(EDGE_CONTROL == weight) {
-			boost::put(boost::edge_weight, graph, *edgei, 0);
-		}
-		else {
-			unsigned nodeID = vertexToName[boost::source(*edgei, graph)];
-			unsigned opcode = microops.at(nodeID);
-			unsigned latency = profile->getLatency(opcode);
-			boost::put(boost::edge_weight, graph, *edgei, latency);
+uint64_t BaseDatapath::reestimateWithPartitions(
+	const ConfigurationManager::partitionCfgMapTy &partitionCfgMap,
+	const ConfigurationManager::partitionCfgMapTy &completePartitionCfgMap
+) {
+	VERBOSE_PRINT(errs() << "\tRe-estimating IL and II with new partition configuration\n");
 
-			if(latency)
-				nonNullFound = true;
-		}
+	if(sweepDatapaths.size()) {
+		sweepCycles = runOnSweepDatapaths([&partitionCfgMap, &completePartitionCfgMap](BaseDatapath &sweepDatapath) {
+			return sweepDatapath.reestimateWithPartitions(partitionCfgMap, completePartitionCfgMap);
+		});
+		numCycles = sweepCycles.at(0);
+	}
+	// DDDGs with no latency are not scheduled, there is nothing to re-estimate
+	else if(unconstrainedProfile) {
+		numCycles = fpgaEstimationPerPartition(partitionCfgMap, completePartitionCfgMap);
 	}
 
-	if(!nonNullFound) {
+	return numCycles;
+}
+
+uint64_t BaseDatapath::fpgaEstimationPerClock() {
+	// Put the node latency using selected architecture as edge weights in the graph
+	VERBOSE_PRINT(errs() << "\tUpdating DDDG edges with operation latencies according to selected hardware\n");
+	if(!updateEdgeWeightsWithLatencies()) {
 		VERBOSE_PRINT(errs() << "\tThis DDDG has no latency\n");
 		return 0;
 	}
@@ -376,9 +658,22 @@ uint64_t BaseDatapath::fpgaEstimation() {
 
 	VERBOSE_PRINT(errs() << "\tIdentifying critical paths\n");
 	identifyCriticalPaths();
+	asapLatency = std::get<0>(asapResult);
+
+	VERBOSE_PRINT(errs() << "\tPreparing DDDG for resource-constrained scheduling\n");
+	prepareRCScheduling();
 
+	return fpgaEstimationPerPartition(CM.getPartitionCfgMap(), CM.getCompletePartitionCfgMap());
+}
+
+// From this point on, everything depends on the partition configuration. The DDDG is not changed here, thus this
+// function can be called again with other partitionings (see reestimateWithPartitions())
+uint64_t BaseDatapath::fpgaEstimationPerPartition(
+	const ConfigurationManager::partitionCfgMapTy &partitionCfgMap,
+	const ConfigurationManager::partitionCfgMapTy &completePartitionCfgMap
+) {
 	VERBOSE_PRINT(errs() << "\tStarting resource-constrained scheduling\n");
-	std::pair<uint64_t, double> rcPair = rcScheduling();
+	std::pair<uint64_t, double> rcPair = rcScheduling(partitionCfgMap, completePartitionCfgMap);
 	rcIL = rcPair.first;
 	double achievedPeriod = rcPair.second;
 
@@ -386,13 +681,33 @@ uint64_t BaseDatapath::fpgaEstimation() {
 	std::tuple<std::string, uint64_t> resIIMem = calculateResIIMem();
 
 	VERBOSE_PRINT(errs() << "\tGetting hardware-constrained II\n");
-	std::tuple<std::string, uint64_t> resIIOp = profile->calculateResIIOp();
-
-	VERBOSE_PRINT(errs() << "\tGetting recurrence-constrained II\n");
-	uint64_t recII = calculateRecII(std::get<0>(asapResult));
+	std::tuple<std::string, uint64_t> resIIOp;
+	{
+		DATAPATH_PHASE_SCOPE(phase, "resIIOp");
+		resIIOp = profile->calculateResIIOp();
+	}
 
+	uint64_t recII;
 	uint64_t resII = (std::get<1>(resIIMem) > std::get<1>(resIIOp))? std::get<1>(resIIMem) : std::get<1>(resIIOp);
-	maxII = (resII > recII)? resII : recII;
+
+	if(enablePipelining && args.fModuloScheduling) {
+		VERBOSE_PRINT(errs() << "\tStarting modulo scheduling\n");
+		std::tuple<uint64_t, uint64_t, uint64_t> msResult = moduloScheduling();
+		recII = std::get<2>(msResult);
+
+		// Operation chaining under the clock period is only modelled by the resource-constrained scheduler
+		if(std::get<1>(msResult) > rcIL)
+			rcIL = std::get<1>(msResult);
+
+		// ResIIMem also accounts for memory interface recurrences, which are not modelled by the reservation tables
+		maxII = (std::get<0>(msResult) > resII)? std::get<0>(msResult) : resII;
+	}
+	else {
+		VERBOSE_PRINT(errs() << "\tGetting recurrence-constrained II\n");
+		recII = calculateRecII(asapLatency);
+
+		maxII = (resII > recII)? resII : recII;
+	}
 
 	P.clear();
 	profile->fillPack(P, loopLevel, datapathType, enablePipelining? maxII : 0);
@@ -466,7 +781,7 @@ uint64_t BaseDatapath::fpgaEstimation() {
 	P.addElement<uint64_t>("_tRcIL", rcIL * accUnrollFactor);
 
 	// TODO Resource estimation is being performed in dumpSummary (not a very good place for this eh?)
-	dumpSummary(numCycles, std::get<0>(asapResult), achievedPeriod, maxII, resIIMem, resIIOp, recII);
+	dumpSummary(numCycles, asapLatency, achievedPeriod, maxII, resIIMem, resIIOp, recII);
 
 	P.addDescriptor("Achieved period", Pack::MERGE_MAX, Pack::TYPE_FLOAT);
 	P.addElement<float>("Achieved period", achievedPeriod);
@@ -503,18 +818,135 @@ uint64_t BaseDatapath::fpgaEstimation() {
 	return numCycles;
 }
 
-void BaseDatapath::removeInductionDependencies() {
-	const std::vector<std::string> &instID = PC.getInstIDList();
+bool BaseDatapath::updateEdgeWeightsWithLatencies() {
+	bool nonNullFound = false;
+
+	EdgeIterator edgei, edgeEnd;
+	for(std::tie(edgei, edgeEnd) = boost::edges(graph); edgei != edgeEnd; edgei++) {
+		uint8_t weight = edgeToWeight[*edgei];
+
+		// XXX: Up to this point no control edges were added so far, I think
+		if(EDGE_CONTROL == weight) {
+			boost::put(boost::edge_weight, graph, *edgei, 0);
+		}
+		else {
+			unsigned nodeID = vertexToName[boost::source(*edgei, graph)];
+			unsigned opcode = microops.at(nodeID);
+			unsigned latency = profile->getLatency(opcode);
+			boost::put(boost::edge_weight, graph, *edgei, latency);
+
+			if(latency)
+				nonNullFound = true;
+		}
+	}
+
+	return nonNullFound;
+}
+
+std::vector<uint64_t> BaseDatapath::runClockSweep(uint64_t (BaseDatapath::*perClockFunc)()) {
+	unsigned numOfTargets = args.clockTargets.size();
+
+	// Compressed trace containers re-read their files on every access, they can't be shared among threads
+	assert(!(args.compressed) && "Clock sweep is not supported with compressed trace containers");
+
+	// Each clock target works on its own copy of the DDDG, hardware profile and summary stream.
+	// If an ASAP II was calculated per target (i.e. pipelining with clock sweep), use the respective value
+	sweepSummaries.clear();
+	sweepDatapaths.clear();
+	for(unsigned i = 0; i < numOfTargets; i++) {
+		uint64_t targetASAPII = (sweepASAPII.size() == numOfTargets)? sweepASAPII.at(i) : asapII;
+
+		sweepSummaries.push_back(std::unique_ptr<std::stringstream>(new std::stringstream));
+		sweepDatapaths.push_back(std::unique_ptr<BaseDatapath>(new BaseDatapath(
+			*this, args.clockTargets[i].first, args.clockTargets[i].second, targetASAPII, sweepSummaries.back().get()
+		)));
+	}
+
+	return runOnSweepDatapaths([perClockFunc](BaseDatapath &sweepDatapath) { return (sweepDatapath.*perClockFunc)(); });
+}
+
+std::vector<uint64_t> BaseDatapath::runOnSweepDatapaths(std::function<uint64_t(BaseDatapath &)> perClockFunc) {
+	std::vector<uint64_t> results(sweepDatapaths.size(), 0);
+
+	for(auto &it : sweepSummaries)
+		it->str("");
+
+	// Clock targets beyond the available threads are run inline (e.g. when kernels are also analysed concurrently)
+	ThreadBudget::getInstance().run(
+		sweepDatapaths.size(), sweepDatapaths.size(),
+		[this, &results, perClockFunc] (unsigned i) { results[i] = perClockFunc(*(sweepDatapaths[i])); }
+	);
+
+	// Summaries are written in the same order as the clock targets were provided
+	for(auto &it : sweepSummaries)
+		*summaryFile << it->str();
+	for(auto &it : sweepDatapaths) {
+		for(auto &it2 : it->deferredResults)
+			resultWriter.write(it2);
+		it->deferredResults.clear();
+	}
+
+	sweepPacks.clear();
+	for(auto &it : sweepDatapaths)
+		sweepPacks.push_back(it->P);
+
+	// The first clock target is the reference one. Its results are kept in this datapath
+	BaseDatapath &reference = *(sweepDatapaths.at(0));
+	P = reference.P;
+	maxII = reference.maxII;
+	rcIL = reference.rcIL;
+	sharedLoadsRemoved = reference.sharedLoadsRemoved;
+	repeatedStoresRemoved = reference.repeatedStoresRemoved;
+
+	return results;
+}
+
+std::string BaseDatapath::getClockSweepSuffix(HardwareProfile &profile) {
+	if(args.clockTargets.size() <= 1)
+		return "";
+
+	std::stringstream suffix;
+	suffix << "_" << profile.getFrequency() << "MHz";
+	return suffix.str();
+}
+
+// Clock-independent DDDG rewrites, performed before estimation. Induction dependencies and PHI nodes are removed in a
+// single sweep, store buffer optimisation needs the PHI-free DDDG and runs on its own. Memory disambiguation runs in
+// between (same order as Aladdin): ambiguous loads must be marked before the store buffer forwards them, and the
+// edges it adds must be in place before edge weights become latencies
+void BaseDatapath::rewriteDDDG() {
+	RewritePassManager RPM(*this);
+
+	VERBOSE_PRINT(errs() << "\tRemoving induction dependencies\n");
+	removeInductionDependencies(RPM);
+	VERBOSE_PRINT(errs() << "\tRemoving PHI nodes\n");
+	removePhiNodes(RPM);
+
+	if(args.fMemDisambuigOpt) {
+		RPM.run();
+
+		VERBOSE_PRINT(errs() << "\tPerforming memory disambiguation\n");
+		performMemoryDisambiguation();
+	}
+
+	if(args.fSBOpt) {
+		VERBOSE_PRINT(errs() << "\tOptimising store buffers\n");
+		enableStoreBufferOptimisation(RPM);
+	}
+
+	RPM.run();
+}
 
-	std::vector<Vertex> topologicalSortedNodes;
-	boost::topological_sort(graph, std::back_inserter(topologicalSortedNodes));
+void BaseDatapath::removeInductionDependencies(RewritePassManager &RPM) {
+	// Trace lists are captured by address, since passes only run after this function returns
+	const std::vector<unsigned> *staticInstIDs = &(PC.getStaticInstIDList());
+	const std::vector<staticInstTy> *staticInsts = &(PC.getStaticInstList());
 
-	// Nodes with no incoming edges first
-	for(auto vi = topologicalSortedNodes.rbegin(); vi != topologicalSortedNodes.rend(); vi++) {
-		unsigned nodeID = vertexToName[*vi];
-		std::string nodeInstID = instID.at(nodeID);
+	// Parents are visited first (ascending order), thus their microops are already final
+	RPM.addPass("removeInductionDependencies", RewritePassManager::ORDER_ASCENDING, false, [this, staticInstIDs, staticInsts](unsigned nodeID, edgeDeltaTy &delta) {
+		Vertex currNode = nameToVertex[nodeID];
 
-		if(nodeInstID.find("indvars") != std::string::npos) {
+		if(staticInsts->at(staticInstIDs->at(nodeID)).flags & ParsedTraceContainer::STATIC_INST_INDUCTION) {
 #ifndef BYTE_OPS
 			if(LLVM_IR_Add == microops.at(nodeID))
 				microops.at(nodeID) = LLVM_IR_IndexAdd;
@@ -529,11 +961,11 @@ void BaseDatapath::removeInductionDependencies() {
 		}
 		else {
 			InEdgeIterator inEdgei, inEdgeEnd;
-			for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(*vi, graph); inEdgei != inEdgeEnd; inEdgei++) {
+			for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(currNode, graph); inEdgei != inEdgeEnd; inEdgei++) {
 				unsigned parentID = vertexToName[boost::source(*inEdgei, graph)];
-				std::string parentInstID = instID.at(parentID);
+				bool parentIsInduction = staticInsts->at(staticInstIDs->at(parentID)).flags & ParsedTraceContainer::STATIC_INST_INDUCTION;
 
-				if(std::string::npos == parentInstID.find("indvars") && !isIndexOp(microops.at(parentID)))
+				if(!parentIsInduction && !isIndexOp(microops.at(parentID)))
 					continue;
 
 #ifndef BYTE_OPS
@@ -549,174 +981,201 @@ void BaseDatapath::removeInductionDependencies() {
 #endif
 			}
 		}
-	}
+	});
 }
 
-void BaseDatapath::removePhiNodes() {
-	std::set<Edge> edgesToRemove;
-	std::vector<edgeTy> edgesToAdd;
+void BaseDatapath::removePhiNodes(RewritePassManager &RPM) {
+	// Forwarded loop-carried dependencies are only added after the sweep, thus PHI chains are not forwarded transitively
+	std::shared_ptr<std::vector<carriedEdgeTy>> carriedToAdd = std::make_shared<std::vector<carriedEdgeTy>>();
 
-	VertexIterator vi, viEnd;
-	for(std::tie(vi, viEnd) = boost::vertices(graph); vi != viEnd; vi++) {
-		unsigned nodeID = vertexToName[*vi];
+	// This pass only reads PHI/bitcast microops, which are not changed by removeInductionDependencies()
+	RPM.addPass("removePhiNodes", RewritePassManager::ORDER_ASCENDING, false, [this, carriedToAdd](unsigned nodeID, edgeDeltaTy &delta) {
 		int nodeMicroop = microops.at(nodeID);
 
 		if(nodeMicroop != LLVM_IR_PHI && nodeMicroop != LLVM_IR_BitCast)
-			continue;
+			return;
 
 		// If code reaches this point, this node is a PHI node
 
+		Vertex currNode = nameToVertex[nodeID];
 		std::vector<std::pair<unsigned, uint8_t>> phiChild;
 
 		// Mark its children
 		OutEdgeIterator outEdgei, outEdgeEnd;
-		for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(*vi, graph); outEdgei != outEdgeEnd; outEdgei++) {
-			edgesToRemove.insert(*outEdgei);
+		for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(currNode, graph); outEdgei != outEdgeEnd; outEdgei++) {
+			delta.edgesToRemove.push_back(*outEdgei);
 			phiChild.push_back(std::make_pair(vertexToName[target(*outEdgei, graph)], edgeToWeight[*outEdgei]));
 		}
 
 		if(!phiChild.size())
-			continue;
+			return;
 
 		// Mark its parents
 		InEdgeIterator inEdgei, inEdgeEnd;
-		for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(*vi, graph); inEdgei != inEdgeEnd; inEdgei++) {
+		for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(currNode, graph); inEdgei != inEdgeEnd; inEdgei++) {
 			unsigned parentID = vertexToName[boost::source(*inEdgei, graph)];
-			edgesToRemove.insert(*inEdgei);
+			delta.edgesToRemove.push_back(*inEdgei);
 
 			for(auto &child : phiChild)
-				edgesToAdd.push_back({parentID, child.first, child.second});
+				delta.edgesToAdd.push_back({parentID, child.first, child.second});
 		}
 
-		std::vector<std::pair<unsigned, uint8_t>>().swap(phiChild);
-	}
+		// Loop-carried dependencies to this PHI node are forwarded to its children as well
+		for(auto &it : loopCarriedEdges) {
+			if(it.to != nodeID)
+				continue;
 
-	// Edges from-to PHI nodes are substituted by direct connections (i.e. PHI nodes are removed)
-	updateRemoveDDDGEdges(edgesToRemove);
-	updateAddDDDGEdges(edgesToAdd);
+			for(auto &child : phiChild)
+				carriedToAdd->push_back({it.from, child.first, it.distance});
+		}
+	}, [this, carriedToAdd]() {
+		// Edges from-to PHI nodes were substituted by direct connections (i.e. PHI nodes are removed)
+		loopCarriedEdges.insert(loopCarriedEdges.end(), carriedToAdd->begin(), carriedToAdd->end());
+	});
 }
 
-void BaseDatapath::enableStoreBufferOptimisation() {
-	const std::vector<std::string> &instID = PC.getInstIDList();
-	const std::vector<std::string> &dynamicMethodID = PC.getFuncList();
-	const std::vector<std::string> &prevBB = PC.getPrevBBList();
+void BaseDatapath::enableStoreBufferOptimisation(RewritePassManager &RPM) {
+	const std::vector<unsigned> *staticInstIDs = &(PC.getStaticInstIDList());
+	std::shared_ptr<bool> skipNext = std::make_shared<bool>(false);
 
-	std::vector<edgeTy> edgesToAdd;
-	std::vector<unsigned> nodesToRemove;
+	// Barrier: the stored values must be connected to their actual generators (i.e. PHI nodes already removed)
+	RPM.addPass("storeBufferOptimisation", RewritePassManager::ORDER_ASCENDING, true,
+		[this, staticInstIDs, skipNext](unsigned nodeID, edgeDeltaTy &delta) {
+		if(*skipNext) {
+			*skipNext = false;
+			return;
+		}
 
-	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
 		// Node not found or with no connections
-		if(nameToVertex.end() == nameToVertex.find(nodeID) || !boost::degree(nameToVertex[nodeID], graph)) {
+		if(nodeID >= nameToVertex.size() || !boost::degree(nameToVertex[nodeID], graph)) {
 			// XXX: We will check the child and also the parent of this node, therefore this might be the case
-			// why the counter is incremented by 2 (i.e. check in pairs)
-			nodeID++;
-			continue;
+			// why the next node is skipped (i.e. check in pairs)
+			*skipNext = true;
+			return;
 		}
 
-		if(isStoreOp(microops.at(nodeID))) {
-			std::string key = constructUniqueID(dynamicMethodID.at(nodeID), instID.at(nodeID), prevBB.at(nodeID));
-			// XXX: Please note that dynamicMemoryOps is still not generated in pipeline analysis
-			// Dynamic store, cannot disambiguate in static time, cannot remove
-			if(dynamicMemoryOps.find(key) != dynamicMemoryOps.end()) {
-				nodeID++;
-				continue;
-			}
+		if(!isStoreOp(microops.at(nodeID)))
+			return;
 
-			Vertex node = nameToVertex[nodeID];
-			std::vector<Vertex> storeChild;
+		// XXX: Please note that dynamicMemoryOps is still not generated in pipeline analysis
+		// Dynamic store, cannot disambiguate in static time, cannot remove
+		if(dynamicMemoryOps.find(staticInstIDs->at(nodeID)) != dynamicMemoryOps.end()) {
+			*skipNext = true;
+			return;
+		}
 
-			// Check for child nodes that are loads
-			OutEdgeIterator outEdgei, outEdgeEnd;
-			for(tie(outEdgei, outEdgeEnd) = boost::out_edges(node, graph); outEdgei != outEdgeEnd; outEdgei++) {
-				Vertex child = boost::target(*outEdgei, graph);
-				unsigned childID = vertexToName[child];
-
-				if(isLoadOp(microops.at(childID))) {
-					std::string key = constructUniqueID(dynamicMethodID.at(childID), instID.at(childID), prevBB.at(childID));
-					// TODO: Same possible problem as above!
-					if(dynamicMemoryOps.find(key) != dynamicMemoryOps.end())
-						continue;
-					else
-						storeChild.push_back(child);
-				}
+		Vertex node = nameToVertex[nodeID];
+		std::vector<Vertex> storeChild;
+
+		// Check for child nodes that are loads
+		OutEdgeIterator outEdgei, outEdgeEnd;
+		for(tie(outEdgei, outEdgeEnd) = boost::out_edges(node, graph); outEdgei != outEdgeEnd; outEdgei++) {
+			Vertex child = boost::target(*outEdgei, graph);
+			unsigned childID = vertexToName[child];
+
+			if(isLoadOp(microops.at(childID))) {
+				// TODO: Same possible problem as above!
+				if(dynamicMemoryOps.find(staticInstIDs->at(childID)) != dynamicMemoryOps.end())
+					continue;
+				else
+					storeChild.push_back(child);
 			}
+		}
 
-			if(storeChild.size()) {
-				// Find the parent of the store node that generates the stored value
-				InEdgeIterator inEdgei, inEdgeEnd;
-				for(tie(inEdgei, inEdgeEnd) = boost::in_edges(node, graph); inEdgei != inEdgeEnd; inEdgei++) {
-					if(1 == edgeToWeight[*inEdgei]) {
-						// Create a direct connection between the node that generates the value and the node that loads it
-						for(auto &it : storeChild) {
-							nodesToRemove.push_back(vertexToName[it]);
-
-							OutEdgeIterator outEdgei, outEdgeEnd;
-							for(tie(outEdgei, outEdgeEnd) = boost::out_edges(it, graph); outEdgei != outEdgeEnd; outEdgei++) {
-								edgesToAdd.push_back({
-									(unsigned) vertexToName[boost::source(*inEdgei, graph)],
-									(unsigned) vertexToName[boost::target(*outEdgei, graph)],
-									edgeToWeight[*outEdgei]
-								});
-							}
-						}
-
-						break;
+		if(!storeChild.size())
+			return;
+
+		// Find the parent of the store node that generates the stored value
+		InEdgeIterator inEdgei, inEdgeEnd;
+		for(tie(inEdgei, inEdgeEnd) = boost::in_edges(node, graph); inEdgei != inEdgeEnd; inEdgei++) {
+			if(1 == edgeToWeight[*inEdgei]) {
+				// Sequences of static [value generation]->store->load->[value use] are substituted by [value generation]->[value use]
+				for(auto &it : storeChild) {
+					delta.nodesToRemove.push_back(vertexToName[it]);
+
+					OutEdgeIterator outEdgei, outEdgeEnd;
+					for(tie(outEdgei, outEdgeEnd) = boost::out_edges(it, graph); outEdgei != outEdgeEnd; outEdgei++) {
+						delta.edgesToAdd.push_back({
+							(unsigned) vertexToName[boost::source(*inEdgei, graph)],
+							(unsigned) vertexToName[boost::target(*outEdgei, graph)],
+							edgeToWeight[*outEdgei]
+						});
 					}
 				}
+
+				break;
 			}
 		}
-	}
-
-	// Sequences of static [value generation]->store->load->[value use] are substituted by [value generation]->[value use]
-	updateAddDDDGEdges(edgesToAdd);
-	updateRemoveDDDGNodes(nodesToRemove);
+	});
 }
 
-void BaseDatapath::initScratchpadPartitions() {
-	const ConfigurationManager::partitionCfgMapTy &partitionMap = CM.getPartitionCfgMap();
-	const std::unordered_map<int, std::pair<int64_t, unsigned>> &memoryTraceList = PC.getMemoryTraceList();
+void BaseDatapath::initScratchpadPartitions(const ConfigurationManager::partitionCfgMapTy &partitionMap) {
+	// Partitioning parameters are resolved once per array (a factor of 1 means no partitioning)
+	arrayPartitionFactors.assign(arrayNames.size(), 1);
+	std::vector<bool> arrayIsBlock(arrayNames.size(), false);
+	std::vector<double> arrayBlockSizes(arrayNames.size(), 0);
+	for(unsigned i = 0; i < arrayNames.size(); i++) {
+		ConfigurationManager::partitionCfgMapTy::const_iterator found = partitionMap.find(arrayNames[i]);
+		if(partitionMap.end() == found)
+			continue;
 
-	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
-		if(!isMemoryOp(microops.at(nodeID)) || baseAddress.end() == baseAddress.find(nodeID))
+		unsigned type = found->second.type;
+		uint64_t size = found->second.size;
+		uint64_t pFactor = found->second.pFactor;
+
+		if(1 == pFactor)
 			continue;
 
-		std::string label = baseAddress[nodeID].first;
-		int64_t address = baseAddress[nodeID].second;
+		if(ConfigurationManager::partitionCfgTy::PARTITION_TYPE_BLOCK == type) {
+			arrayIsBlock[i] = true;
+			arrayBlockSizes[i] = std::ceil(nextPowerOf2(size) / pFactor);
+		}
+		else if(ConfigurationManager::partitionCfgTy::PARTITION_TYPE_CYCLIC != type)
+			assert(false && "Invalid partition type found");
 
-		ConfigurationManager::partitionCfgMapTy::const_iterator found = partitionMap.find(label);
-		if(found != partitionMap.end()) {
-			unsigned type = found->second.type;
-			uint64_t size = found->second.size;
-			uint64_t pFactor = found->second.pFactor;
+		arrayPartitionFactors[i] = pFactor;
+	}
 
-			if(1 == pFactor)
-				continue;
+	// Bank of each memory node, calculated over the contiguous (array ID, offset) lists
+	memoryNodeBanks.assign(memoryNodes.size(), 0);
+	for(unsigned i = 0; i < memoryNodes.size(); i++) {
+		unsigned arrayID = memoryNodeArrays[i];
+		uint64_t pFactor = arrayPartitionFactors[arrayID];
 
-			int64_t absAddress = memoryTraceList.at(nodeID).first;
-			unsigned dataSize = memoryTraceList.at(nodeID).second >> 3;
-			int64_t relAddress = (absAddress - address) / dataSize;
+		if(1 == pFactor)
+			continue;
 
-			int64_t finalAddress;
-			if(ConfigurationManager::partitionCfgTy::PARTITION_TYPE_BLOCK == type)
-				finalAddress = relAddress / std::ceil(nextPowerOf2(size) / pFactor);
-			else if(ConfigurationManager::partitionCfgTy::PARTITION_TYPE_CYCLIC == type)
-				finalAddress = relAddress % pFactor;
-			else
-				assert(false && "Invalid partition type found");
+		if(arrayIsBlock[arrayID])
+			memoryNodeBanks[i] = memoryNodeOffsets[i] / arrayBlockSizes[arrayID];
+		else
+			memoryNodeBanks[i] = memoryNodeOffsets[i] % pFactor;
+	}
 
+	// Partition names are built only once per (array, bank) pair
+	partitionNames.resize(arrayNames.size());
+	for(unsigned i = 0; i < memoryNodes.size(); i++) {
+		unsigned nodeID = memoryNodes[i];
+		unsigned arrayID = memoryNodeArrays[i];
+
+		if(1 == arrayPartitionFactors[arrayID] || !isMemoryOp(microops.at(nodeID)))
+			continue;
+
+		int64_t bank = memoryNodeBanks[i];
+		std::unordered_map<int64_t, std::string>::iterator found = partitionNames[arrayID].find(bank);
+		if(partitionNames[arrayID].end() == found) {
 #ifdef LEGACY_SEPARATOR
-			baseAddress[nodeID] = std::make_pair(label + "-" + std::to_string(finalAddress), address);
+			found = partitionNames[arrayID].insert(std::make_pair(bank, arrayNames[arrayID] + "-" + std::to_string(bank))).first;
 #else
-			baseAddress[nodeID] = std::make_pair(label + GLOBAL_SEPARATOR + std::to_string(finalAddress), address);
+			found = partitionNames[arrayID].insert(std::make_pair(bank, arrayNames[arrayID] + GLOBAL_SEPARATOR + std::to_string(bank))).first;
 #endif
 		}
+
+		baseAddress[nodeID].first = found->second;
 	}
 }
 
 void BaseDatapath::optimiseDDDG() {
-	// NOTE: Test memory disambiguation
-	if(args.fMemDisambuigOpt)
-		performMemoryDisambiguation();
+	RewritePassManager RPM(*this);
 
 	if(!args.fNoSLROpt) {
 		bool activate = args.fSLROpt;
@@ -734,358 +1193,368 @@ void BaseDatapath::optimiseDDDG() {
 		}
 
 		if(activate)
-			removeSharedLoads();
+			removeSharedLoads(RPM);
 	}
 
 	if(args.fRSROpt)
-		removeRepeatedStores();
+		removeRepeatedStores(RPM);
 
 	if(args.fTHRIntOpt)
-		reduceTreeHeight(isAssociative);
+		reduceTreeHeight(RPM, isAssociative, false);
 
+	// Barrier: the number of children of chain nodes may be changed by the integer tree height reduction
 	if(args.fTHRFloatOpt)
-		reduceTreeHeight(isFAssociative);
+		reduceTreeHeight(RPM, isFAssociative, true);
+
+	RPM.run();
 }
 
 void BaseDatapath::performMemoryDisambiguation() {
-	assert(false && "Memory disambiguation is untested for now and was deactivated");
+	DATAPATH_PHASE_SCOPE(phase, "memoryDisambiguation");
 
-	std::unordered_multimap<std::string, std::string> loadStorePairs;
-	std::unordered_set<std::string> pairedStore;
-	const std::vector<std::string> &dynamicMethodID = PC.getFuncList();
-	const std::vector<std::string> &instID = PC.getInstIDList();
-	const std::vector<std::string> &prevBB = PC.getPrevBBList();
+	const std::vector<unsigned> &staticInstIDs = PC.getStaticInstIDList();
+	const std::vector<staticInstTy> &staticInsts = PC.getStaticInstList();
+	const std::unordered_map<int, std::pair<int64_t, unsigned>> &memoryTraceList = PC.getMemoryTraceList();
+	unsigned numOfStaticInsts = staticInsts.size();
 
-	std::vector<Vertex> topologicalSortedNodes;
-	boost::topological_sort(graph, std::back_inserter(topologicalSortedNodes));
+	// Address summary of each static load/store: addresses of consecutive executions differ by a constant stride
+	// (i.e. affine access, resolvable by the HLS dependence analysis) or not (e.g. indirect or data-dependent access)
+	std::vector<uint64_t> numOfExecutions(numOfStaticInsts, 0);
+	std::vector<int64_t> lastAddress(numOfStaticInsts, 0);
+	std::vector<int64_t> stride(numOfStaticInsts, 0);
+	std::vector<bool> isAffine(numOfStaticInsts, true);
 
-	// Nodes with no incoming edges first
-	for(auto vi = topologicalSortedNodes.rbegin(); vi != topologicalSortedNodes.rend(); vi++) {
-		unsigned nodeID = vertexToName[*vi];
-		int microop = microops.at(nodeID);
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
+		if(!isMemoryOp(microops.at(nodeID)))
+			continue;
+
+		std::unordered_map<int, std::pair<int64_t, unsigned>>::const_iterator found = memoryTraceList.find(nodeID);
+		if(memoryTraceList.end() == found)
+			continue;
+
+		unsigned staticID = staticInstIDs.at(nodeID);
+		int64_t address = found->second.first;
+
+		if(1 == numOfExecutions[staticID])
+			stride[staticID] = address - lastAddress[staticID];
+		else if(numOfExecutions[staticID] > 1 && address - lastAddress[staticID] != stride[staticID])
+			isAffine[staticID] = false;
+
+		lastAddress[staticID] = address;
+		numOfExecutions[staticID]++;
+	}
+
+	// Static stores that each static load depends on (i.e. a store->load edge exists between their executions)
+	std::vector<std::vector<unsigned>> pairedStores(numOfStaticInsts);
+	std::vector<bool> isPairedStore(numOfStaticInsts, false);
 
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
 		// Only look for store nodes
-		if(!isStoreOp(microop))
+		if(!isStoreOp(microops.at(nodeID)) || !boost::degree(nameToVertex[nodeID], graph))
 			continue;
 
+		unsigned storeStaticID = staticInstIDs.at(nodeID);
+
 		// Look for subsequent loads
 		OutEdgeIterator outEdgei, outEdgeEnd;
-		for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(*vi, graph); outEdgei != outEdgeEnd; outEdgei++) {
+		for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(nameToVertex[nodeID], graph); outEdgei != outEdgeEnd; outEdgei++) {
 			unsigned childID = vertexToName[boost::target(*outEdgei, graph)];
-			int childMicroop = microops.at(childID);
 
-			if(!isLoadOp(childMicroop))
+			if(!isLoadOp(microops.at(childID)))
 				continue;
 
-			std::string nodeDynamicMethodID = dynamicMethodID.at(nodeID);
-			std::string childDynamicMethodID = dynamicMethodID.at(childID);
+			unsigned loadStaticID = staticInstIDs.at(childID);
 
 			// Ignore if dynamic function names are different (either functions are different or different executions)
-			if(nodeDynamicMethodID.compare(childDynamicMethodID))
+			if(staticInsts.at(storeStaticID).dynamicFunctionID != staticInsts.at(loadStaticID).dynamicFunctionID)
 				continue;
 
-			std::string storeUniqueID = constructUniqueID(nodeDynamicMethodID, instID.at(nodeID), prevBB.at(nodeID));
-			std::string loadUniqueID = constructUniqueID(childDynamicMethodID, instID.at(childID), prevBB.at(childID));
+			pairedStores[loadStaticID].push_back(storeStaticID);
+			isPairedStore[storeStaticID] = true;
+		}
+	}
 
-			// Mark this store as paired
-			pairedStore.insert(storeUniqueID);
+	// A load paired with more than one store is ambiguous with those that are not affine (or with all of them, if the
+	// load itself is not affine). Each execution of such load must wait for the last execution of each ambiguous store
+	uint64_t numOfAmbiguousPairs = 0;
+	std::vector<std::vector<unsigned>> ambiguousStores(numOfStaticInsts);
+	for(unsigned loadStaticID = 0; loadStaticID < numOfStaticInsts; loadStaticID++) {
+		std::vector<unsigned> &stores = pairedStores[loadStaticID];
 
-			// Find in all loads with this ID if any is paired with this store. If not, add it
-			bool storeFound = false;
-			auto loadRange = loadStorePairs.equal_range(loadUniqueID);
-			for(auto it = loadRange.first; it != loadRange.second; it++) {
-				if(!storeUniqueID.compare(it->second)) {
-					storeFound = true;
-					break;
-				}
-			}
-			if(!storeFound)
-				loadStorePairs.insert(std::make_pair(loadUniqueID, storeUniqueID));
+		std::sort(stores.begin(), stores.end());
+		stores.erase(std::unique(stores.begin(), stores.end()), stores.end());
+
+		// If there is only one load-store pair, there is no ambiguity
+		if(stores.size() < 2)
+			continue;
+
+		for(auto &it : stores) {
+			if(isAffine[loadStaticID] && isAffine[it])
+				continue;
+
+			ambiguousStores[loadStaticID].push_back(it);
+			numOfAmbiguousPairs++;
+
+			dynamicMemoryOps.insert(loadStaticID);
+			dynamicMemoryOps.insert(it);
 		}
 	}
 
-	// Return if no pairing happened
-	if(!loadStorePairs.size())
+	PHASE_COUNTER(phase, "ambiguousPairs", numOfAmbiguousPairs);
+
+	// Return if no ambiguity was found
+	if(!numOfAmbiguousPairs)
 		return;
 
-	std::vector<edgeTy> edgesToAdd;
-	std::unordered_map<std::string, unsigned> lastStore;
+	// Last execution of each paired store so far, in trace order (-1 if not executed yet)
+	std::vector<int64_t> lastStore(numOfStaticInsts, -1);
+	edgeDeltaTy delta;
 
 	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
 		int microop = microops.at(nodeID);
 
-		// Only consider loads and stores
-		if(!isMemoryOp(microop))
+		// Only consider active loads and stores
+		if(!isMemoryOp(microop) || !boost::degree(nameToVertex[nodeID], graph))
 			continue;
 
-		std::string uniqueID = constructUniqueID(dynamicMethodID.at(nodeID), instID.at(nodeID), prevBB.at(nodeID));
+		unsigned staticID = staticInstIDs.at(nodeID);
 
-		// Store node
+		// Store node: mark this as the last store so far
 		if(isStoreOp(microop)) {
-			// Ignore non-paired stores
-			if(pairedStore.end() == pairedStore.find(uniqueID))
-				continue;
-
-			// Mark this as the last store so far
-			lastStore[uniqueID] = nodeID;
+			if(isPairedStore[staticID])
+				lastStore[staticID] = nodeID;
 		}
-		// Load node
+		// Load node: create a dependency for each ambiguous load-store pair (existing edges are ignored when applied)
 		else {
-			// If there is only one load-store pair, there is no ambiguity
-			auto loadRange = loadStorePairs.equal_range(uniqueID);
-			if(1 == std::distance(loadRange.first, loadRange.second))
-				continue;
-
-			for(auto it = loadRange.first; it != loadRange.second; it++) {
-				assert(pairedStore.find(it->second) != pairedStore.end() && "Store that was paired not found in pairedStore");
-
-				std::unordered_map<std::string, unsigned>::iterator found = lastStore.find(it->second);
-				if(lastStore.end() == found)
-					continue;
-
-				// Create a dependency for this load-store pair
-				unsigned prevStoreID = found->second;
-				if(!edgeExists(prevStoreID, nodeID)) {
-					// XXX: Perhaps a meaningful name should be given to this type of edge
-					edgesToAdd.push_back({prevStoreID, nodeID, 255});
-					// XXX: This seems quite odd and I have not tested
-					// it->[first|second] is already a unique ID and we are appending one more element to it
-					dynamicMemoryOps.insert(it->second + "-" + prevBB.at(prevStoreID));
-					dynamicMemoryOps.insert(it->first + "-" + prevBB.at(nodeID));
-				}
+			for(auto &it : ambiguousStores[staticID]) {
+				// Same parameter ID as the memory dependencies inserted by DDDGBuilder, so that their latency is assigned
+				// by updateEdgeWeightsWithLatencies()
+				if(lastStore[it] != -1)
+					delta.edgesToAdd.push_back({(unsigned) lastStore[it], nodeID, EDGE_MEMORY});
 			}
 		}
 	}
-	updateAddDDDGEdges(edgesToAdd);
+
+	PHASE_COUNTER(phase, "candidateEdges", delta.edgesToAdd.size());
+
+	applyEdgeDelta(delta);
 }
 
-void BaseDatapath::removeSharedLoads() {
+void BaseDatapath::gatherMemoryOps(std::vector<std::pair<int64_t, unsigned>> &addressNodePairs, bool storesOnly) {
 	const std::unordered_map<int, std::pair<int64_t, unsigned>> &memoryTraceList = PC.getMemoryTraceList();
-	std::set<Edge> edgesToRemove;
-	std::vector<edgeTy> edgesToAdd;
-	std::unordered_map<int64_t, unsigned> loadedAddresses;
-	sharedLoadsRemoved = 0;
-
-	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
-		if(nameToVertex.end() == nameToVertex.find(nodeID))
-			continue;
 
-		if(!boost::degree(nameToVertex[nodeID], graph))
-			continue;
+	addressNodePairs.clear();
 
+	// Active loads and stores, in trace order
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
 		int microop = microops.at(nodeID);
-		if(!isMemoryOp(microop))
+		if(!(storesOnly? isStoreOp(microop) : isMemoryOp(microop)) || !boost::degree(nameToVertex[nodeID], graph))
 			continue;
 
-		// From this point only active store and loads are considered
-
 		std::unordered_map<int, std::pair<int64_t, unsigned>>::const_iterator found = memoryTraceList.find(nodeID);
 		assert(found != memoryTraceList.end() && "Storage operation found with no memory trace element");
-		std::unordered_map<int64_t, unsigned>::iterator found2 = loadedAddresses.find(found->second.first);
-
-		// Address is loaded
-		if(found2 != loadedAddresses.end()) {
-			// If this is store, unload address
-			if(isStoreOp(microop)) {
-				loadedAddresses.erase(found2);
-			}
-			// This is a load. Since address is already loaded, this is a shared load
-			else if(isLoadOp(microop)) {
-				sharedLoadsRemoved++;
-				microops.at(nodeID) = LLVM_IR_Move;
-				unsigned prevLoadID = found2->second;
-
-				// Disconnect this load, and connect its childs to the previous load
-				OutEdgeIterator outEdgei, outEdgeEnd;
-				for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(nameToVertex[nodeID], graph); outEdgei != outEdgeEnd; outEdgei++) {
-					unsigned childID = vertexToName[boost::target(*outEdgei, graph)];
-					if(!edgeExists(prevLoadID, childID))
-						edgesToAdd.push_back({prevLoadID, childID, edgeToWeight[*outEdgei]});
-					edgesToRemove.insert(*outEdgei);
-				}
-				InEdgeIterator inEdgei, inEdgeEnd;
-				for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(nameToVertex[nodeID], graph); inEdgei != inEdgeEnd; inEdgei++)
-					edgesToRemove.insert(*inEdgei);
-			}
-		}
-		// Address is not loaded and this is a load op, mark address as loaded
-		else if(isLoadOp(microop)) {
-			loadedAddresses.insert(std::make_pair(found->second.first, nodeID));
-		}
+		addressNodePairs.push_back(std::make_pair(found->second.first, nodeID));
 	}
 
-	updateRemoveDDDGEdges(edgesToRemove);
-	updateAddDDDGEdges(edgesToAdd);
+	// Accesses to the same address become a contiguous run, still in trace order
+	std::sort(addressNodePairs.begin(), addressNodePairs.end());
 }
 
-void BaseDatapath::removeRepeatedStores() {
-	const std::unordered_map<int, std::pair<int64_t, unsigned>> &memoryTraceList = PC.getMemoryTraceList();
-	const std::vector<std::string> &dynamicMethodID = PC.getFuncList();
-	const std::vector<std::string> &instID = PC.getInstIDList();
-	const std::vector<std::string> &prevBB = PC.getPrevBBList();
-	std::unordered_map<int64_t, unsigned> addressStoreMap;
-	repeatedStoresRemoved = 0;
+void BaseDatapath::removeSharedLoads(RewritePassManager &RPM) {
+	sharedLoadsRemoved = 0;
 
-	for(unsigned nodeID = numOfTotalNodes - 1; nodeID + 1; nodeID--) {
-		if(nameToVertex.end() == nameToVertex.find(nodeID))
-			continue;
+	RPM.addBulkPass("removeSharedLoads", [this](edgeDeltaTy &delta) {
+		std::vector<std::pair<int64_t, unsigned>> addressNodePairs;
+		gatherMemoryOps(addressNodePairs, false);
+
+		// Within each address run, a load following another load with no store in between is a shared load. Pairs of
+		// (shared load, previous load)
+		std::vector<std::pair<unsigned, unsigned>> sharedLoads;
+		for(unsigned i = 0; i < addressNodePairs.size(); ) {
+			int64_t address = addressNodePairs[i].first;
+			int64_t loadedBy = -1;
+
+			for(; i < addressNodePairs.size() && address == addressNodePairs[i].first; i++) {
+				unsigned nodeID = addressNodePairs[i].second;
+
+				// If this is store, unload address
+				if(isStoreOp(microops.at(nodeID)))
+					loadedBy = -1;
+				// Address is not loaded, mark address as loaded
+				else if(-1 == loadedBy)
+					loadedBy = nodeID;
+				// Address is already loaded, this is a shared load
+				else
+					sharedLoads.push_back(std::make_pair(nodeID, (unsigned) loadedBy));
+			}
+		}
 
-		if(!boost::degree(nameToVertex[nodeID], graph))
-			continue;
+		// Edges are edited in trace order
+		std::sort(sharedLoads.begin(), sharedLoads.end());
 
-		if(!isStoreOp(microops.at(nodeID)))
-			continue;
+		for(auto &it : sharedLoads) {
+			unsigned nodeID = it.first;
+			unsigned prevLoadID = it.second;
 
-		// From this point only active stores are considered
+			sharedLoadsRemoved++;
+			microops.at(nodeID) = LLVM_IR_Move;
 
-		int64_t nodeAddress = memoryTraceList.at(nodeID).first;
-		std::unordered_map<int64_t, unsigned>::iterator found = addressStoreMap.find(nodeAddress);
-		// This is the first time a store to this address is found, so we save it
-		if(addressStoreMap.end() == found) {
-			addressStoreMap[nodeAddress] = nodeID;
+			// Disconnect this load, and connect its childs to the previous load
+			OutEdgeIterator outEdgei, outEdgeEnd;
+			for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(nameToVertex[nodeID], graph); outEdgei != outEdgeEnd; outEdgei++) {
+				unsigned childID = vertexToName[boost::target(*outEdgei, graph)];
+				if(!edgeExists(prevLoadID, childID))
+					delta.edgesToAdd.push_back({prevLoadID, childID, edgeToWeight[*outEdgei]});
+				delta.edgesToRemove.push_back(*outEdgei);
+			}
+			InEdgeIterator inEdgei, inEdgeEnd;
+			for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(nameToVertex[nodeID], graph); inEdgei != inEdgeEnd; inEdgei++)
+				delta.edgesToRemove.push_back(*inEdgei);
 		}
-		// This is not the first time a store is found to this address
-		else {
-			std::string storeUniqueID = constructUniqueID(dynamicMethodID.at(nodeID), instID.at(nodeID), prevBB.at(nodeID));
+	});
+}
+
+void BaseDatapath::removeRepeatedStores(RewritePassManager &RPM) {
+	const std::vector<unsigned> *staticInstIDs = &(PC.getStaticInstIDList());
+	repeatedStoresRemoved = 0;
+
+	// Only microops are changed
+	RPM.addBulkPass("removeRepeatedStores", [this, staticInstIDs](edgeDeltaTy &delta) {
+		std::vector<std::pair<int64_t, unsigned>> addressNodePairs;
+		gatherMemoryOps(addressNodePairs, true);
+
+		for(unsigned i = 0; i < addressNodePairs.size(); i++) {
+			// The last store to each address is kept (i.e. the last element of each run)
+			if(i + 1 == addressNodePairs.size() || addressNodePairs[i + 1].first != addressNodePairs[i].first)
+				continue;
+
+			unsigned nodeID = addressNodePairs[i].second;
 
 			// If there is no ambiguity related to this store, we convert it to a silent store
-			if(dynamicMemoryOps.end() == dynamicMemoryOps.find(storeUniqueID) && !boost::out_degree(nameToVertex[nodeID], graph)) {
+			if(dynamicMemoryOps.end() == dynamicMemoryOps.find(staticInstIDs->at(nodeID)) && !boost::out_degree(nameToVertex[nodeID], graph)) {
 				microops.at(nodeID) = LLVM_IR_SilentStore;
 				repeatedStoresRemoved++;
 			}
 		}
-	}
+	});
 }
 
-void BaseDatapath::reduceTreeHeight(bool (&isAssociativeFunc)(unsigned)) {
-	std::vector<bool> visited(numOfTotalNodes, false);
-	std::set<Edge> edgesToRemove;
-	std::vector<edgeTy> edgesToAdd;
+void BaseDatapath::reduceTreeHeight(RewritePassManager &RPM, bool (&isAssociativeFunc)(unsigned), bool barrier) {
+	bool (*isAssociativePtr)(unsigned) = &isAssociativeFunc;
+	std::shared_ptr<std::vector<bool>> visited = std::make_shared<std::vector<bool>>(numOfTotalNodes, false);
 
-	for(unsigned int nodeID = numOfTotalNodes - 1; nodeID + 1; nodeID--) {
-		if(nameToVertex.end() == nameToVertex.find(nodeID) || !boost::degree(nameToVertex[nodeID], graph))
-			continue;
+	RPM.addPass("treeHeightReduction", RewritePassManager::ORDER_DESCENDING, barrier, [this, isAssociativePtr, visited](unsigned nodeID, edgeDeltaTy &delta) {
+		if(nodeID >= nameToVertex.size() || !boost::degree(nameToVertex[nodeID], graph))
+			return;
 
-		if(visited.at(nodeID) || !isAssociativeFunc(microops.at(nodeID)))
-			continue;
+		if(visited->at(nodeID) || !isAssociativePtr(microops.at(nodeID)))
+			return;
 
-		visited.at(nodeID) = true;
+		visited->at(nodeID) = true;
 
-		std::list<unsigned> nodes;
+		// Nodes of the tree (chain nodes with two parents) in the order they are found, i.e. from root to leaves
+		std::vector<unsigned> nodes;
 		std::vector<Edge> edgesToRemoveTmp;
-		std::vector<std::pair<unsigned, bool>> leaves;
+		std::vector<unsigned> leaves;
 		std::vector<unsigned> associativeChain;
+		std::vector<Edge> chainInEdges;
 
+		// The tree is found walking up from its root (this node), in-edges of each chain node are traversed only once
 		associativeChain.push_back(nodeID);
 		for(unsigned i = 0; i < associativeChain.size(); i++) {
 			unsigned chainNodeID = associativeChain.at(i);
 			int chainNodeMicroop = microops.at(chainNodeID);
 
-			if(isAssociativeFunc(chainNodeMicroop)) {
-				visited.at(chainNodeID) = true;
-				unsigned numOfChainParents = 0;
-
-				InEdgeIterator inEdgei, inEdgeEnd;
-				for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(nameToVertex[chainNodeID], graph); inEdgei != inEdgeEnd; inEdgei++) {
-					unsigned parentID = vertexToName[boost::source(*inEdgei, graph)];
-
-					if(isBranchOp(microops.at(parentID)))
-						continue;
+			if(!isAssociativePtr(chainNodeMicroop)) {
+				leaves.push_back(chainNodeID);
+				continue;
+			}
 
-					numOfChainParents++;
-				}
+			visited->at(chainNodeID) = true;
 
-				if(2 == numOfChainParents) {
-					nodes.push_front(chainNodeID);
+			chainInEdges.clear();
+			InEdgeIterator inEdgei, inEdgeEnd;
+			for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(nameToVertex[chainNodeID], graph); inEdgei != inEdgeEnd; inEdgei++) {
+				if(!isBranchOp(microops.at(vertexToName[boost::source(*inEdgei, graph)])))
+					chainInEdges.push_back(*inEdgei);
+			}
 
-					for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(nameToVertex[chainNodeID], graph); inEdgei != inEdgeEnd; inEdgei++) {
-						Vertex parentNode = boost::source(*inEdgei, graph);
-						unsigned parentID = vertexToName[parentNode];
-						assert(parentID < chainNodeID && "Parent node has larger ID than its child");
+			if(chainInEdges.size() != 2) {
+				leaves.push_back(chainNodeID);
+				continue;
+			}
 
-						int parentMicroop = microops.at(parentID);
+			nodes.push_back(chainNodeID);
 
-						if(isBranchOp(parentMicroop))
-							continue;
+			for(auto &it : chainInEdges) {
+				Vertex parentNode = boost::source(it, graph);
+				unsigned parentID = vertexToName[parentNode];
+				assert(parentID < chainNodeID && "Parent node has larger ID than its child");
 
-						edgesToRemoveTmp.push_back(*inEdgei);
+				int parentMicroop = microops.at(parentID);
 
-						visited.at(parentID) = true;
+				edgesToRemoveTmp.push_back(it);
 
-						if(!isAssociativeFunc(parentMicroop)) {
-							leaves.push_back(std::make_pair(parentID, false));
-						}
-						else {
-							int numOfChildren = 0;
-							OutEdgeIterator outEdgei, outEdgeEnd;
-							for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(parentNode, graph); outEdgei != outEdgeEnd; outEdgei++) {
-								if(edgeToWeight[*outEdgei] != BaseDatapath::EDGE_CONTROL)
-									numOfChildren++;
-							}
+				visited->at(parentID) = true;
 
-							if(1 == numOfChildren)
-								associativeChain.push_back(parentID);
-							else
-								leaves.push_back(std::make_pair(parentID, false));
-						}
-					}
+				if(!isAssociativePtr(parentMicroop)) {
+					leaves.push_back(parentID);
 				}
 				else {
-					leaves.push_back(std::make_pair(chainNodeID, false));
+					int numOfChildren = 0;
+					OutEdgeIterator outEdgei, outEdgeEnd;
+					for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(parentNode, graph); outEdgei != outEdgeEnd; outEdgei++) {
+						if(edgeToWeight[*outEdgei] != BaseDatapath::EDGE_CONTROL)
+							numOfChildren++;
+					}
+
+					if(1 == numOfChildren)
+						associativeChain.push_back(parentID);
+					else
+						leaves.push_back(parentID);
 				}
 			}
-			else {
-				leaves.push_back(std::make_pair(chainNodeID, false));
-			}
 		}
 
 		if(nodes.size() < 3)
-			continue;
-
-		for(auto &it : edgesToRemoveTmp)
-			edgesToRemove.insert(it);
-
-		std::map<unsigned, unsigned> rankMap;
+			return;
 
+		// Candidates to be paired, ordered by (rank, node ID). Leaves have rank 0
+		std::set<std::pair<unsigned, unsigned>> rankSet;
 		for(auto &it : leaves)
-			rankMap[it.first] = (it.second)? numOfTotalNodes : 0;
+			rankSet.insert(std::make_pair(0, it));
 
-		for(auto &it : nodes) {
-			std::pair<unsigned, unsigned> nodePair;
+		// XXX: A leaf reached through more than one edge (e.g. x + x) would leave the tree with fewer leaves than
+		// operands. Such trees are kept as they are
+		if(rankSet.size() != nodes.size() + 1)
+			return;
 
-			if(2 == rankMap.size()) {
-				nodePair.first = rankMap.begin()->first;
-				nodePair.second = (++(rankMap.begin()))->first;
-			}
-			else {
-				findMinimumRankPair(nodePair, rankMap);
-			}
+		delta.edgesToRemove.insert(delta.edgesToRemove.end(), edgesToRemoveTmp.begin(), edgesToRemoveTmp.end());
 
-			assert(nodePair.first != numOfTotalNodes && nodePair.second != numOfTotalNodes);
+		// The balanced tree is rebuilt from the leaves, each node takes the two candidates with smallest rank. Nodes
+		// closer to the leaves are rebuilt first (i.e. reverse order of discovery)
+		for(std::vector<unsigned>::reverse_iterator it = nodes.rbegin(); it != nodes.rend(); it++) {
+			std::pair<unsigned, unsigned> first = *(rankSet.begin());
+			rankSet.erase(rankSet.begin());
+			std::pair<unsigned, unsigned> second = *(rankSet.begin());
+			rankSet.erase(rankSet.begin());
+
+			// When only two candidates are left, they are connected in node ID order
+			if(rankSet.empty() && second.second < first.second)
+				std::swap(first, second);
 
 			// TODO: maybe a meaningful weight here?
-			edgesToAdd.push_back({nodePair.first, it, 1});
-			edgesToAdd.push_back({nodePair.second, it, 1});
+			delta.edgesToAdd.push_back({first.second, *it, 1});
+			delta.edgesToAdd.push_back({second.second, *it, 1});
 
-			rankMap[it] = std::max(rankMap[nodePair.first], rankMap[nodePair.second]) + 1;
-			rankMap.erase(nodePair.first);
-			rankMap.erase(nodePair.second);
+			rankSet.insert(std::make_pair(std::max(first.first, second.first) + 1, *it));
 		}
-	}
-
-	updateRemoveDDDGEdges(edgesToRemove);
-	updateAddDDDGEdges(edgesToAdd);
-}
-
-std::string BaseDatapath::constructUniqueID(std::string funcID, std::string instID, std::string bbID) {
-#ifdef LEGACY_SEPARATOR
-	return funcID + "-" + instID + "-" + bbID;
-#else
-	return funcID + GLOBAL_SEPARATOR + instID + GLOBAL_SEPARATOR + bbID;
-#endif
+	});
 }
 
 std::tuple<uint64_t, uint64_t> BaseDatapath::asapScheduling() {
+	DATAPATH_PHASE_SCOPE(phase, "asapScheduling");
+
 	VERBOSE_PRINT(errs() << "\t\tASAP scheduling started\n");
 
 	uint64_t maxCycles = 0, maxScheduledTime = 0;
@@ -1093,50 +1562,50 @@ std::tuple<uint64_t, uint64_t> BaseDatapath::asapScheduling() {
 	asapScheduledTime.assign(numOfTotalNodes, 0);
 
 	std::map<uint64_t, std::vector<unsigned>> maxTimesNodesMap;
-#ifdef CHECK_VISITED_NODES
-	std::set<unsigned> visitedNodes;
-#endif
-
-	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
-		Vertex currNode = nameToVertex[nodeID];
-
-		// Set scheduled time to 0 to root nodes
-		if(!boost::in_degree(currNode, graph)) {
-			asapScheduledTime[currNode] = 0;
-#ifdef CHECK_VISITED_NODES
-			visitedNodes.insert(nodeID);
-#endif
-			continue;
-		}
-
-		unsigned maxCurrStartTime = 0;
-		InEdgeIterator inEdgei, inEdgeEnd;
-		// Evaluate all incoming edges. Save the largest incoming time considering scheduled time of parents + the edge weight
-		for(std::tie(inEdgei, inEdgeEnd) = boost::in_edges(currNode, graph); inEdgei != inEdgeEnd; inEdgei++) {
-			unsigned parentNodeID = vertexToName[boost::source(*inEdgei, graph)];
-			unsigned parentOpcode = microops.at(parentNodeID);
-#ifdef CHECK_VISITED_NODES
-			assert(visitedNodes.find(parentNodeID) != visitedNodes.end() && "Node was not yet visited!");
-#endif
 
-			// Inherit dependability from parents
-			inheritLoadDepMap(nodeID, parentNodeID);
-			inheritStoreDepMap(nodeID, parentNodeID);
-			// If parent operation is a header for memory access operation, save this information
-			if(LLVM_IR_Load == parentOpcode) addToLoadDepMap(nodeID, parentNodeID);
-			if(LLVM_IR_Store == parentOpcode) addToStoreDepMap(nodeID, parentNodeID);
+	buildTopologicalCache();
+	loadDeps.init(LLVM_IR_Load, microops, levelNodes, inEdgeOffsets, inEdgeSources);
+	storeDeps.init(LLVM_IR_Store, microops, levelNodes, inEdgeOffsets, inEdgeSources);
+
+	// Edge weights are gathered contiguously, since they change with the hardware profile
+	std::vector<uint8_t> inEdgeWeights(inEdges.size());
+	runInParallel(0, inEdges.size(), [this, &inEdgeWeights](unsigned from, unsigned to) {
+		for(unsigned i = from; i < to; i++)
+			inEdgeWeights[i] = boost::get(edgeToWeight, inEdges[i]);
+	});
+
+	// Nodes of the same level are independent, thus each level is processed in parallel. Root nodes are kept at 0
+	for(unsigned level = 1; level + 1 < levelOffsets.size(); level++) {
+		runInParallel(levelOffsets[level], levelOffsets[level + 1], [this, &inEdgeWeights](unsigned from, unsigned to) {
+			for(unsigned i = from; i < to; i++) {
+				unsigned nodeID = levelNodes[i];
+
+				// Largest incoming time considering scheduled time of parents + the edge weight
+				uint64_t maxCurrStartTime = 0;
+				for(unsigned j = inEdgeOffsets[nodeID]; j < inEdgeOffsets[nodeID + 1]; j++) {
+					uint64_t currNodeStartTime = asapScheduledTime[inEdgeSources[j]] + inEdgeWeights[j];
+					if(currNodeStartTime > maxCurrStartTime)
+						maxCurrStartTime = currNodeStartTime;
+				}
+				asapScheduledTime[nodeID] = maxCurrStartTime;
+			}
+		});
+	}
 
-			unsigned currNodeStartTime = asapScheduledTime[parentNodeID] + edgeToWeight[*inEdgei];
-			if(currNodeStartTime > maxCurrStartTime)
-				maxCurrStartTime = currNodeStartTime;
+	for(auto &nodeID : levelNodes) {
+		// Inherit dependability from parents (a load/store parent is part of its own component)
+		for(unsigned i = inEdgeOffsets[nodeID]; i < inEdgeOffsets[nodeID + 1]; i++) {
+			loadDeps.inherit(nodeID, inEdgeSources[i]);
+			storeDeps.inherit(nodeID, inEdgeSources[i]);
 		}
-		asapScheduledTime[nodeID] = maxCurrStartTime;
-#ifdef CHECK_VISITED_NODES
-		visitedNodes.insert(nodeID);
-#endif
+		loadDeps.finalise(nodeID, microops.at(nodeID));
+		storeDeps.finalise(nodeID, microops.at(nodeID));
 
-		maxTimesNodesMap[maxCurrStartTime].push_back(nodeID);
+		if(inEdgeOffsets[nodeID + 1] > inEdgeOffsets[nodeID])
+			maxTimesNodesMap[asapScheduledTime[nodeID]].push_back(nodeID);
 	}
+	loadDeps.release();
+	storeDeps.release();
 
 	// Find the path with the maximum scheduled time
 	std::vector<uint64_t>::iterator found = std::max_element(asapScheduledTime.begin(), asapScheduledTime.end());
@@ -1164,47 +1633,45 @@ std::tuple<uint64_t, uint64_t> BaseDatapath::asapScheduling() {
 }
 
 void BaseDatapath::alapScheduling(std::tuple<uint64_t, uint64_t> asapResult) {
+	DATAPATH_PHASE_SCOPE(phase, "alapScheduling");
+
 	VERBOSE_PRINT(errs() << "\t\tALAP scheduling started\n");
 
 	alapScheduledTime.assign(numOfTotalNodes, 0);
 
 	std::map<uint64_t, std::set<unsigned>> minTimesNodesMap;
-#ifdef CHECK_VISITED_NODES
-	std::set<unsigned> visitedNodes;
-#endif
-
-	// nodeID is incremented by 1 here, so that we can use unsigned (otherwise exit condition would be i < 0)
-	for(unsigned nodeID = numOfTotalNodes - 1; nodeID + 1; nodeID--) {
-		Vertex currNode = nameToVertex[nodeID];
-
-		// Set scheduled time to maximum time from ASAP to leaf nodes
-		if(!boost::out_degree(currNode, graph)) {
-			alapScheduledTime[nodeID] = std::get<1>(asapResult);
-#ifdef CHECK_VISITED_NODES
-			visitedNodes.insert(nodeID);
-#endif
-			continue;
-		}
 
-		// Initialise minimum time with the result of ASAP
-		unsigned minCurrStartTime = std::get<1>(asapResult);
-		OutEdgeIterator outEdgei, outEdgeEnd;
-		// Evaluate all outcoming edges. Save the smallest outcoming time considering scheduled time of childs - the edge weight
-		for(std::tie(outEdgei, outEdgeEnd) = boost::out_edges(currNode, graph); outEdgei != outEdgeEnd; outEdgei++) {
-			unsigned childNodeID = vertexToName[boost::target(*outEdgei, graph)];
-#ifdef CHECK_VISITED_NODES
-			assert(visitedNodes.find(childNodeID) != visitedNodes.end() && "Node was not yet visited!");
-#endif
-			unsigned currNodeStartTime = alapScheduledTime[childNodeID] - edgeToWeight[*outEdgei];
-			if(currNodeStartTime < minCurrStartTime)
-				minCurrStartTime = currNodeStartTime;
-		}
-		alapScheduledTime[nodeID] = minCurrStartTime;
-#ifdef CHECK_VISITED_NODES
-		visitedNodes.insert(nodeID);
-#endif
+	buildTopologicalCache();
+
+	std::vector<uint8_t> outEdgeWeights(outEdges.size());
+	runInParallel(0, outEdges.size(), [this, &outEdgeWeights](unsigned from, unsigned to) {
+		for(unsigned i = from; i < to; i++)
+			outEdgeWeights[i] = boost::get(edgeToWeight, outEdges[i]);
+	});
+
+	// Levels are processed from the deepest to the shallowest, each level in parallel. Leaf nodes are set to the
+	// maximum time from ASAP
+	uint64_t maxScheduledTime = std::get<1>(asapResult);
+	for(unsigned level = levelOffsets.size() - 1; level; level--) {
+		runInParallel(levelOffsets[level - 1], levelOffsets[level], [this, &outEdgeWeights, maxScheduledTime](unsigned from, unsigned to) {
+			for(unsigned i = from; i < to; i++) {
+				unsigned nodeID = levelNodes[i];
+
+				// Smallest outcoming time considering scheduled time of childs - the edge weight
+				unsigned minCurrStartTime = maxScheduledTime;
+				for(unsigned j = outEdgeOffsets[nodeID]; j < outEdgeOffsets[nodeID + 1]; j++) {
+					unsigned currNodeStartTime = alapScheduledTime[outEdgeTargets[j]] - outEdgeWeights[j];
+					if(currNodeStartTime < minCurrStartTime)
+						minCurrStartTime = currNodeStartTime;
+				}
+				alapScheduledTime[nodeID] = minCurrStartTime;
+			}
+		});
+	}
 
-		minTimesNodesMap[minCurrStartTime].insert(nodeID);
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
+		if(outEdgeOffsets[nodeID + 1] > outEdgeOffsets[nodeID])
+			minTimesNodesMap[alapScheduledTime[nodeID]].insert(nodeID);
 	}
 
 	// Calculate required resources for current scheduling, without imposing any restrictions
@@ -1262,23 +1729,45 @@ void BaseDatapath::identifyCriticalPaths() {
 	}
 }
 
-std::pair<uint64_t, double> BaseDatapath::rcScheduling() {
-	VERBOSE_PRINT(errs() << "\t\tResource-constrained scheduling started\n");
-
+void BaseDatapath::prepareRCScheduling() {
 	assert(asapScheduledTime.size() && alapScheduledTime.size() && cPathNodes.size() && "ASAP, ALAP and/or critical path list not generated");
 
-	// initScratchpadPartitions() generated more stuff that we do not use in Lina. Thus it was reduced to process only what we need
-	VERBOSE_PRINT(errs() << "\t\tUpdating base address database\n");
-	initScratchpadPartitions();
+	// Partition assignment overwrites the base addresses, they are saved so that other partitionings can be assigned later
+	unpartitionedBaseAddress = baseAddress;
+
+	// XXX: The DDDG optimisations do not depend on base addresses, thus they are performed only once before partition assignment
 	VERBOSE_PRINT(errs() << "\t\tOptimising DDDG\n");
 	optimiseDDDG();
 
 	if(args.showPostOptDDDG)
 		dumpGraph(true);
 
+	// constrainHardware() consumes the unconstrained resources calculated during ALAP. The profile is saved before that
+	if(unconstrainedProfile)
+		delete unconstrainedProfile;
+	unconstrainedProfile = profile->clone();
+}
+
+std::pair<uint64_t, double> BaseDatapath::rcScheduling(
+	const ConfigurationManager::partitionCfgMapTy &partitionCfgMap,
+	const ConfigurationManager::partitionCfgMapTy &completePartitionCfgMap
+) {
+	DATAPATH_PHASE_SCOPE(phase, "rcScheduling");
+
+	VERBOSE_PRINT(errs() << "\t\tResource-constrained scheduling started\n");
+
+	assert(unconstrainedProfile && "DDDG not prepared for resource-constrained scheduling (forgot to call prepareRCScheduling()?)");
+
+	// initScratchpadPartitions() generated more stuff that we do not use in Lina. Thus it was reduced to process only what we need
+	VERBOSE_PRINT(errs() << "\t\tUpdating base address database\n");
+	baseAddress = unpartitionedBaseAddress;
+	initScratchpadPartitions(partitionCfgMap);
+
 	rcScheduledTime.assign(numOfTotalNodes, 0);
 
-	profile->constrainHardware(CM.getArrayInfoCfgMap(), CM.getPartitionCfgMap(), CM.getCompletePartitionCfgMap());
+	delete profile;
+	profile = unconstrainedProfile->clone();
+	profile->constrainHardware(CM.getArrayInfoCfgMap(), partitionCfgMap, completePartitionCfgMap);
 
 	RCScheduler rcSched(
 		loopName, loopLevel, datapathType,
@@ -1291,7 +1780,29 @@ std::pair<uint64_t, double> BaseDatapath::rcScheduling() {
 	return rcPair;
 }
 
+std::tuple<uint64_t, uint64_t, uint64_t> BaseDatapath::moduloScheduling() {
+	DATAPATH_PHASE_SCOPE(phase, "moduloScheduling");
+
+	VERBOSE_PRINT(errs() << "\t\tModulo scheduling started\n");
+
+	// Resources allocated by the resource-constrained scheduler are used to build the modulo reservation tables,
+	// thus rcScheduling() must be executed first
+	ModuloScheduler moduloSched(
+		microops, graph, numOfTotalNodes, nameToVertex, vertexToName, edgeToWeight,
+		*profile, baseAddress, loopCarriedEdges
+	);
+	std::tuple<uint64_t, uint64_t> msResult = moduloSched.schedule();
+
+	VERBOSE_PRINT(errs() << "\t\tResMII: " << std::to_string(moduloSched.getResMII()) << " constrained by: " << moduloSched.getResMIIName() << "\n");
+	VERBOSE_PRINT(errs() << "\t\tRecMII: " << std::to_string(moduloSched.getRecMII()) << "\n");
+	VERBOSE_PRINT(errs() << "\t\tModulo scheduling finished\n");
+
+	return std::make_tuple(std::get<0>(msResult), std::get<1>(msResult), moduloSched.getRecMII());
+}
+
 std::tuple<std::string, uint64_t> BaseDatapath::calculateResIIMem() {
+	DATAPATH_PHASE_SCOPE(phase, "resIIMem");
+
 	// New calculation of ResIIMem is based on two new values:
 	// - ResIIMemPort: port-related minimum II constraint
 	// - ResIIMemRec: minimum II constrained by memory interface recurrence
@@ -1330,49 +1841,43 @@ std::tuple<std::string, uint64_t> BaseDatapath::calculateResIIMemPort() {
 		}
 	}
 
-	std::map<uint64_t, std::vector<unsigned>> rcToNodes;
-	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
-		if(!boost::degree(nameToVertex[nodeID], graph))
-			continue;
-
-		rcToNodes[rcScheduledTime[nodeID]].push_back(nodeID);
-	}
-
-	// XXX: Without calculating the load/store distances, we could
-	// transform this loop to something simpler and remove the previous loop
-	for(auto &it : rcToNodes) {
-		//uint64_t currentSched = it.first;
+	// Reads and writes are counted per (array ID, bank) pair straight from the memory node lists (see
+	// initScratchpadPartitions()). Partition names are only looked up once per pair
+	std::vector<std::unordered_map<int64_t, std::pair<uint64_t, uint64_t>>> bankAccesses(arrayNames.size());
+	// -1: not resolved yet, 0: complete partitioning (not analysed), 1: analysed
+	std::vector<int> arrayAnalysed(arrayNames.size(), -1);
+	for(unsigned i = 0; i < memoryNodes.size(); i++) {
+		unsigned nodeID = memoryNodes[i];
+		unsigned opcode = microops.at(nodeID);
 
-		for(auto &it2 : it.second) {
-			unsigned opcode = microops.at(it2);
-
-			if(!(isMemoryOp(opcode)))
-				continue;
+		if(!(isMemoryOp(opcode)) || !boost::degree(nameToVertex[nodeID], graph))
+			continue;
 
-			// From this point only loads and stores are considered (including offchip!)
+		// From this point only loads and stores are considered (including offchip!)
 
-			std::string partitionName = baseAddress.at(it2).first;
-#ifdef LEGACY_SEPARATOR
-			std::string arrayName = partitionName.substr(0, partitionName.find("-"));
-#else
-			std::string arrayName = partitionName.substr(0, partitionName.find(GLOBAL_SEPARATOR));
-#endif
+		unsigned arrayID = memoryNodeArrays[i];
+		if(-1 == arrayAnalysed[arrayID])
+			arrayAnalysed[arrayID] = std::get<0>(arrayConfig.at(arrayNames[arrayID]))? 1 : 0;
 
-			if(isLoadOp(opcode)) {
-				// Complete partitioning, no need to analyse
-				if(!(std::get<0>(arrayConfig.at(arrayName))))
-					continue;
+		// Complete partitioning, no need to analyse
+		if(!(arrayAnalysed[arrayID]))
+			continue;
 
-				arrayPartitionToNumOfReads[partitionName]++;
-			}
+		std::pair<uint64_t, uint64_t> &accesses = bankAccesses[arrayID][memoryNodeBanks[i]];
+		if(isLoadOp(opcode))
+			accesses.first++;
+		if(isStoreOp(opcode))
+			accesses.second++;
+	}
 
-			if(isStoreOp(opcode)) {
-				// Complete partitioning, no need to analyse
-				if(!(std::get<0>(arrayConfig.at(arrayName))))
-					continue;
+	for(unsigned arrayID = 0; arrayID < bankAccesses.size(); arrayID++) {
+		for(auto &it : bankAccesses[arrayID]) {
+			const std::string &partitionName = (1 == arrayPartitionFactors[arrayID])? arrayNames[arrayID] : partitionNames[arrayID].at(it.first);
 
-				arrayPartitionToNumOfWrites[partitionName]++;
-			}
+			if(it.second.first)
+				arrayPartitionToNumOfReads[partitionName] += it.second.first;
+			if(it.second.second)
+				arrayPartitionToNumOfWrites[partitionName] += it.second.second;
 		}
 	}
 
@@ -1415,18 +1920,6 @@ std::tuple<std::string, uint64_t> BaseDatapath::calculateResIIMemRec() {
 
 	// Logic for local memory
 
-	std::set<unsigned> visited;
-	std::set<unsigned> toVisit;
-	std::function<void(const unsigned &, std::set<unsigned> &, std::unordered_map<unsigned, std::set<unsigned>> &)> recursiveBlock;
-	recursiveBlock = [&recursiveBlock, &visited](const unsigned &v, std::set<unsigned> &connected, std::unordered_map<unsigned, std::set<unsigned>> &depMap) {
-		visited.insert(v);
-		connected.insert(v);
-
-		for(auto &it : depMap.at(v)) {
-			if(!(visited.count(it)))
-				recursiveBlock(it, connected, depMap);
-		}
-	};
 	// Using this struct instead of a normal pair in the map customises the default initialiser
 	struct minMaxPair {
 		std::pair<uint64_t, uint64_t> value = std::make_pair(std::numeric_limits<uint64_t>::max(), 0);
@@ -1440,43 +1933,30 @@ std::tuple<std::string, uint64_t> BaseDatapath::calculateResIIMemRec() {
 	std::vector<std::pair<std::string, uint64_t>> loadMaxs;
 	std::unordered_map<std::string, uint64_t> connectedLoadGraphs;
 
-	// Consider only loads (and make them symmetric to facilitate calculation)
-	for(auto &it : loadDepMap) {
-		if(microops.at(it.first) != LLVM_IR_Load)
-			continue;
-
-		toVisit.insert(it.first);
-
-		for(auto &it2 : it.second)
-			loadDepMap[it2].insert(it.first);
-	}
-
-	for(auto &it : toVisit) {
-		if(!(visited.count(it))) {
-			std::set<unsigned> connected;
-			recursiveBlock(it, connected, loadDepMap);
-			std::set<std::string> consideredInterfaces;
-
-			// Find smallest and largest allocation value for each memory interface
-			// (if banking is disabled, all global loads share the same interface)
-			std::unordered_map<std::string, minMaxPair> minMaxPerInterface;
-			for(auto &it2 : connected) {
-				std::string arrayPartitionName = baseAddress.at(it2).first;
-				if(rcScheduledTime[it2] < minMaxPerInterface[arrayPartitionName].value.first)
-					minMaxPerInterface[arrayPartitionName].value.first = rcScheduledTime[it2];
-				if(rcScheduledTime[it2] > minMaxPerInterface[arrayPartitionName].value.second)
-					minMaxPerInterface[arrayPartitionName].value.second = rcScheduledTime[it2];
-
-				if(!(consideredInterfaces.count(arrayPartitionName))) {
-					consideredInterfaces.insert(arrayPartitionName);
-					(connectedLoadGraphs[arrayPartitionName])++;
-				}
+	// Each component is a set of loads connected by dependencies
+	for(auto &it : loadDeps.getComponents(microops)) {
+		std::vector<unsigned> &connected = it;
+		std::set<std::string> consideredInterfaces;
+
+		// Find smallest and largest allocation value for each memory interface
+		// (if banking is disabled, all global loads share the same interface)
+		std::unordered_map<std::string, minMaxPair> minMaxPerInterface;
+		for(auto &it2 : connected) {
+			std::string arrayPartitionName = baseAddress.at(it2).first;
+			if(rcScheduledTime[it2] < minMaxPerInterface[arrayPartitionName].value.first)
+				minMaxPerInterface[arrayPartitionName].value.first = rcScheduledTime[it2];
+			if(rcScheduledTime[it2] > minMaxPerInterface[arrayPartitionName].value.second)
+				minMaxPerInterface[arrayPartitionName].value.second = rcScheduledTime[it2];
+
+			if(!(consideredInterfaces.count(arrayPartitionName))) {
+				consideredInterfaces.insert(arrayPartitionName);
+				(connectedLoadGraphs[arrayPartitionName])++;
 			}
-
-			// Save all distances to the load max vector
-			for(auto &it2 : minMaxPerInterface)
-				loadMaxs.push_back(std::make_pair(it2.first, it2.second.distance()));
 		}
+
+		// Save all distances to the load max vector
+		for(auto &it2 : minMaxPerInterface)
+			loadMaxs.push_back(std::make_pair(it2.first, it2.second.distance()));
 	}
 #endif
 
@@ -1485,46 +1965,30 @@ std::tuple<std::string, uint64_t> BaseDatapath::calculateResIIMemRec() {
 	std::vector<std::pair<std::string, uint64_t>> storeMaxs;
 	std::unordered_map<std::string, uint64_t> connectedStoreGraphs;
 
-	visited.clear();
-	toVisit.clear();
-
-	// Consider only stores (and make them symmetric to facilitate calculation)
-	for(auto &it : storeDepMap) {
-		if(microops.at(it.first) != LLVM_IR_Store)
-			continue;
-
-		toVisit.insert(it.first);
-
-		for(auto &it2 : it.second)
-			storeDepMap[it2].insert(it.first);
-	}
-
-	for(auto &it : toVisit) {
-		if(!(visited.count(it))) {
-			std::set<unsigned> connected;
-			recursiveBlock(it, connected, storeDepMap);
-			std::set<std::string> consideredInterfaces;
-
-			// Find smallest and largest allocation value for each memory interface
-			// (if banking is disabled, all global stores share the same interface)
-			std::unordered_map<std::string, minMaxPair> minMaxPerInterface;
-			for(auto &it2 : connected) {
-				std::string arrayPartitionName = baseAddress.at(it2).first;
-				if(rcScheduledTime[it2] < minMaxPerInterface[arrayPartitionName].value.first)
-					minMaxPerInterface[arrayPartitionName].value.first = rcScheduledTime[it2];
-				if(rcScheduledTime[it2] > minMaxPerInterface[arrayPartitionName].value.second)
-					minMaxPerInterface[arrayPartitionName].value.second = rcScheduledTime[it2];
-
-				if(!(consideredInterfaces.count(arrayPartitionName))) {
-					consideredInterfaces.insert(arrayPartitionName);
-					(connectedStoreGraphs[arrayPartitionName])++;
-				}
+	// Each component is a set of stores connected by dependencies
+	for(auto &it : storeDeps.getComponents(microops)) {
+		std::vector<unsigned> &connected = it;
+		std::set<std::string> consideredInterfaces;
+
+		// Find smallest and largest allocation value for each memory interface
+		// (if banking is disabled, all global stores share the same interface)
+		std::unordered_map<std::string, minMaxPair> minMaxPerInterface;
+		for(auto &it2 : connected) {
+			std::string arrayPartitionName = baseAddress.at(it2).first;
+			if(rcScheduledTime[it2] < minMaxPerInterface[arrayPartitionName].value.first)
+				minMaxPerInterface[arrayPartitionName].value.first = rcScheduledTime[it2];
+			if(rcScheduledTime[it2] > minMaxPerInterface[arrayPartitionName].value.second)
+				minMaxPerInterface[arrayPartitionName].value.second = rcScheduledTime[it2];
+
+			if(!(consideredInterfaces.count(arrayPartitionName))) {
+				consideredInterfaces.insert(arrayPartitionName);
+				(connectedStoreGraphs[arrayPartitionName])++;
 			}
-
-			// Save all distances to the store max vector
-			for(auto &it2 : minMaxPerInterface)
-				storeMaxs.push_back(std::make_pair(it2.first, it2.second.distance()));
 		}
+
+		// Save all distances to the store max vector
+		for(auto &it2 : minMaxPerInterface)
+			storeMaxs.push_back(std::make_pair(it2.first, it2.second.distance()));
 	}
 
 	// There is a key difference between Lina and Vivado regarding allocation of load/stores.
@@ -1568,6 +2032,8 @@ std::tuple<std::string, uint64_t> BaseDatapath::calculateResIIMemRec() {
 }
 
 uint64_t BaseDatapath::calculateRecII(uint64_t currAsapII) {
+	DATAPATH_PHASE_SCOPE(phase, "recII");
+
 	if(enablePipelining) {
 		int64_t sub = (int64_t) (asapII - currAsapII);
 
@@ -1626,6 +2092,11 @@ uint64_t BaseDatapath::calculateRecII(uint64_t currAsapII) {
 }
 
 uint64_t BaseDatapath::getLoopTotalLatency(uint64_t maxII) {
+	return getLoopTotalLatency(loopName, loopLevel, enablePipelining, rcIL, maxII);
+}
+
+// Total latency from the latency (and II) of one DDDG, scaled by the loop bounds and unroll factors of the loop nest
+uint64_t BaseDatapath::getLoopTotalLatency(std::string loopName, unsigned loopLevel, bool enablePipelining, uint64_t rcIL, uint64_t maxII) {
 	uint64_t noPipelineLatency = 0, pipelinedLatency = 0;
 
 	loopName2levelUnrollVecMapTy::iterator found = loopName2levelUnrollVecMap.find(loopName);
@@ -1692,37 +2163,42 @@ uint64_t BaseDatapath::getLoopTotalLatency(uint64_t maxII) {
 	return enablePipelining? pipelinedLatency : noPipelineLatency;
 }
 
-void BaseDatapath::inheritLoadDepMap(unsigned targetID, unsigned sourceID) {
-	loadDepMap[targetID].insert(loadDepMap[sourceID].begin(), loadDepMap[sourceID].end());
-}
-
-void BaseDatapath::inheritStoreDepMap(unsigned targetID, unsigned sourceID) {
-	storeDepMap[targetID].insert(storeDepMap[sourceID].begin(), storeDepMap[sourceID].end());
-}
-
-void BaseDatapath::addToLoadDepMap(unsigned targetID, unsigned toAddID) {
-	// XXX falseDeps deactivated so far because no control edges are added in the Lina logic outside of MemoryModel
-	//if(falseDeps.count(std::make_pair(toAddID, targetID)))
-		loadDepMap[targetID].insert(toAddID);
-}
-
-void BaseDatapath::addToStoreDepMap(unsigned targetID, unsigned toAddID) {
-	// XXX falseDeps deactivated so far because no control edges are added in the Lina logic outside of MemoryModel
-	//if(falseDeps.count(std::make_pair(toAddID, targetID)))
-		storeDepMap[targetID].insert(toAddID);
-}
-
 void BaseDatapath::dumpSummary(
 	uint64_t numCycles, uint64_t asapII, double achievedPeriod,
 	uint64_t maxII, std::tuple<std::string, uint64_t> resIIMem, std::tuple<std::string, uint64_t> resIIOp, uint64_t recII
 ) {
+	DATAPATH_PHASE_SCOPE(phase, "resourceEstimation");
+
+	// Same values as the summary, for --result-format
+	ResultWriter::recordTy record;
+	record.loopName = loopName;
+	record.loopLevel = loopLevel;
+	record.datapathType = datapathType;
+	record.frequency = profile->getFrequency();
+	record.uncertainty = profile->getUncertainty();
+	record.effectivePeriod = profile->getEffectivePeriod();
+	record.achievedPeriod = achievedPeriod;
+	record.unrollFactor = loopUnrollFactor;
+	record.pipelining = enablePipelining;
+	record.cycles = numCycles;
+	record.asapIL = asapII;
+	record.rcIL = rcIL;
+	record.II = maxII;
+	record.resIIMem = std::get<1>(resIIMem);
+	record.resIIMemArray = std::get<0>(resIIMem);
+	record.resIIOp = std::get<1>(resIIOp);
+	record.resIIOpUnit = std::get<0>(resIIOp);
+	record.recII = recII;
+	record.sharedLoads = sharedLoadsRemoved;
+	record.repeatedStores = repeatedStoresRemoved;
+
 	*summaryFile << "================================================\n";
 	if(args.fNoTCS)
 		*summaryFile << "Time-constrained scheduling disabled\n";
-	*summaryFile << "Target clock: " << std::to_string(args.frequency) << " MHz\n";
-	*summaryFile << "Clock uncertainty: " << std::to_string(args.uncertainty) << " %\n";
-	*summaryFile << "Target clock period: " << std::to_string(1000 / args.frequency) << " ns\n";
-	*summaryFile << "Effective clock period: " << std::to_string((1000 / args.frequency) - (10 * args.uncertainty / args.frequency)) << " ns\n";
+	*summaryFile << "Target clock: " << std::to_string(profile->getFrequency()) << " MHz\n";
+	*summaryFile << "Clock uncertainty: " << std::to_string(profile->getUncertainty()) << " %\n";
+	*summaryFile << "Target clock period: " << std::to_string(1000 / profile->getFrequency()) << " ns\n";
+	*summaryFile << "Effective clock period: " << std::to_string(profile->getEffectivePeriod()) << " ns\n";
 	*summaryFile << "Achieved clock period: " << std::to_string(achievedPeriod) << " ns\n";
 	*summaryFile << "Loop name: " << loopName << "\n";
 	*summaryFile << "Loop level: " << std::to_string(loopLevel) << "\n";
@@ -1762,19 +2238,28 @@ void BaseDatapath::dumpSummary(
 	*summaryFile << "recII: " << std::to_string(recII) << "\n";
 
 	*summaryFile << "Limited by ";
-	if(std::get<1>(resIIMem) > std::get<1>(resIIOp) && std::get<1>(resIIMem) > recII && std::get<1>(resIIMem) > 1)
+	if(std::get<1>(resIIMem) > std::get<1>(resIIOp) && std::get<1>(resIIMem) > recII && std::get<1>(resIIMem) > 1) {
 		*summaryFile << "memory, array name: " << std::get<0>(resIIMem) << "\n";
-	else if(std::get<1>(resIIOp) > std::get<1>(resIIMem) && std::get<1>(resIIOp) > recII && std::get<1>(resIIOp) > 1)
+		record.limitedBy = "memory";
+	}
+	else if(std::get<1>(resIIOp) > std::get<1>(resIIMem) && std::get<1>(resIIOp) > recII && std::get<1>(resIIOp) > 1) {
 		*summaryFile << "floating point operation: " << std::get<0>(resIIOp) << "\n";
-	else if(recII > std::get<1>(resIIMem) && recII > std::get<1>(resIIOp) && recII > 1)
+		record.limitedBy = "operation";
+	}
+	else if(recII > std::get<1>(resIIMem) && recII > std::get<1>(resIIOp) && recII > 1) {
 		*summaryFile << "loop-carried dependency\n";
-	else
+		record.limitedBy = "recurrence";
+	}
+	else {
 		*summaryFile << "none\n";
+		record.limitedBy = "none";
+	}
 	*summaryFile << "------------------------------------------------\n";
 
 	if(!(args.fNoFPUThresOpt)) {
 		*summaryFile << "Units limited by DSP usage: ";
 		bool anyFound = false;
+		std::string limitedUnits;
 		for(auto &i : profile->getConstrainedUnits()) {
 			std::string unitName;
 			switch(i) {
@@ -1799,15 +2284,20 @@ void BaseDatapath::dumpSummary(
 
 			if(!anyFound) {
 				*summaryFile << unitName;
+				limitedUnits = unitName;
 				anyFound = true;
 			}
 			else {
 				*summaryFile << ", " << unitName;
+				limitedUnits += ", " + unitName;
 			}
 		}
 
-		if(!anyFound)
+		if(!anyFound) {
 			*summaryFile << "none";
+			limitedUnits = "none";
+		}
+		record.fields.push_back({"Units limited by DSP usage", false, limitedUnits});
 
 		*summaryFile << "\n";
 		*summaryFile << "------------------------------------------------\n";
@@ -1915,6 +2405,7 @@ void BaseDatapath::dumpSummary(
 			uint64_t value = sharedDSP + unsharedDSP;
 
 			*summaryFile << name << ": " << value << "\n";
+			record.dsps = value;
 			continue;
 		}
 		else if("FFs" == name) {
@@ -1922,6 +2413,7 @@ void BaseDatapath::dumpSummary(
 			uint64_t value = sharedFF + unsharedFF + rFF + mlFF;
 
 			*summaryFile << name << ": " << value << "\n";
+			record.ffs = value;
 			continue;
 		}
 		else if("LUTs" == name) {
@@ -1938,25 +2430,41 @@ void BaseDatapath::dumpSummary(
 			uint64_t value = sharedLUT + unsharedLUT + mLUT + exLUT + mlLUT;
 
 			*summaryFile << name << ": " << value << "\n";
+			record.luts = value;
 			continue;
 		}
 
-		*summaryFile << name << ": ";
-
+		std::string value;
 		switch(std::get<2>(it)) {
 			case Pack::TYPE_UNSIGNED:
-				*summaryFile << std::to_string(P.getElements<uint64_t>(std::get<0>(it))[0]) << "\n";
+				value = std::to_string(P.getElements<uint64_t>(std::get<0>(it))[0]);
 				break;
 			case Pack::TYPE_SIGNED:
-				*summaryFile << std::to_string(P.getElements<int64_t>(std::get<0>(it))[0]) << "\n";
+				value = std::to_string(P.getElements<int64_t>(std::get<0>(it))[0]);
 				break;
 			case Pack::TYPE_FLOAT:
-				*summaryFile << std::to_string(P.getElements<float>(std::get<0>(it))[0]) << "\n";
+				value = std::to_string(P.getElements<float>(std::get<0>(it))[0]);
 				break;
 			case Pack::TYPE_STRING:
-				*summaryFile << P.getElements<std::string>(std::get<0>(it))[0] << "\n";
+				value = P.getElements<std::string>(std::get<0>(it))[0];
 				break;
 		}
+
+		*summaryFile << name << ": " << value << "\n";
+
+		if("BRAM18k" == name)
+			record.bram18k = P.getElements<uint64_t>(name)[0];
+		else
+			record.fields.push_back({name, ResultWriter::isNumeric(std::get<1>(it), std::get<2>(it)), value});
+	}
+
+	if(deferResults) {
+		ResultWriter::addResources(record, P);
+		deferredResults.push_back(record);
+	}
+	else if(resultWriter.isActive()) {
+		ResultWriter::addResources(record, P);
+		resultWriter.write(record);
 	}
 }	
 
@@ -1964,38 +2472,161 @@ void BaseDatapath::dumpGraph(bool isOptimised) {
 	std::string datapathTypeStr(
 		(DatapathType::NON_PERFECT_BEFORE == datapathType)? "_before" : ((DatapathType::NON_PERFECT_AFTER == datapathType)? "_after" : ((DatapathType::NON_PERFECT_BETWEEN == datapathType)? "_inter" : "" ))
 	);
+	bool isBinary = args.DDDG_FORMAT_BINARY == args.dddgFormat;
 	std::string graphFileName(
 		args.outWorkDir
 			+ appendDepthToLoopName(loopName, loopLevel)
 			+ datapathTypeStr
-			+ (isOptimised? "_graph_opt.dot" : "_graph.dot")
+			+ (isOptimised? getClockSweepSuffix(*profile) + "_graph_opt" : "_graph")
+			+ (isBinary? ".bin" : ".dot")
 	);
-	std::ofstream out(graphFileName);
 
+	if(isBinary) {
+		std::ofstream out(graphFileName, std::ios::binary);
+		std::vector<char> chunk;
+		chunk.reserve(DDDG_BINARY_CHUNK_SIZE);
+		auto writeValue = [&out, &chunk] (const void *value, size_t size) {
+			if(chunk.size() + size > DDDG_BINARY_CHUNK_SIZE) {
+				out.write(chunk.data(), chunk.size());
+				chunk.clear();
+			}
+			chunk.insert(chunk.end(), (const char *) value, (const char *) value + size);
+		};
+		// Schedules not calculated yet (e.g. --show-pre-dddg) are written as 0. RC scheduled times are not written:
+		// the DDDG is dumped before resource-constrained scheduling, which depends on the partitioning
+		auto getTime = [] (const std::vector<uint64_t> &scheduledTime, unsigned nodeID) {
+			return (nodeID < scheduledTime.size())? scheduledTime[nodeID] : 0;
+		};
+
+		uint32_t version = DDDG_BINARY_VERSION;
+		uint64_t numNodes = numOfTotalNodes;
+		uint64_t numEdges = boost::num_edges(graph);
+		writeValue(DDDG_BINARY_MAGIC, sizeof(DDDG_BINARY_MAGIC) - 1);
+		writeValue(&version, sizeof(version));
+		writeValue(&numNodes, sizeof(numNodes));
+		writeValue(&numEdges, sizeof(numEdges));
+
+		for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
+			uint64_t asap = getTime(asapScheduledTime, nodeID);
+			uint64_t alap = getTime(alapScheduledTime, nodeID);
+			writeValue(&(microops[nodeID]), sizeof(uint8_t));
+			writeValue(&asap, sizeof(asap));
+			writeValue(&alap, sizeof(alap));
+		}
+
+		EdgeIterator edgeIt, edgeEnd;
+		for(std::tie(edgeIt, edgeEnd) = boost::edges(graph); edgeIt != edgeEnd; edgeIt++) {
+			uint32_t from = vertexToName[boost::source(*edgeIt, graph)];
+			uint32_t to = vertexToName[boost::target(*edgeIt, graph)];
+			uint8_t weight = edgeToWeight[*edgeIt];
+			writeValue(&from, sizeof(from));
+			writeValue(&to, sizeof(to));
+			writeValue(&weight, sizeof(weight));
+		}
+
+		out.write(chunk.data(), chunk.size());
+		out.close();
+
+		return;
+	}
+
+	const std::vector<std::string> &bbList = PC.getCurrBBList();
+	const std::vector<staticInstTy> &staticInsts = PC.getStaticInstList();
+	const std::vector<unsigned> &staticInstIDs = PC.getStaticInstIDList();
+	const std::vector<std::string> &functionNameList = PC.getFunctionNameList();
 	std::vector<std::string> functionNames;
-	for(auto &it : PC.getFuncList()) {
-#ifdef LEGACY_SEPARATOR
-		size_t tagPos = it.find("-");
-#else
-		size_t tagPos = it.find(GLOBAL_SEPARATOR);
-#endif
-		std::string functionName = it.substr(0, tagPos);
+	for(auto &it : staticInstIDs)
+		functionNames.push_back(functionNameList.at(staticInsts.at(it).functionID));
+
+	// Nodes to be dumped (all of them if no filter is active)
+	std::vector<bool> selected(numOfTotalNodes, args.DDDG_FILTER_NONE == args.dddgFilter);
+	if(args.DDDG_FILTER_CRITICAL_PATH == args.dddgFilter) {
+		assert(cPathNodes.size() && "Critical path list not generated");
+		for(auto &it : cPathNodes)
+			selected[it] = true;
+	}
+	else if(args.DDDG_FILTER_ITERATION == args.dddgFilter) {
+		std::string functionName = std::get<0>(parseLoopName(loopName));
+		lpNameLevelPair2headBBnameMapTy::iterator found = lpNameLevelPair2headBBnameMap.find(std::make_pair(loopName, std::to_string(loopLevel)));
+		assert(found != lpNameLevelPair2headBBnameMap.end() && "Could not find header BB of loop inside lpNameLevelPair2headBBnameMap");
+		std::string headerBBName = found->second;
+
+		// Each execution of the header BB runs each of its instructions exactly once, thus a new iteration starts
+		// every time the first header instruction found in the trace is executed again. Instructions are compared by
+		// their ID inside the function, since the static instruction ID also depends on the previous BB (which
+		// differs between the first and the following iterations)
+		// XXX: Nodes before the first header execution are considered part of the first iteration
+		uint64_t headerEntries = 0;
+		bool headerFound = false;
+		unsigned headerInstructionID = 0;
+		for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
+			unsigned instructionID = staticInsts[staticInstIDs[nodeID]].instructionID;
+
+			if(!headerFound && !(bbList[nodeID].compare(headerBBName)) && !(functionNames[nodeID].compare(functionName))) {
+				headerFound = true;
+				headerInstructionID = instructionID;
+			}
+
+			if(headerFound && instructionID == headerInstructionID)
+				headerEntries++;
+
+			uint64_t iteration = headerEntries? headerEntries - 1 : 0;
+			if(iteration == args.dddgFilterIteration)
+				selected[nodeID] = true;
+			else if(iteration > args.dddgFilterIteration)
+				break;
+		}
+	}
 
-		functionNames.push_back(functionName);
+	// Same output as boost::write_graphviz(), restricted to the selected nodes and the edges between them
+	// Colours are looked up once per run of nodes from the same BB, which are consecutive in trace order
+	std::vector<std::string> colorStrings(numOfTotalNodes);
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
+		if(nodeID && !(bbList[nodeID].compare(bbList[nodeID - 1])) && !(functionNames[nodeID].compare(functionNames[nodeID - 1]))) {
+			colorStrings[nodeID] = colorStrings[nodeID - 1];
+			continue;
+		}
+
+		bbFuncNamePair2lpNameLevelPairMapTy::iterator found = bbFuncNamePair2lpNameLevelPairMap.find(std::make_pair(bbList[nodeID], functionNames[nodeID]));
+		if(found != bbFuncNamePair2lpNameLevelPairMap.end())
+			colorStrings[nodeID] = ColorWriter::getColorString(found->second.second);
 	}
 
-	ColorWriter colorWriter(graph, vertexToName, PC.getCurrBBList(), functionNames, microops, bbFuncNamePair2lpNameLevelPairMap);
+	std::ofstream out(graphFileName);
+	ColorWriter colorWriter(vertexToName, microops, colorStrings);
 	EdgeColorWriter edgeColorWriter(graph, edgeToWeight);
-	write_graphviz(out, graph, colorWriter, edgeColorWriter);
+
+	out << "digraph G {\n";
+	VertexIterator vertexIt, vertexEnd;
+	for(std::tie(vertexIt, vertexEnd) = boost::vertices(graph); vertexIt != vertexEnd; vertexIt++) {
+		if(!selected[vertexToName[*vertexIt]])
+			continue;
+
+		out << *vertexIt;
+		colorWriter(out, *vertexIt);
+		out << ";\n";
+	}
+	EdgeIterator edgeIt, edgeEnd;
+	for(std::tie(edgeIt, edgeEnd) = boost::edges(graph); edgeIt != edgeEnd; edgeIt++) {
+		Vertex source = boost::source(*edgeIt, graph);
+		Vertex target = boost::target(*edgeIt, graph);
+		if(!selected[vertexToName[source]] || !selected[vertexToName[target]])
+			continue;
+
+		out << source << "->" << target << " ";
+		edgeColorWriter(out, *edgeIt);
+		out << ";\n";
+	}
+	out << "}\n";
 
 	out.close();
 }
 
 BaseDatapath::RCScheduler::RCScheduler(
 	const std::string loopName, const unsigned loopLevel, const unsigned datapathType,
-	const std::vector<int> &microops, const std::unordered_map<int, unsigned> &resultSizeList,
+	const std::vector<uint8_t> &microops, const std::unordered_map<int, unsigned> &resultSizeList,
 	const Graph &graph, unsigned numOfTotalNodes,
-	const std::unordered_map<unsigned, Vertex> &nameToVertex, const VertexNameMap &vertexToName,
+	const std::vector<Vertex> &nameToVertex, const VertexNameMap &vertexToName,
 	HardwareProfile &profile, const std::unordered_map<int, std::pair<std::string, int64_t>> &baseAddress,
 	const std::vector<uint64_t> &asap, const std::vector<uint64_t> &alap, std::vector<uint64_t> &rc
 ) :
@@ -2071,17 +2702,17 @@ BaseDatapath::RCScheduler::RCScheduler(
 		std::string datapathTypeStr(
 			(DatapathType::NON_PERFECT_BEFORE == datapathType)? "_before" : ((DatapathType::NON_PERFECT_AFTER == datapathType)? "_after" : ((DatapathType::NON_PERFECT_BETWEEN == datapathType)? "_inter" : "" ))
 		);
-		dumpFile.open(args.outWorkDir + appendDepthToLoopName(loopName, loopLevel) + datapathTypeStr + ".sched.rpt");
+		dumpFile.open(args.outWorkDir + appendDepthToLoopName(loopName, loopLevel) + datapathTypeStr + getClockSweepSuffix(profile) + ".sched.rpt");
 
 		dumpFile << "================================================\n";
 		dumpFile << "Lina scheduling report file\n";
 		dumpFile << "Loop name: " << loopName << "\n";
 		if(args.fNoTCS)
 			dumpFile << "Time-constrained scheduling disabled\n";
-		dumpFile << "Target clock: " << std::to_string(args.frequency) << " MHz\n";
-		dumpFile << "Clock uncertainty: " << std::to_string(args.uncertainty) << " %\n";
-		dumpFile << "Target clock period: " << std::to_string(1000 / args.frequency) << " ns\n";
-		dumpFile << "Effective clock period: " << std::to_string((1000 / args.frequency) - (10 * args.uncertainty / args.frequency)) << " ns\n";
+		dumpFile << "Target clock: " << std::to_string(profile.getFrequency()) << " MHz\n";
+		dumpFile << "Clock uncertainty: " << std::to_string(profile.getUncertainty()) << " %\n";
+		dumpFile << "Target clock period: " << std::to_string(1000 / profile.getFrequency()) << " ns\n";
+		dumpFile << "Effective clock period: " << std::to_string(profile.getEffectivePeriod()) << " ns\n";
 		dumpFile << "------------------------------------------------\n";
 	}
 }
@@ -2734,10 +3365,476 @@ void BaseDatapath::RCScheduler::setScheduledAndAssignReadyChildren(unsigned node
 	}
 }
 
+BaseDatapath::ModuloScheduler::ModuloScheduler(
+	const std::vector<uint8_t> &microops,
+	const Graph &graph, unsigned numOfTotalNodes,
+	const std::vector<Vertex> &nameToVertex, const VertexNameMap &vertexToName, const EdgeWeightMap &edgeToWeight,
+	HardwareProfile &profile, const std::unordered_map<int, std::pair<std::string, int64_t>> &baseAddress,
+	const std::vector<carriedEdgeTy> &loopCarriedEdges
+) :
+	microops(microops),
+	graph(graph), numOfTotalNodes(numOfTotalNodes),
+	nameToVertex(nameToVertex), vertexToName(vertexToName), edgeToWeight(edgeToWeight),
+	profile(profile), baseAddress(baseAddress),
+	loopCarriedEdges(loopCarriedEdges)
+{
+	resMII = 1;
+	recMII = 1;
+	resMIIName = "none";
+
+	buildDependencies();
+	buildResources();
+	calculateResMII();
+	calculateRecMII();
+	calculateHeights();
+}
+
+std::tuple<uint64_t, uint64_t> BaseDatapath::ModuloScheduler::schedule() {
+	// A schedule without any overlap between iterations is always feasible with this II
+	uint64_t upperII = 1;
+	for(auto &nodeID : activeNodes)
+		upperII += (latencies[nodeID] > nodeOccupancy[nodeID])? latencies[nodeID] : nodeOccupancy[nodeID];
+
+	uint64_t II = (resMII > recMII)? resMII : recMII;
+	while(!tryII(II)) {
+		II++;
+		assert(II <= upperII && "Modulo scheduler could not find a feasible II");
+	}
+
+	// Iteration latency follows the same convention as asapScheduling()
+	uint64_t maxEnd = 0;
+	for(auto &nodeID : activeNodes) {
+		uint64_t end = schedTime[nodeID] + latencies[nodeID];
+		if(end > maxEnd)
+			maxEnd = end;
+	}
+	uint64_t IL = (args.fExtraScalar || !maxEnd)? maxEnd : maxEnd - 1;
+
+	return std::make_tuple(II, IL);
+}
+
+void BaseDatapath::ModuloScheduler::buildDependencies() {
+	latencies.assign(numOfTotalNodes, 0);
+	preds.assign(numOfTotalNodes, std::vector<depTy>());
+	succs.assign(numOfTotalNodes, std::vector<depTy>());
+	std::vector<bool> isActive(numOfTotalNodes, false);
+
+	// Isolated nodes are not scheduled
+	for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
+		if(!boost::degree(nameToVertex.at(nodeID), graph))
+			continue;
+
+		isActive[nodeID] = true;
+		activeNodes.push_back(nodeID);
+		latencies[nodeID] = profile.getLatency(microops.at(nodeID));
+	}
+
+	// Intra-iteration dependencies (distance 0)
+	EdgeIterator edgei, edgeEnd;
+	for(std::tie(edgei, edgeEnd) = boost::edges(graph); edgei != edgeEnd; edgei++) {
+		unsigned from = vertexToName[boost::source(*edgei, graph)];
+		unsigned to = vertexToName[boost::target(*edgei, graph)];
+		unsigned latency = (EDGE_CONTROL == boost::get(edgeToWeight, *edgei))? 0 : latencies[from];
+
+		succs[from].push_back({to, latency, 0});
+		preds[to].push_back({from, latency, 0});
+	}
+
+	// Loop-carried dependencies. Edges whose nodes were removed by DDDG optimisations are ignored
+	for(auto &it : loopCarriedEdges) {
+		if(!isActive[it.from] || !isActive[it.to])
+			continue;
+
+		succs[it.from].push_back({it.to, latencies[it.from], it.distance});
+		preds[it.to].push_back({it.from, latencies[it.from], it.distance});
+	}
+}
+
+void BaseDatapath::ModuloScheduler::buildResources() {
+	const std::map<std::string, std::tuple<uint64_t, uint64_t, size_t, unsigned>> &arrayConfig = profile.arrayGetConfig();
+	std::map<std::string, int> nameToResource;
+
+	nodeResource.assign(numOfTotalNodes, -1);
+	nodeOccupancy.assign(numOfTotalNodes, 1);
+
+	for(auto &nodeID : activeNodes) {
+		unsigned opcode = microops.at(nodeID);
+		std::string resourceName;
+		unsigned amount = 0;
+
+		switch(opcode) {
+			case LLVM_IR_FAdd:
+				resourceName = "fadd";
+				amount = profile.fAddGetAmount();
+				break;
+			case LLVM_IR_FSub:
+				resourceName = "fsub";
+				amount = profile.fSubGetAmount();
+				break;
+			case LLVM_IR_FMul:
+				resourceName = "fmul";
+				amount = profile.fMulGetAmount();
+				break;
+			case LLVM_IR_FDiv:
+				resourceName = "fdiv";
+				amount = profile.fDivGetAmount();
+				break;
+			case LLVM_IR_Load:
+			case LLVM_IR_Store: {
+				std::string partitionName = baseAddress.at(nodeID).first;
+#ifdef LEGACY_SEPARATOR
+				std::string arrayName = partitionName.substr(0, partitionName.find("-"));
+#else
+				std::string arrayName = partitionName.substr(0, partitionName.find(GLOBAL_SEPARATOR));
+#endif
+
+				// Complete partitioning, no port constraint
+				if(!(std::get<0>(arrayConfig.at(arrayName))))
+					break;
+
+				if(LLVM_IR_Load == opcode) {
+					resourceName = partitionName + " (read)";
+					amount = profile.arrayGetPartitionReadPorts(partitionName);
+				}
+				else {
+					resourceName = partitionName + " (write)";
+					amount = profile.arrayGetPartitionWritePorts(partitionName);
+				}
+				break;
+			}
+			default:
+#ifdef CONSTRAIN_INT_OP
+				if(HardwareProfile::constrainedIntOps.count(opcode)) {
+					resourceName = reverseOpcodeMap.at(opcode);
+					amount = profile.intOpGetAmount(opcode);
+				}
+#endif
+				break;
+		}
+
+		// Not constrained
+		if(!amount)
+			continue;
+
+		std::map<std::string, int>::iterator found = nameToResource.find(resourceName);
+		if(found != nameToResource.end()) {
+			nodeResource[nodeID] = found->second;
+		}
+		else {
+			nodeResource[nodeID] = resourceNames.size();
+			nameToResource.insert(std::make_pair(resourceName, resourceNames.size()));
+			resourceNames.push_back(resourceName);
+			resourceAmounts.push_back(amount);
+		}
+
+		// Non-pipelined units are occupied during the whole operation
+		if(!isMemoryOp(opcode) && !(profile.isPipelined(opcode)) && latencies[nodeID] > 1)
+			nodeOccupancy[nodeID] = latencies[nodeID];
+	}
+}
+
+void BaseDatapath::ModuloScheduler::calculateResMII() {
+	std::vector<uint64_t> usage(resourceNames.size(), 0);
+
+	for(auto &nodeID : activeNodes) {
+		if(nodeResource[nodeID] >= 0)
+			usage[nodeResource[nodeID]] += nodeOccupancy[nodeID];
+	}
+
+	for(unsigned i = 0; i < resourceNames.size(); i++) {
+		uint64_t candidate = std::ceil(usage[i] / (double) resourceAmounts[i]);
+		if(candidate > resMII) {
+			resMII = candidate;
+			resMIIName = resourceNames[i];
+		}
+	}
+}
+
+void BaseDatapath::ModuloScheduler::calculateRecMII() {
+	std::map<unsigned, std::vector<depTy>> targetToCarried;
+
+	for(auto &nodeID : activeNodes) {
+		for(auto &it : succs[nodeID]) {
+			if(it.distance)
+				targetToCarried[it.nodeID].push_back({nodeID, it.latency, it.distance});
+		}
+	}
+
+	// For each loop-carried edge from -> to, the recurrence delay is the longest path to -> from plus the latency of from.
+	// Nodes are in topological order, thus the longest paths from a node are found with a single forward pass
+	std::vector<int64_t> longestPath;
+	for(auto &it : targetToCarried) {
+		unsigned targetID = it.first;
+
+		longestPath.assign(numOfTotalNodes, -1);
+		longestPath[targetID] = 0;
+		for(unsigned nodeID = targetID; nodeID < numOfTotalNodes; nodeID++) {
+			if(longestPath[nodeID] < 0)
+				continue;
+
+			for(auto &it2 : succs[nodeID]) {
+				if(it2.distance)
+					continue;
+
+				int64_t candidate = longestPath[nodeID] + it2.latency;
+				if(candidate > longestPath[it2.nodeID])
+					longestPath[it2.nodeID] = candidate;
+			}
+		}
+
+		for(auto &it2 : it.second) {
+			if(longestPath[it2.nodeID] < 0)
+				continue;
+
+			uint64_t candidate = std::ceil((longestPath[it2.nodeID] + it2.latency) / (double) it2.distance);
+			if(candidate > recMII)
+				recMII = candidate;
+		}
+	}
+}
+
+void BaseDatapath::ModuloScheduler::calculateHeights() {
+	heights.assign(numOfTotalNodes, 0);
+
+	for(unsigned nodeID = numOfTotalNodes - 1; nodeID + 1; nodeID--) {
+		for(auto &it : succs[nodeID]) {
+			if(it.distance)
+				continue;
+
+			int64_t candidate = heights[it.nodeID] + it.latency;
+			if(candidate > heights[nodeID])
+				heights[nodeID] = candidate;
+		}
+	}
+}
+
+unsigned BaseDatapath::ModuloScheduler::getSlotUsage(unsigned nodeID, int64_t time, uint64_t slot, uint64_t II) {
+	// Occupancies longer than II wrap around the reservation table, using the same slot more than once
+	uint64_t occupancy = nodeOccupancy[nodeID];
+	uint64_t offset = (slot + II - (time % II)) % II;
+
+	return (occupancy / II) + ((offset < occupancy % II)? 1 : 0);
+}
+
+bool BaseDatapath::ModuloScheduler::resourceFits(unsigned nodeID, int64_t time, uint64_t II) {
+	int resource = nodeResource[nodeID];
+	if(resource < 0)
+		return true;
+
+	uint64_t slotsToCheck = (nodeOccupancy[nodeID] < II)? nodeOccupancy[nodeID] : II;
+	for(uint64_t i = 0; i < slotsToCheck; i++) {
+		uint64_t slot = (time + i) % II;
+		if(mrt[resource][slot].size() + getSlotUsage(nodeID, time, slot, II) > resourceAmounts[resource])
+			return false;
+	}
+
+	return true;
+}
+
+void BaseDatapath::ModuloScheduler::reserve(unsigned nodeID, int64_t time, uint64_t II) {
+	int resource = nodeResource[nodeID];
+
+	if(resource >= 0) {
+		for(uint64_t i = 0; i < nodeOccupancy[nodeID]; i++)
+			mrt[resource][(time + i) % II].push_back(nodeID);
+	}
+
+	schedTime[nodeID] = time;
+	lastSchedTime[nodeID] = time;
+}
+
+void BaseDatapath::ModuloScheduler::unschedule(unsigned nodeID, uint64_t II) {
+	int resource = nodeResource[nodeID];
+
+	if(resource >= 0) {
+		for(uint64_t i = 0; i < nodeOccupancy[nodeID]; i++) {
+			std::vector<unsigned> &slotNodes = mrt[resource][(schedTime[nodeID] + i) % II];
+			slotNodes.erase(std::find(slotNodes.begin(), slotNodes.end(), nodeID));
+		}
+	}
+
+	schedTime[nodeID] = -1;
+	unscheduledNodes.insert(std::make_pair(-heights[nodeID], nodeID));
+}
+
+bool BaseDatapath::ModuloScheduler::tryII(uint64_t II) {
+	mrt.assign(resourceNames.size(), std::vector<std::vector<unsigned>>(II));
+	schedTime.assign(numOfTotalNodes, -1);
+	lastSchedTime.assign(numOfTotalNodes, -1);
+	unscheduledNodes.clear();
+
+	for(auto &nodeID : activeNodes) {
+		int resource = nodeResource[nodeID];
+
+		// Even a single node does not fit in the reservation table
+		if(resource >= 0 && nodeOccupancy[nodeID] > resourceAmounts[resource] * II)
+			return false;
+
+		unscheduledNodes.insert(std::make_pair(-heights[nodeID], nodeID));
+	}
+
+	uint64_t budget = BUDGET_RATIO * activeNodes.size();
+	while(unscheduledNodes.size()) {
+		if(!budget)
+			return false;
+		budget--;
+
+		unsigned nodeID = unscheduledNodes.begin()->second;
+		unscheduledNodes.erase(unscheduledNodes.begin());
+
+		// Earliest start time considering the scheduled predecessors
+		int64_t earlyStart = 0;
+		for(auto &it : preds[nodeID]) {
+			if(schedTime[it.nodeID] < 0)
+				continue;
+
+			int64_t candidate = schedTime[it.nodeID] + it.latency - (int64_t) (II * it.distance);
+			if(candidate > earlyStart)
+				earlyStart = candidate;
+		}
+
+		// Search for a conflict-free slot within II cycles
+		int64_t time = -1;
+		for(int64_t candidate = earlyStart; candidate < earlyStart + (int64_t) II; candidate++) {
+			if(resourceFits(nodeID, candidate, II)) {
+				time = candidate;
+				break;
+			}
+		}
+
+		// No slot available, force a time and evict the conflicting nodes
+		if(time < 0) {
+			time = (lastSchedTime[nodeID] < 0 || earlyStart > lastSchedTime[nodeID])? earlyStart : lastSchedTime[nodeID] + 1;
+
+			int resource = nodeResource[nodeID];
+			uint64_t slotsToCheck = (nodeOccupancy[nodeID] < II)? nodeOccupancy[nodeID] : II;
+			for(uint64_t i = 0; i < slotsToCheck; i++) {
+				uint64_t slot = (time + i) % II;
+				unsigned usage = getSlotUsage(nodeID, time, slot, II);
+
+				while(mrt[resource][slot].size() + usage > resourceAmounts[resource])
+					unschedule(mrt[resource][slot].front(), II);
+			}
+		}
+
+		// Evict scheduled successors whose dependencies are now violated
+		for(auto &it : succs[nodeID]) {
+			if(it.nodeID == nodeID || schedTime[it.nodeID] < 0)
+				continue;
+
+			if(time + it.latency - (int64_t) (II * it.distance) > schedTime[it.nodeID])
+				unschedule(it.nodeID, II);
+		}
+
+		reserve(nodeID, time, II);
+	}
+
+	return true;
+}
+
+void BaseDatapath::DependabilityTracker::init(
+	unsigned trackedOpcode, const std::vector<uint8_t> &microops, const std::vector<unsigned> &topologicalOrder,
+	const std::vector<unsigned> &inEdgeOffsets, const std::vector<unsigned> &inEdgeSources
+) {
+	unsigned numOfTotalNodes = microops.size();
+	this->trackedOpcode = trackedOpcode;
+
+	unionParent.resize(numOfTotalNodes);
+	for(unsigned i = 0; i < numOfTotalNodes; i++)
+		unionParent[i] = i;
+
+	ancestorComponent.assign(numOfTotalNodes, -1);
+	active.assign(numOfTotalNodes, false);
+
+	// Tracked nodes and their ancestors. Descendants are visited before their ancestors in reverse topological order
+	reachesTracked.assign(numOfTotalNodes, false);
+	for(std::vector<unsigned>::const_reverse_iterator it = topologicalOrder.rbegin(); it != topologicalOrder.rend(); it++) {
+		unsigned nodeID = *it;
+
+		if(trackedOpcode == (unsigned) microops.at(nodeID))
+			reachesTracked[nodeID] = true;
+		else if(!reachesTracked[nodeID])
+			continue;
+
+		for(unsigned i = inEdgeOffsets[nodeID]; i < inEdgeOffsets[nodeID + 1]; i++)
+			reachesTracked[inEdgeSources[i]] = true;
+	}
+}
+
+unsigned BaseDatapath::DependabilityTracker::find(unsigned nodeID) {
+	// Path halving keeps the union-find trees shallow
+	while(unionParent[nodeID] != nodeID) {
+		unionParent[nodeID] = unionParent[unionParent[nodeID]];
+		nodeID = unionParent[nodeID];
+	}
+
+	return nodeID;
+}
+
+void BaseDatapath::DependabilityTracker::join(unsigned nodeID, unsigned otherID) {
+	unsigned root = find(nodeID);
+	unsigned otherRoot = find(otherID);
+
+	if(otherRoot != root)
+		unionParent[otherRoot] = root;
+}
+
+void BaseDatapath::DependabilityTracker::inherit(unsigned targetID, unsigned sourceID) {
+	active[targetID] = true;
+	active[sourceID] = true;
+
+	// Components of nodes that neither are nor reach a tracked node are never joined
+	if(!reachesTracked[targetID] || -1 == ancestorComponent[sourceID])
+		return;
+
+	if(-1 == ancestorComponent[targetID])
+		ancestorComponent[targetID] = find(ancestorComponent[sourceID]);
+	else
+		join(ancestorComponent[targetID], ancestorComponent[sourceID]);
+}
+
+void BaseDatapath::DependabilityTracker::finalise(unsigned nodeID, unsigned opcode) {
+	// A tracked node joins the components of all its tracked ancestors. Its descendants only need this component
+	if(trackedOpcode == opcode) {
+		if(ancestorComponent[nodeID] != -1)
+			join(nodeID, ancestorComponent[nodeID]);
+
+		ancestorComponent[nodeID] = find(nodeID);
+	}
+}
+
+void BaseDatapath::DependabilityTracker::release() {
+	std::vector<int>().swap(ancestorComponent);
+	std::vector<bool>().swap(reachesTracked);
+}
+
+std::vector<std::vector<unsigned>> BaseDatapath::DependabilityTracker::getComponents(const std::vector<uint8_t> &microops) {
+	std::vector<std::vector<unsigned>> components;
+	std::unordered_map<unsigned, unsigned> rootToComponent;
+
+	// Only tracked nodes that have dependencies (in or out) are considered. Components are ordered by their first node
+	for(unsigned nodeID = 0; nodeID < active.size(); nodeID++) {
+		if(!active[nodeID] || trackedOpcode != (unsigned) microops.at(nodeID))
+			continue;
+
+		unsigned root = find(nodeID);
+		std::unordered_map<unsigned, unsigned>::iterator found = rootToComponent.find(root);
+		if(found != rootToComponent.end()) {
+			components[found->second].push_back(nodeID);
+		}
+		else {
+			rootToComponent.insert(std::make_pair(root, components.size()));
+			components.push_back(std::vector<unsigned>(1, nodeID));
+		}
+	}
+
+	return components;
+}
+
 BaseDatapath::TCScheduler::TCScheduler(
-	const std::vector<int> &microops,
+	const std::vector<uint8_t> &microops,
 	const Graph &graph, unsigned numOfTotalNodes,
-	const std::unordered_map<unsigned, Vertex> &nameToVertex, const VertexNameMap &vertexToName,
+	const std::vector<Vertex> &nameToVertex, const VertexNameMap &vertexToName,
 	HardwareProfile &profile
 ) :
 	microops(microops),
@@ -2745,7 +3842,7 @@ BaseDatapath::TCScheduler::TCScheduler(
 	nameToVertex(nameToVertex), vertexToName(vertexToName),
 	profile(profile)
 {
-	effectivePeriod = (1000 / args.frequency) - (10 * args.uncertainty / args.frequency);
+	effectivePeriod = profile.getEffectivePeriod();
 	clear();
 }
 
@@ -2807,43 +3904,99 @@ double BaseDatapath::TCScheduler::getCriticalPath() {
 	return criticalPath;
 }
 
+BaseDatapath::RewritePassManager::RewritePassManager(BaseDatapath &datapath) : datapath(datapath) { }
+
+void BaseDatapath::RewritePassManager::addPass(std::string name, unsigned order, bool barrier, visitFuncTy visit, finaliseFuncTy finalise) {
+	passes.push_back({name, order, barrier, visit, nullptr, finalise});
+}
+
+void BaseDatapath::RewritePassManager::addBulkPass(std::string name, bulkFuncTy bulk, finaliseFuncTy finalise) {
+	// Bulk passes are never fused
+	passes.push_back({name, ORDER_BULK, true, nullptr, bulk, finalise});
+}
+
+void BaseDatapath::RewritePassManager::run() {
+	std::vector<passTy>::iterator first = passes.begin();
+
+	while(first != passes.end()) {
+		std::vector<passTy>::iterator last = first + 1;
+		while(last != passes.end() && !(last->barrier) && last->order == first->order && first->order != ORDER_BULK)
+			last++;
+
+		runSweep(first, last);
+		first = last;
+	}
+
+	passes.clear();
+}
+
+void BaseDatapath::RewritePassManager::runSweep(std::vector<passTy>::iterator first, std::vector<passTy>::iterator last) {
+	std::string sweepName = first->name;
+	for(std::vector<passTy>::iterator it = first + 1; it != last; it++)
+		sweepName += "+" + it->name;
+	PHASE_SCOPE(phase, sweepName, datapath.loopName, datapath.loopLevel, datapath.datapathType);
+
+	edgeDeltaTy delta;
+	unsigned numOfTotalNodes = datapath.numOfTotalNodes;
+
+	if(ORDER_BULK == first->order) {
+		first->bulk(delta);
+	}
+	else if(ORDER_ASCENDING == first->order) {
+		for(unsigned nodeID = 0; nodeID < numOfTotalNodes; nodeID++) {
+			for(std::vector<passTy>::iterator it = first; it != last; it++)
+				it->visit(nodeID, delta);
+		}
+	}
+	else {
+		for(unsigned nodeID = numOfTotalNodes - 1; nodeID + 1; nodeID--) {
+			for(std::vector<passTy>::iterator it = first; it != last; it++)
+				it->visit(nodeID, delta);
+		}
+	}
+
+	datapath.applyEdgeDelta(delta);
+
+	for(std::vector<passTy>::iterator it = first; it != last; it++) {
+		if(it->finalise)
+			it->finalise();
+	}
+}
+
 BaseDatapath::ColorWriter::ColorWriter(
-	Graph &graph,
 	VertexNameMap &vertexNameMap,
-	const std::vector<std::string> &bbNames,
-	const std::vector<std::string> &funcNames,
-	std::vector<int> &opcodes,
-	llvm::bbFuncNamePair2lpNameLevelPairMapTy &bbFuncNamePair2lpNameLevelPairMap
-) : graph(graph), vertexNameMap(vertexNameMap), bbNames(bbNames), funcNames(funcNames), opcodes(opcodes), bbFuncNamePair2lpNameLevelPairMap(bbFuncNamePair2lpNameLevelPairMap) { }
+	std::vector<uint8_t> &opcodes,
+	const std::vector<std::string> &colorStrings
+) : vertexNameMap(vertexNameMap), opcodes(opcodes), colorStrings(colorStrings) { }
+
+std::string BaseDatapath::ColorWriter::getColorString(unsigned color) {
+	std::string colorString = "color=";
+
+	switch((ColorEnum) color) {
+		case RED: colorString += "red"; break;
+		case GREEN: colorString += "green"; break;
+		case BLUE: colorString += "blue"; break;
+		case CYAN: colorString += "cyan"; break;
+		case GOLD: colorString += "gold"; break;
+		case HOTPINK: colorString += "hotpink"; break;
+		case NAVY: colorString += "navy"; break;
+		case ORANGE: colorString += "orange"; break;
+		case OLIVEDRAB: colorString += "olivedrab"; break;
+		case MAGENTA: colorString += "magenta"; break;
+		default: colorString += "black"; break;
+	}
+
+	return colorString;
+}
 
 template<class VE> void BaseDatapath::ColorWriter::operator()(std::ostream &out, const VE &v) const {
 	unsigned nodeID = vertexNameMap[v];
 
-	assert(nodeID < bbNames.size() && "Node ID out of bounds (bbNames)");
-	assert(nodeID < funcNames.size() && "Node ID out of bounds (funcNames)");
+	assert(nodeID < colorStrings.size() && "Node ID out of bounds (colorStrings)");
 	assert(nodeID < opcodes.size() && "Node ID out of bounds (opcodes)");
 
-	std::string bbName = bbNames.at(nodeID);
-	std::string funcName = funcNames.at(nodeID);
-	llvm::bbFuncNamePairTy bbFuncPair = std::make_pair(bbName, funcName);
-
-	llvm::bbFuncNamePair2lpNameLevelPairMapTy::iterator found = bbFuncNamePair2lpNameLevelPairMap.find(bbFuncPair);
-	if(found != bbFuncNamePair2lpNameLevelPairMap.end()) {
-		std::string colorString = "color=";
-		switch((ColorEnum) found->second.second) {
-			case RED: colorString += "red"; break;
-			case GREEN: colorString += "green"; break;
-			case BLUE: colorString += "blue"; break;
-			case CYAN: colorString += "cyan"; break;
-			case GOLD: colorString += "gold"; break;
-			case HOTPINK: colorString += "hotpink"; break;
-			case NAVY: colorString += "navy"; break;
-			case ORANGE: colorString += "orange"; break;
-			case OLIVEDRAB: colorString += "olivedrab"; break;
-			case MAGENTA: colorString += "magenta"; break;
-			default: colorString += "black"; break;
-		}
-
+	const std::string &colorString = colorStrings[nodeID];
+	if(colorString.size()) {
 		int op = opcodes.at(nodeID);
 
 #ifdef CUSTOM_OPS
@@ -1,6 +1,9 @@
 #include "profile_h/DDDGBuilder.h"
 
+#include <string.h>
+
 #include "profile_h/BaseDatapath.h"
+#include "profile_h/ResultWriter.h"
 
 #ifdef FUTURE_CACHE
 std::string FutureCache::constructKey(
@@ -20,102 +23,68 @@ void FutureCache::dumpSummary(std::ofstream *summaryFile) {
 	*summaryFile << "No. of cache hit: " << std::to_string(cacheHit) << "\n";
 }
 
-bool FutureCache::load() {
-	std::ifstream futureCacheFile;
-
-	futureCacheFile.open(args.workDir + FILE_FUTURE_CACHE, std::ios::in | std::ios::binary);
-	if(futureCacheFile.is_open()) {
-		/* Check for magic bits in future cache file */
-		char magicBits[4];
-		futureCacheFile.read(magicBits, std::string(FILE_FUTURE_CACHE_MAGIC_STRING).size());
-		magicBits[3] = '\0';
-		if(std::string(magicBits) != FILE_FUTURE_CACHE_MAGIC_STRING) {
-			futureCacheFile.close();
-			return false;
-		}
+void FutureCache::writeResults() {
+	resultWriter.writeCacheStats("future", cacheMiss, cacheHit);
+}
 
-		clear();
-		/* Read cache size */
-		size_t mapSize;
-		futureCacheFile.read((char *) &mapSize, sizeof(size_t));
-		/* Now read each element */
-		for(unsigned i = 0; i < mapSize; i++) {
-			size_t keySize;
-			futureCacheFile.read((char *) &keySize, sizeof(size_t));
-
-			char buff[BUFF_STR_SZ];
-			futureCacheFile.read(buff, keySize);
-			buff[keySize] = '\0';
-			std::string key(buff);
-
-			long int gzCursor;
-			futureCacheFile.read((char *) &gzCursor, sizeof(long int));
-			uint64_t byteFrom;
-			futureCacheFile.read((char *) &byteFrom, sizeof(uint64_t));
-			uint64_t instCount;
-			futureCacheFile.read((char *) &instCount, sizeof(uint64_t));
-			long int progressiveTraceCursor;
-			futureCacheFile.read((char *) &progressiveTraceCursor, sizeof(long int));
-			uint64_t progressiveTraceInstCount;
-			futureCacheFile.read((char *) &progressiveTraceInstCount, sizeof(uint64_t));
-			uint64_t lastInstExitingCounter;
-			futureCacheFile.read((char *) &lastInstExitingCounter, sizeof(uint64_t));
-			uint64_t to;
-			futureCacheFile.read((char *) &to, sizeof(uint64_t));
-
-			cache.insert(cache.end(), std::make_pair(
-				key,
-				elemTy(gzCursor, byteFrom, instCount, progressiveTraceCursor, progressiveTraceInstCount, lastInstExitingCounter, to)
-			));
-		}
+bool FutureCache::consumeEntry(const std::string &payload) {
+	size_t pos = 0;
+	std::string key;
+	long int gzCursor;
+	uint64_t byteFrom;
+	uint64_t instCount;
+	long int progressiveTraceCursor;
+	uint64_t progressiveTraceInstCount;
+	uint64_t lastInstExitingCounter;
+	uint64_t to;
+
+	/* Each payload: key, gz cursor, byte from, instruction count, progressive trace cursor and instruction count, last instruction exiting counter, to */
+	if(!AppendLog::extractElement(payload, pos, key) || !AppendLog::extractElement(payload, pos, gzCursor) ||
+		!AppendLog::extractElement(payload, pos, byteFrom) || !AppendLog::extractElement(payload, pos, instCount) ||
+		!AppendLog::extractElement(payload, pos, progressiveTraceCursor) || !AppendLog::extractElement(payload, pos, progressiveTraceInstCount) ||
+		!AppendLog::extractElement(payload, pos, lastInstExitingCounter) || !AppendLog::extractElement(payload, pos, to) ||
+		pos != payload.size())
+		return false;
 
-		futureCacheFile.close();
+	cache.insert(std::make_pair(
+		key,
+		elemTy(gzCursor, byteFrom, instCount, progressiveTraceCursor, progressiveTraceInstCount, lastInstExitingCounter, to)
+	));
 
-		return true;
-	}
-	else {
-		return false;
-	}
+	return true;
 }
 
-void FutureCache::save() {
-	std::ofstream futureCacheFile;
-
-	futureCacheFile.open(args.workDir + FILE_FUTURE_CACHE, std::ios::out | std::ios::binary);
-	if(futureCacheFile.is_open()) {
-		futureCacheFile.write(FILE_FUTURE_CACHE_MAGIC_STRING, std::string(FILE_FUTURE_CACHE_MAGIC_STRING).size());
-
-		/* Save cache size */
-		size_t mapSize = cache.size();
-		futureCacheFile.write((char *) &mapSize, sizeof(size_t));
-		/* Save all elements */
-		for(auto &it : cache) {
-			size_t keySize = it.first.size();
-			futureCacheFile.write((char *) &keySize, sizeof(size_t));
-
-			futureCacheFile.write(it.first.c_str(), keySize);
-
-			futureCacheFile.write((char *) &(it.second.gzCursor), sizeof(long int));
-			futureCacheFile.write((char *) &(it.second.byteFrom), sizeof(uint64_t));
-			futureCacheFile.write((char *) &(it.second.instCount), sizeof(uint64_t));
-			futureCacheFile.write((char *) &(it.second.progressiveTraceCursor), sizeof(long int));
-			futureCacheFile.write((char *) &(it.second.progressiveTraceInstCount), sizeof(uint64_t));
-			futureCacheFile.write((char *) &(it.second.lastInstExitingCounter), sizeof(uint64_t));
-			futureCacheFile.write((char *) &(it.second.to), sizeof(uint64_t));
-		}
+FutureCache::~FutureCache() {
+	save();
+}
 
-		futureCacheFile.close();
-	}
-	else {
-		// TODO assert here?
-	}
+bool FutureCache::load() {
+	clear();
+	save();
+
+	return cacheLog.open(args.workDir + FILE_FUTURE_CACHE, FILE_FUTURE_CACHE_MAGIC_STRING, [this](const std::string &payload) { return consumeEntry(payload); });
+}
+
+// Entries are already in the log when inserted, only the log is closed here
+void FutureCache::save() {
+	cacheLog.close();
 }
 
 FutureCache::iterator FutureCache::find(
 	std::string wholeLoopName, unsigned datapathType,
 	long int progressiveTraceCursor, uint64_t progressiveTraceInstCount
 ) {
-	FutureCache::iterator iter = cache.find(constructKey(wholeLoopName, datapathType, progressiveTraceCursor, progressiveTraceInstCount));
+	std::string key = constructKey(wholeLoopName, datapathType, progressiveTraceCursor, progressiveTraceInstCount);
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	FutureCache::iterator iter = cache.find(key);
+
+	// Other executions may have found this entry in the meantime
+	if(cache.end() == iter && cacheLog.isOpen()) {
+		cacheLog.catchUp([this](const std::string &payload) { return consumeEntry(payload); });
+		iter = cache.find(key);
+	}
 
 	if(cache.end() == iter)
 		cacheMiss++;
@@ -130,29 +99,45 @@ std::pair<FutureCache::iterator, bool> FutureCache::insert(
 	long int progressiveTraceCursor, uint64_t progressiveTraceInstCount,
 	FutureCache::elemTy &elem
 ) {
-	return cache.insert(std::make_pair(
-		constructKey(wholeLoopName, datapathType, progressiveTraceCursor, progressiveTraceInstCount),
-		elem
-	));
+	std::string key = constructKey(wholeLoopName, datapathType, progressiveTraceCursor, progressiveTraceInstCount);
+	std::pair<FutureCache::iterator, bool> result;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	cacheLog.append(
+		[this](const std::string &payload) { return consumeEntry(payload); },
+		[this, &key, &elem, &result](std::string &payload) {
+			result = cache.insert(std::make_pair(key, elem));
+			if(!(result.second))
+				return false;
+
+			AppendLog::appendElement(payload, key);
+			AppendLog::appendElement(payload, elem.gzCursor);
+			AppendLog::appendElement(payload, elem.byteFrom);
+			AppendLog::appendElement(payload, elem.instCount);
+			AppendLog::appendElement(payload, elem.progressiveTraceCursor);
+			AppendLog::appendElement(payload, elem.progressiveTraceInstCount);
+			AppendLog::appendElement(payload, elem.lastInstExitingCounter);
+			AppendLog::appendElement(payload, elem.to);
+
+			return true;
+		}
+	);
+
+	return result;
 }
 #endif
 
 ParsedTraceContainer::ParsedTraceContainer(std::string kernelName) {
-	funcFileName = args.outWorkDir + kernelName + "_dynamicfuncid.gz";
-	instIDFileName = args.outWorkDir + kernelName + "_instid.gz";
 	lineNoFileName = args.outWorkDir + kernelName + "_linenum.gz";
 	memoryTraceFileName = args.outWorkDir + kernelName + "_memaddr.gz";
 	getElementPtrFileName = args.outWorkDir + kernelName + "_getelementptr.gz";
-	prevBasicBlockFileName = args.outWorkDir + kernelName + "_prevbasicblock.gz";
 	currBasicBlockFileName = args.outWorkDir + kernelName + "_currbasicblock.gz";
 	resultSizeFileName = args.outWorkDir + kernelName + "_resultsize.gz";
 
-	funcFile = Z_NULL;
-	instIDFile = Z_NULL;
 	lineNoFile = Z_NULL;
 	memoryTraceFile = Z_NULL;
 	getElementPtrFile = Z_NULL;
-	prevBasicBlockFile = Z_NULL;
 	currBasicBlockFile = Z_NULL;
 	resultSizeFile = Z_NULL;
 
@@ -161,29 +146,28 @@ ParsedTraceContainer::ParsedTraceContainer(std::string kernelName) {
 	keepAliveWrite = false;
 	locked = false;
 
-	funcList.clear();
-	instIDList.clear();
 	lineNoList.clear();
 	memoryTraceList.clear();
 	getElementPtrList.clear();
-	prevBasicBlockList.clear();
 	currBasicBlockList.clear();
 	resultSizeList.clear();
+	staticInstIDList.clear();
+	staticInstList.clear();
+	staticInstMap.clear();
+	functionNameList.clear();
+	functionNameMap.clear();
+	dynamicFunctionMap.clear();
+	basicBlockMap.clear();
+	instructionMap.clear();
 }
 
 ParsedTraceContainer::~ParsedTraceContainer() {
-	if(funcFile)
-		gzclose(funcFile);
-	if(instIDFile)
-		gzclose(instIDFile);
 	if(lineNoFile)
 		gzclose(lineNoFile);
 	if(memoryTraceFile)
 		gzclose(memoryTraceFile);
 	if(getElementPtrFile)
 		gzclose(getElementPtrFile);
-	if(prevBasicBlockFile)
-		gzclose(prevBasicBlockFile);
 	if(currBasicBlockFile)
 		gzclose(currBasicBlockFile);
 	if(resultSizeFile)
@@ -197,18 +181,12 @@ void ParsedTraceContainer::openAndClearAllFiles() {
 	closeAllFiles();
 
 	if(compressed) {
-		funcFile = gzopen(funcFileName.c_str(), "w");
-		assert(funcFile != Z_NULL && "Could not open dynamic funcID file for write");
-		instIDFile = gzopen(instIDFileName.c_str(), "w");
-		assert(instIDFile != Z_NULL && "Could not open instID file for write");
 		lineNoFile = gzopen(lineNoFileName.c_str(), "w");
 		assert(lineNoFile != Z_NULL && "Could not open line num file for write");
 		memoryTraceFile = gzopen(memoryTraceFileName.c_str(), "w");
 		assert(memoryTraceFile != Z_NULL && "Could not open memory trace file for write");
 		getElementPtrFile = gzopen(getElementPtrFileName.c_str(), "w");
 		assert(getElementPtrFile != Z_NULL && "Could not open getelementptr file for write");
-		prevBasicBlockFile = gzopen(prevBasicBlockFileName.c_str(), "w");
-		assert(prevBasicBlockFile != Z_NULL && "Could not open prev BB file for write");
 		currBasicBlockFile = gzopen(currBasicBlockFileName.c_str(), "w");
 		assert(currBasicBlockFile != Z_NULL && "Could not open curr BB file for write");
 		resultSizeFile = gzopen(resultSizeFileName.c_str(), "w");
@@ -224,18 +202,12 @@ void ParsedTraceContainer::openAllFilesForRead() {
 	closeAllFiles();
 
 	if(compressed) {
-		funcFile = gzopen(funcFileName.c_str(), "r");
-		assert(funcFile != Z_NULL && "Could not open dynamic funcID file for read");
-		instIDFile = gzopen(instIDFileName.c_str(), "r");
-		assert(instIDFile != Z_NULL && "Could not open instID file for read");
 		lineNoFile = gzopen(lineNoFileName.c_str(), "r");
 		assert(lineNoFile != Z_NULL && "Could not open line num file for read");
 		memoryTraceFile = gzopen(memoryTraceFileName.c_str(), "r");
 		assert(memoryTraceFile != Z_NULL && "Could not open memory trace file for read");
 		getElementPtrFile = gzopen(getElementPtrFileName.c_str(), "r");
 		assert(getElementPtrFile != Z_NULL && "Could not open getelementptr file for read");
-		prevBasicBlockFile = gzopen(prevBasicBlockFileName.c_str(), "r");
-		assert(prevBasicBlockFile != Z_NULL && "Could not open prev BB file for read");
 		currBasicBlockFile = gzopen(currBasicBlockFileName.c_str(), "r");
 		assert(currBasicBlockFile != Z_NULL && "Could not open curr BB file for read");
 		resultSizeFile = gzopen(resultSizeFileName.c_str(), "r");
@@ -247,28 +219,19 @@ void ParsedTraceContainer::openAllFilesForRead() {
 
 void ParsedTraceContainer::closeAllFiles() {
 	if(compressed) {
-		if(funcFile)
-			gzclose(funcFile);
-		if(instIDFile)
-			gzclose(instIDFile);
 		if(lineNoFile)
 			gzclose(lineNoFile);
 		if(memoryTraceFile)
 			gzclose(memoryTraceFile);
 		if(getElementPtrFile)
 			gzclose(getElementPtrFile);
-		if(prevBasicBlockFile)
-			gzclose(prevBasicBlockFile);
 		if(currBasicBlockFile)
 			gzclose(currBasicBlockFile);
 		if(resultSizeFile)
 			gzclose(resultSizeFile);
-		funcFile = Z_NULL;
-		instIDFile = Z_NULL;
 		lineNoFile = Z_NULL;
 		memoryTraceFile = Z_NULL;
 		getElementPtrFile = Z_NULL;
-		prevBasicBlockFile = Z_NULL;
 		currBasicBlockFile = Z_NULL;
 		resultSizeFile = Z_NULL;
 
@@ -281,50 +244,6 @@ void ParsedTraceContainer::lock() {
 	locked = true;
 }
 
-void ParsedTraceContainer::appendToFuncList(std::string elem) {
-	assert(!locked && "This container is locked, no modification permitted");
-	assert(!keepAliveRead && "This container is open for read, no modification permitted");
-
-	if(compressed) {
-		if(!funcFile) {
-			funcFile = gzopen(funcFileName.c_str(), "a");
-			assert(funcFile != Z_NULL && "Could not open dynamic funcID file for write");
-		}
-
-		gzprintf(funcFile, "%s\n", elem.c_str());
-
-		if(!keepAliveWrite) {
-			gzclose(funcFile);
-			funcFile = Z_NULL;
-		}
-	}
-	else {
-		funcList.push_back(elem);
-	}
-}
-
-void ParsedTraceContainer::appendToInstIDList(std::string elem) {
-	assert(!locked && "This container is locked, no modification permitted");
-	assert(!keepAliveRead && "This container is open for read, no modification permitted");
-
-	if(compressed) {
-		if(!instIDFile) {
-			instIDFile = gzopen(instIDFileName.c_str(), "a");
-			assert(instIDFile != Z_NULL && "Could not open dynamic instID file for write");
-		}
-
-		gzprintf(instIDFile, "%s\n", elem.c_str());
-
-		if(!keepAliveWrite) {
-			gzclose(instIDFile);
-			instIDFile = Z_NULL;
-		}
-	}
-	else {
-		instIDList.push_back(elem);
-	}
-}
-
 void ParsedTraceContainer::appendToLineNoList(int elem) {
 	assert(!locked && "This container is locked, no modification permitted");
 	assert(!keepAliveRead && "This container is open for read, no modification permitted");
@@ -398,28 +317,6 @@ void ParsedTraceContainer::appendToGetElementPtrList(int key, std::string elem,
 	}
 }
 
-void ParsedTraceContainer::appendToPrevBBList(std::string elem) {
-	assert(!locked && "This container is locked, no modification permitted");
-	assert(!keepAliveRead && "This container is open for read, no modification permitted");
-
-	if(compressed) {
-		if(!prevBasicBlockFile) {
-			prevBasicBlockFile = gzopen(prevBasicBlockFileName.c_str(), "a");
-			assert(prevBasicBlockFile != Z_NULL && "Could not open prev BB file for write");
-		}
-
-		gzprintf(prevBasicBlockFile, "%s\n", elem.c_str());
-
-		if(!keepAliveWrite) {
-			gzclose(prevBasicBlockFile);
-			prevBasicBlockFile = Z_NULL;
-		}
-	}
-	else {
-		prevBasicBlockList.push_back(elem);
-	}
-}
-
 void ParsedTraceContainer::appendToCurrBBList(std::string elem) {
 	assert(!locked && "This container is locked, no modification permitted");
 	assert(!keepAliveRead && "This container is open for read, no modification permitted");
@@ -464,66 +361,6 @@ void ParsedTraceContainer::appendToResultSizeList(int key, unsigned elem) {
 	}
 }
 
-const std::vector<std::string> &ParsedTraceContainer::getFuncList() {
-	if(compressed) {
-		assert(!keepAliveWrite && "This container is open for write, no reading permitted");
-
-		if(!funcFile) {
-			funcFile = gzopen(funcFileName.c_str(), "r");
-			assert(funcFile != Z_NULL && "Could not open dynamic funcID file for read");
-		}
-
-		funcList.clear();
-
-		char buffer[BUFF_STR_SZ];
-		while(!gzeof(funcFile)) {
-			if(Z_NULL == gzgets(funcFile, buffer, sizeof(buffer)))
-				continue;
-
-			std::string line(buffer);
-			line.pop_back();
-			funcList.push_back(line);
-		}
-
-		if(!keepAliveRead) {
-			gzclose(funcFile);
-			funcFile = Z_NULL;
-		}
-	}
-
-	return funcList;
-}
-
-const std::vector<std::string> &ParsedTraceContainer::getInstIDList() {
-	if(compressed) {
-		assert(!keepAliveWrite && "This container is open for write, no reading permitted");
-
-		if(!instIDFile) {
-			instIDFile = gzopen(instIDFileName.c_str(), "r");
-			assert(instIDFile != Z_NULL && "Could not open instID file for read");
-		}
-
-		instIDList.clear();
-
-		char buffer[BUFF_STR_SZ];
-		while(!gzeof(instIDFile)) {
-			if(Z_NULL == gzgets(instIDFile, buffer, sizeof(buffer)))
-				continue;
-
-			std::string line(buffer);
-			line.pop_back();
-			instIDList.push_back(line);
-		}
-
-		if(!keepAliveRead) {
-			gzclose(instIDFile);
-			instIDFile = Z_NULL;
-		}
-	}
-
-	return instIDList;
-}
-
 const std::vector<int> &ParsedTraceContainer::getLineNoList() {
 	if(compressed) {
 		assert(!keepAliveWrite && "This container is open for write, no reading permitted");
@@ -618,36 +455,6 @@ const std::unordered_map<int, std::pair<std::string, int64_t>> &ParsedTraceConta
 	return getElementPtrList;
 }
 
-const std::vector<std::string> &ParsedTraceContainer::getPrevBBList() {
-	if(compressed) {
-		assert(!keepAliveWrite && "This container is open for write, no reading permitted");
-
-		if(!prevBasicBlockFile) {
-			prevBasicBlockFile = gzopen(prevBasicBlockFileName.c_str(), "r");
-			assert(prevBasicBlockFile != Z_NULL && "Could not open prev BB file for read");
-		}
-
-		prevBasicBlockList.clear();
-
-		char buffer[BUFF_STR_SZ];
-		while(!gzeof(prevBasicBlockFile)) {
-			if(Z_NULL == gzgets(prevBasicBlockFile, buffer, sizeof(buffer)))
-				continue;
-
-			std::string line(buffer);
-			line.pop_back();
-			prevBasicBlockList.push_back(line);
-		}
-
-		if(!keepAliveRead) {
-			gzclose(prevBasicBlockFile);
-			prevBasicBlockFile = Z_NULL;
-		}
-	}
-
-	return prevBasicBlockList;
-}
-
 const std::vector<std::string> &ParsedTraceContainer::getCurrBBList() {
 	if(compressed) {
 		assert(!keepAliveWrite && "This container is open for write, no reading permitted");
@@ -709,12 +516,87 @@ const std::unordered_map<int, unsigned> &ParsedTraceContainer::getResultSizeList
 	return resultSizeList;
 }
 
-DDDGBuilder::DDDGBuilder(BaseDatapath *datapath, ParsedTraceContainer &PC) : datapath(datapath), PC(PC) {
+unsigned ParsedTraceContainer::getOrInsertID(s2uMap &map, std::string name) {
+	return map.insert(std::make_pair(name, map.size())).first->second;
+}
+
+void ParsedTraceContainer::appendToStaticInstIDList(std::string staticFunction, std::string dynamicFunction, std::string instID, std::string prevBB) {
+	assert(!locked && "This container is locked, no modification permitted");
+	assert(!keepAliveRead && "This container is open for read, no modification permitted");
+
+#ifdef LEGACY_SEPARATOR
+	std::string key = dynamicFunction + "-" + instID + "-" + prevBB;
+#else
+	std::string key = dynamicFunction + GLOBAL_SEPARATOR + instID + GLOBAL_SEPARATOR + prevBB;
+#endif
+	s2uMap::iterator found = staticInstMap.find(key);
+
+	// New static instruction, calculate its attributes only once
+	if(staticInstMap.end() == found) {
+		staticInstTy staticInst;
+
+		unsigned functionID = getOrInsertID(functionNameMap, staticFunction);
+		if(functionID == functionNameList.size())
+			functionNameList.push_back(staticFunction);
+
+		staticInst.functionID = functionID;
+		staticInst.dynamicFunctionID = getOrInsertID(dynamicFunctionMap, dynamicFunction);
+		staticInst.prevBBID = getOrInsertID(basicBlockMap, prevBB);
+#ifdef LEGACY_SEPARATOR
+		staticInst.instructionID = getOrInsertID(instructionMap, staticFunction + "-" + instID);
+#else
+		staticInst.instructionID = getOrInsertID(instructionMap, staticFunction + GLOBAL_SEPARATOR + instID);
+#endif
+		staticInst.flags = 0;
+		if(instID.find("indvars") != std::string::npos)
+			staticInst.flags |= STATIC_INST_INDUCTION;
+
+		found = staticInstMap.insert(std::make_pair(key, staticInstList.size())).first;
+		staticInstList.push_back(staticInst);
+	}
+
+	staticInstIDList.push_back(found->second);
+}
+
+const std::vector<unsigned> &ParsedTraceContainer::getStaticInstIDList() {
+	return staticInstIDList;
+}
+
+const std::vector<staticInstTy> &ParsedTraceContainer::getStaticInstList() {
+	return staticInstList;
+}
+
+const std::vector<std::string> &ParsedTraceContainer::getFunctionNameList() {
+	return functionNameList;
+}
+
+DDDGBuilder::DDDGBuilder(BaseDatapath *datapath, ParsedTraceContainer &PC) :
+	datapath(datapath), PC(PC),
+	registerEdgeTable(ArenaAllocator<u2eMMap::value_type>(arena)), memoryEdgeTable(ArenaAllocator<u2eMMap::value_type>(arena)),
+	addressLastWritten(ArenaAllocator<i642uMap::value_type>(arena))
+{
 	numOfInstructions = -1;
 	lastParameter = true;
 	prevBB = "-1";
 	numOfRegDeps = 0;
 	numOfMemDeps = 0;
+	numOfCarriedDeps = 0;
+	traceBytesRead = 0;
+	traceSeeks = 0;
+}
+
+char *DDDGBuilder::traceGets(gzFile &traceFile, char *buffer, int size) {
+	char *result = gzgets(traceFile, buffer, size);
+
+	if(result != Z_NULL)
+		traceBytesRead += strlen(result);
+
+	return result;
+}
+
+z_off_t DDDGBuilder::traceSeek(gzFile &traceFile, z_off_t offset, int whence) {
+	traceSeeks++;
+	return gzseek(traceFile, offset, whence);
 }
 
 intervalTy DDDGBuilder::getTraceLineFromToBeforeNestedLoop(gzFile &traceFile) {
@@ -748,7 +630,9 @@ intervalTy DDDGBuilder::getTraceLineFromToBeforeNestedLoop(gzFile &traceFile) {
 		std::string funcName = std::get<0>(parseLoopName(loopName));
 		std::string headerBBName = it.second;
 		std::pair<std::string, std::string> headerBBFuncNamePair = std::make_pair(headerBBName, funcName);
-		std::string headerBBLastInst = headerBBFuncNamePair2lastInstMap[headerBBFuncNamePair];
+		// Read-only lookup, since other kernels may be analysed concurrently
+		headerBBFuncNamePair2lastInstMapTy::iterator foundLastInst = headerBBFuncNamePair2lastInstMap.find(headerBBFuncNamePair);
+		std::string headerBBLastInst = (foundLastInst != headerBBFuncNamePair2lastInstMap.end())? foundLastInst->second : "";
 		std::pair<std::string, unsigned> loopNameLevelPair = std::make_pair(loopName, loopLevel);
 		headerBBlastInst2loopNameLevelPairMap.insert(std::make_pair(headerBBLastInst, loopNameLevelPair));
 	}
@@ -773,7 +657,7 @@ intervalTy DDDGBuilder::getTraceLineFromToBeforeNestedLoop(gzFile &traceFile) {
 #ifdef PROGRESSIVE_TRACE_CURSOR
 	if(args.progressive) {
 		VERBOSE_PRINT(errs() << "\t\tUsing progressive trace cursor, skipping " << std::to_string(progressiveTraceCursor) << " bytes from trace\n");
-		gzseek(traceFile, progressiveTraceCursor, SEEK_SET);
+		traceSeek(traceFile, progressiveTraceCursor, SEEK_SET);
 	}
 	else {
 		gzrewind(traceFile);
@@ -794,7 +678,7 @@ intervalTy DDDGBuilder::getTraceLineFromToBeforeNestedLoop(gzFile &traceFile) {
 				VERBOSE_PRINT(errs() << "\t\tCached cursor hit\n");
 				VERBOSE_PRINT(errs() << "\t\tSkipping further " << std::to_string(cacheHit->second.gzCursor - progressiveTraceCursor) << " bytes from trace\n");
 
-				gzseek(traceFile, cacheHit->second.gzCursor, SEEK_SET);
+				traceSeek(traceFile, cacheHit->second.gzCursor, SEEK_SET);
 				byteFrom = cacheHit->second.byteFrom;
 				instCount = cacheHit->second.instCount;
 				progressiveTraceCursor = cacheHit->second.progressiveTraceCursor;
@@ -816,7 +700,7 @@ intervalTy DDDGBuilder::getTraceLineFromToBeforeNestedLoop(gzFile &traceFile) {
 #endif
 
 	while(!gzeof(traceFile)) {
-		if(Z_NULL == gzgets(traceFile, buffer, sizeof(buffer)))
+		if(Z_NULL == traceGets(traceFile, buffer, sizeof(buffer)))
 			continue;
 
 		std::string line(buffer);
@@ -957,7 +841,7 @@ intervalTy DDDGBuilder::getTraceLineFromToAfterNestedLoop(gzFile &traceFile) {
 #ifdef PROGRESSIVE_TRACE_CURSOR
 	if(args.progressive) {
 		VERBOSE_PRINT(errs() << "\t\tUsing progressive trace cursor, skipping " << std::to_string(progressiveTraceCursor) << " bytes from trace\n");
-		gzseek(traceFile, progressiveTraceCursor, SEEK_SET);
+		traceSeek(traceFile, progressiveTraceCursor, SEEK_SET);
 	}
 	else {
 		gzrewind(traceFile);
@@ -978,7 +862,7 @@ intervalTy DDDGBuilder::getTraceLineFromToAfterNestedLoop(gzFile &traceFile) {
 			VERBOSE_PRINT(errs() << "\t\tCached cursor hit\n");
 			VERBOSE_PRINT(errs() << "\t\tSkipping further " << std::to_string(cacheHit->second.gzCursor - progressiveTraceCursor) << " bytes from trace\n");
 
-			gzseek(traceFile, cacheHit->second.gzCursor, SEEK_SET);
+			traceSeek(traceFile, cacheHit->second.gzCursor, SEEK_SET);
 			byteFrom = cacheHit->second.byteFrom;
 			instCount = cacheHit->second.instCount;
 			progressiveTraceCursor = cacheHit->second.progressiveTraceCursor;
@@ -997,7 +881,7 @@ intervalTy DDDGBuilder::getTraceLineFromToAfterNestedLoop(gzFile &traceFile) {
 #endif
 
 	while(!gzeof(traceFile)) {
-		if(Z_NULL == gzgets(traceFile, buffer, sizeof(buffer)))
+		if(Z_NULL == traceGets(traceFile, buffer, sizeof(buffer)))
 			continue;
 
 		std::string line(buffer);
@@ -1087,7 +971,7 @@ intervalTy DDDGBuilder::getTraceLineFromToBetweenAfterAndBefore(gzFile &traceFil
 #ifdef PROGRESSIVE_TRACE_CURSOR
 	if(args.progressive) {
 		VERBOSE_PRINT(errs() << "\t\tUsing progressive trace cursor, skipping " << std::to_string(progressiveTraceCursor) << " bytes from trace\n");
-		gzseek(traceFile, progressiveTraceCursor, SEEK_SET);
+		traceSeek(traceFile, progressiveTraceCursor, SEEK_SET);
 	}
 	else {
 		gzrewind(traceFile);
@@ -1108,7 +992,7 @@ intervalTy DDDGBuilder::getTraceLineFromToBetweenAfterAndBefore(gzFile &traceFil
 			VERBOSE_PRINT(errs() << "\t\tCached cursor hit\n");
 			VERBOSE_PRINT(errs() << "\t\tSkipping further " << std::to_string(cacheHit->second.gzCursor - progressiveTraceCursor) << " bytes from trace\n");
 
-			gzseek(traceFile, cacheHit->second.gzCursor, SEEK_SET);
+			traceSeek(traceFile, cacheHit->second.gzCursor, SEEK_SET);
 			byteFrom = cacheHit->second.byteFrom;
 			instCount = cacheHit->second.instCount;
 
@@ -1125,7 +1009,7 @@ intervalTy DDDGBuilder::getTraceLineFromToBetweenAfterAndBefore(gzFile &traceFil
 #endif
 
 	while(!gzeof(traceFile)) {
-		if(Z_NULL == gzgets(traceFile, buffer, sizeof(buffer)))
+		if(Z_NULL == traceGets(traceFile, buffer, sizeof(buffer)))
 			continue;
 
 		std::string line(buffer);
@@ -1198,19 +1082,39 @@ void DDDGBuilder::buildInitialDDDG() {
 
 	VERBOSE_PRINT(errs() << "\t\tStarted build of initial DDDG\n");
 
-	intervalTy interval = getTraceLineFromTo(traceFile);
+	intervalTy interval;
+	{
+		PHASE_SCOPE(phase, "intervalSearch", datapath->getTargetLoopName(), datapath->getTargetLoopLevel(), datapath->getDatapathType());
+
+		interval = getTraceLineFromTo(traceFile);
+
+		PHASE_COUNTER(phase, "traceBytesRead", traceBytesRead);
+		PHASE_COUNTER(phase, "traceSeeks", traceSeeks);
+	}
 
 	VERBOSE_PRINT(errs() << "\t\tSkipping " << std::to_string(std::get<0>(interval)) << " bytes from trace\n");
 	VERBOSE_PRINT(errs() << "\t\tEnd of interval: " << std::to_string(std::get<1>(interval)) << "\n");
 
-	parseTraceFile(traceFile, interval);
+	traceBytesRead = 0;
+	traceSeeks = 0;
+	{
+		PHASE_SCOPE(phase, "traceParse", datapath->getTargetLoopName(), datapath->getTargetLoopLevel(), datapath->getDatapathType());
+
+		parseTraceFile(traceFile, interval);
+
+		writeDDDG();
+		writeLoopCarriedEdges();
 
-	writeDDDG();
+		PHASE_COUNTER(phase, "traceBytesRead", traceBytesRead);
+		PHASE_COUNTER(phase, "traceSeeks", traceSeeks);
+	}
 
 	VERBOSE_PRINT(errs() << "\t\tNumber of nodes: " << std::to_string(datapath->getNumNodes()) << "\n");
 	VERBOSE_PRINT(errs() << "\t\tNumber of edges: " << std::to_string(datapath->getNumEdges()) << "\n");
 	VERBOSE_PRINT(errs() << "\t\tNumber of register dependencies: " << std::to_string(getNumOfRegisterDependencies()) << "\n");
 	VERBOSE_PRINT(errs() << "\t\tNumber of memory dependencies: " << std::to_string(getNumOfMemoryDependencies()) << "\n");
+	if(args.fModuloScheduling)
+		VERBOSE_PRINT(errs() << "\t\tNumber of loop-carried dependencies: " << std::to_string(getNumOfLoopCarriedDependencies()) << "\n");
 	VERBOSE_PRINT(errs() << "\t\tDDDG build finished\n");
 }
 
@@ -1226,14 +1130,27 @@ void DDDGBuilder::buildInitialDDDG(intervalTy interval) {
 	VERBOSE_PRINT(errs() << "\t\tSkipping " << std::to_string(std::get<0>(interval)) << " bytes from trace\n");
 	VERBOSE_PRINT(errs() << "\t\tEnd of interval: " << std::to_string(std::get<1>(interval)) << "\n");
 
-	parseTraceFile(traceFile, interval);
+	// The interval was found externally, so that trace I/O performed so far is reported by the caller
+	traceBytesRead = 0;
+	traceSeeks = 0;
+	{
+		PHASE_SCOPE(phase, "traceParse", datapath->getTargetLoopName(), datapath->getTargetLoopLevel(), datapath->getDatapathType());
+
+		parseTraceFile(traceFile, interval);
 
-	writeDDDG();
+		writeDDDG();
+		writeLoopCarriedEdges();
+
+		PHASE_COUNTER(phase, "traceBytesRead", traceBytesRead);
+		PHASE_COUNTER(phase, "traceSeeks", traceSeeks);
+	}
 
 	VERBOSE_PRINT(errs() << "\t\tNumber of nodes: " << std::to_string(datapath->getNumNodes()) << "\n");
 	VERBOSE_PRINT(errs() << "\t\tNumber of edges: " << std::to_string(datapath->getNumEdges()) << "\n");
 	VERBOSE_PRINT(errs() << "\t\tNumber of register dependencies: " << std::to_string(getNumOfRegisterDependencies()) << "\n");
 	VERBOSE_PRINT(errs() << "\t\tNumber of memory dependencies: " << std::to_string(getNumOfMemoryDependencies()) << "\n");
+	if(args.fModuloScheduling)
+		VERBOSE_PRINT(errs() << "\t\tNumber of loop-carried dependencies: " << std::to_string(getNumOfLoopCarriedDependencies()) << "\n");
 	VERBOSE_PRINT(errs() << "\t\tDDDG build finished\n");
 }
 
@@ -1245,6 +1162,22 @@ unsigned DDDGBuilder::getNumOfMemoryDependencies() {
 	return numOfMemDeps;
 }
 
+unsigned DDDGBuilder::getNumOfLoopCarriedDependencies() {
+	return numOfCarriedDeps;
+}
+
+uint64_t DDDGBuilder::getTraceBytesRead() {
+	return traceBytesRead;
+}
+
+uint64_t DDDGBuilder::getTraceSeeks() {
+	return traceSeeks;
+}
+
+uint64_t DDDGBuilder::getArenaBytes() {
+	return arena.getBytesAllocated();
+}
+
 intervalTy DDDGBuilder::getTraceLineFromTo(gzFile &traceFile) {
 	std::string loopName = datapath->getTargetLoopName();
 	unsigned loopLevel = datapath->getTargetLoopLevel();
@@ -1288,7 +1221,9 @@ intervalTy DDDGBuilder::getTraceLineFromTo(gzFile &traceFile) {
 		std::string funcName = std::get<0>(parseLoopName(loopName));
 		std::string headerBBName = it.second;
 		std::pair<std::string, std::string> headerBBFuncNamePair = std::make_pair(headerBBName, funcName);
-		std::string headerBBLastInst = headerBBFuncNamePair2lastInstMap[headerBBFuncNamePair];
+		// Read-only lookup, since other kernels may be analysed concurrently
+		headerBBFuncNamePair2lastInstMapTy::iterator foundLastInst = headerBBFuncNamePair2lastInstMap.find(headerBBFuncNamePair);
+		std::string headerBBLastInst = (foundLastInst != headerBBFuncNamePair2lastInstMap.end())? foundLastInst->second : "";
 		std::pair<std::string, unsigned> loopNameLevelPair = std::make_pair(loopName, loopLevel);
 		headerBBlastInst2loopNameLevelPairMap.insert(std::make_pair(headerBBLastInst, loopNameLevelPair));
 	}
@@ -1313,7 +1248,7 @@ intervalTy DDDGBuilder::getTraceLineFromTo(gzFile &traceFile) {
 #ifdef PROGRESSIVE_TRACE_CURSOR
 	if(args.progressive) {
 		VERBOSE_PRINT(errs() << "\t\tUsing progressive trace cursor, skipping " << std::to_string(progressiveTraceCursor) << " bytes from trace\n");
-		gzseek(traceFile, progressiveTraceCursor, SEEK_SET);
+		traceSeek(traceFile, progressiveTraceCursor, SEEK_SET);
 	}
 	else {
 		gzrewind(traceFile);
@@ -1334,7 +1269,7 @@ intervalTy DDDGBuilder::getTraceLineFromTo(gzFile &traceFile) {
 				VERBOSE_PRINT(errs() << "\t\tCached cursor hit\n");
 				VERBOSE_PRINT(errs() << "\t\tSkipping further " << std::to_string(cacheHit->second.gzCursor - progressiveTraceCursor) << " bytes from trace\n");
 
-				gzseek(traceFile, cacheHit->second.gzCursor, SEEK_SET);
+				traceSeek(traceFile, cacheHit->second.gzCursor, SEEK_SET);
 				byteFrom = cacheHit->second.byteFrom;
 				instCount = cacheHit->second.instCount;
 				progressiveTraceCursor = cacheHit->second.progressiveTraceCursor;
@@ -1362,7 +1297,7 @@ intervalTy DDDGBuilder::getTraceLineFromTo(gzFile &traceFile) {
 #endif
 
 	while(!gzeof(traceFile)) {
-		if(Z_NULL == gzgets(traceFile, buffer, sizeof(buffer)))
+		if(Z_NULL == traceGets(traceFile, buffer, sizeof(buffer)))
 			continue;
 
 		std::string line(buffer);
@@ -1485,9 +1420,9 @@ void DDDGBuilder::parseTraceFile(gzFile &traceFile, intervalTy interval) {
 	char buffer[BUFF_STR_SZ];
 
 	// Iterate through dynamic trace, but only process the specified interval
-	gzseek(traceFile, from, SEEK_SET);
+	traceSeek(traceFile, from, SEEK_SET);
 	while(!gzeof(traceFile)) {
-		if(Z_NULL == gzgets(traceFile, buffer, sizeof(buffer)))
+		if(Z_NULL == traceGets(traceFile, buffer, sizeof(buffer)))
 			continue;
 
 		std::string line(buffer);
@@ -1634,10 +1569,8 @@ void DDDGBuilder::parseInstructionLine() {
 	currBB = bbID;
 
 	// Store collected info to compressed files or memory lists
-	PC.appendToFuncList(currDynamicFunction);
-	PC.appendToInstIDList(currInstID);
+	PC.appendToStaticInstIDList(currStaticFunction, currDynamicFunction, currInstID, prevBB);
 	PC.appendToLineNoList(lineNo);
-	PC.appendToPrevBBList(prevBB);
 	PC.appendToCurrBBList(currBB);
 
 	// Reset variables for the following lines
@@ -1753,8 +1686,19 @@ void DDDGBuilder::parseParameter(int param) {
 		bool processDep = true;
 		if(isPhiOp(currMicroop)) {
 			std::string operandBB = instName2bbNameMap.at(label);
-			if(operandBB != prevBB)
+			if(operandBB != prevBB) {
 				processDep = false;
+
+				// This operand may be written later in this DDDG (i.e. by the previous iteration, such as the loop latch)
+				if(args.fModuloScheduling) {
+#ifdef LEGACY_SEPARATOR
+					std::string uniqueRegID = currDynamicFunction + "-" + label;
+#else
+					std::string uniqueRegID = currDynamicFunction + GLOBAL_SEPARATOR + label;
+#endif
+					phiCarriedCandidates.push_back(std::make_pair(numOfInstructions, uniqueRegID));
+				}
+			}
 		}
 
 		// Process register dependency
@@ -1809,6 +1753,10 @@ void DDDGBuilder::parseParameter(int param) {
 					numOfMemDeps++;
 				}
 			}
+			// No store to this address so far. If one appears later, its value is consumed by the next iteration
+			else if(args.fModuloScheduling) {
+				loadCarriedCandidates.push_back(std::make_pair(numOfInstructions, addr));
+			}
 
 			std::string baseLabel = parameterLabelPerInst.back();
 			PC.appendToGetElementPtrList(numOfInstructions, baseLabel, addr);
@@ -1846,7 +1794,7 @@ bool DDDGBuilder::lookaheadIsSameLoopLevel(gzFile &traceFile, unsigned loopLevel
 	bool result = false;
 
 	while(!gzeof(traceFile)) {
-		if(Z_NULL == gzgets(traceFile, buffer, sizeof(buffer)))
+		if(Z_NULL == traceGets(traceFile, buffer, sizeof(buffer)))
 			continue;
 
 		std::string line(buffer);
@@ -1880,7 +1828,7 @@ bool DDDGBuilder::lookaheadIsSameLoopLevel(gzFile &traceFile, unsigned loopLevel
 	}
 
 	// Rollback
-	gzseek(traceFile, -rollbackBytes, SEEK_CUR);
+	traceSeek(traceFile, -rollbackBytes, SEEK_CUR);
 
 	return result;
 }
@@ -1892,3 +1840,27 @@ void DDDGBuilder::writeDDDG() {
 	for(auto &it : memoryEdgeTable)
 		datapath->insertDDDGEdge(it.first, it.second.sink, it.second.paramID);
 }
+
+void DDDGBuilder::writeLoopCarriedEdges() {
+	// Register dependency: the last write to a PHI operand register feeds the PHI of the next iteration
+	for(auto &it : phiCarriedCandidates) {
+		s2uMap::iterator found = registerLastWritten.find(it.second);
+		if(found != registerLastWritten.end() && found->second > it.first) {
+			datapath->insertLoopCarriedEdge(found->second, it.first, 1);
+			numOfCarriedDeps++;
+		}
+	}
+
+	// Memory dependency: the last store to an address feeds a load that read this address before any store
+	// XXX: Only loads and stores with the same address in this DDDG are considered (e.g. scalars kept in memory)
+	for(auto &it : loadCarriedCandidates) {
+		i642uMap::iterator found = addressLastWritten.find(it.second);
+		if(found != addressLastWritten.end() && found->second > it.first) {
+			datapath->insertLoopCarriedEdge(found->second, it.first, 1);
+			numOfCarriedDeps++;
+		}
+	}
+
+	std::vector<std::pair<unsigned, std::string>>().swap(phiCarriedCandidates);
+	std::vector<std::pair<unsigned, int64_t>>().swap(loadCarriedCandidates);
+}
@@ -21,10 +21,13 @@ DynamicDatapath::DynamicDatapath(
 DynamicDatapath::DynamicDatapath(
 	std::string kernelName, ConfigurationManager &CM, std::ofstream *summaryFile,
 	std::string loopName, unsigned loopLevel, uint64_t loopUnrollFactor,
-	bool enablePipelining, uint64_t asapII
+	bool enablePipelining, uint64_t asapII, const std::vector<uint64_t> &sweepASAPII
 ) : BaseDatapath(kernelName, CM, summaryFile, loopName, loopLevel, loopUnrollFactor, enablePipelining, asapII) {
 	VERBOSE_PRINT(errs() << "[][][][dynamicDatapath] Analysing DDDG for loop \"" << loopName << "\"\n");
 
+	// Per-clock ASAP II values, used when a clock sweep is performed with pipelining
+	this->sweepASAPII = sweepASAPII;
+
 	initBaseAddress();
 
 	if(args.showPreOptDDDG)
@@ -52,22 +55,37 @@ DynamicDatapath::DynamicDatapath(
 	traceFile = gzopen(traceFileName.c_str(), "r");
 	assert(traceFile != Z_NULL && "Could not open trace input file");
 
-	builder = new DDDGBuilder(this, PC);
-	intervalTy interval;
-	if(DatapathType::NON_PERFECT_BEFORE == datapathType)
-		interval = builder->getTraceLineFromToBeforeNestedLoop(traceFile);
-	else if(DatapathType::NON_PERFECT_BETWEEN == datapathType)
-		interval = builder->getTraceLineFromToBetweenAfterAndBefore(traceFile);
-	else if(DatapathType::NON_PERFECT_AFTER == datapathType)
-		interval = builder->getTraceLineFromToAfterNestedLoop(traceFile);
-	else
-		assert(false && "Invalid type of datapath passed to this type of dynamic datapath constructor");
+	{
+		PHASE_SCOPE(dddgPhase, "dddgBuild", loopName, loopLevel, datapathType);
+
+		builder = new DDDGBuilder(this, PC);
+		intervalTy interval;
+		{
+			PHASE_SCOPE(phase, "intervalSearch", loopName, loopLevel, datapathType);
+
+			if(DatapathType::NON_PERFECT_BEFORE == datapathType)
+				interval = builder->getTraceLineFromToBeforeNestedLoop(traceFile);
+			else if(DatapathType::NON_PERFECT_BETWEEN == datapathType)
+				interval = builder->getTraceLineFromToBetweenAfterAndBefore(traceFile);
+			else if(DatapathType::NON_PERFECT_AFTER == datapathType)
+				interval = builder->getTraceLineFromToAfterNestedLoop(traceFile);
+			else
+				assert(false && "Invalid type of datapath passed to this type of dynamic datapath constructor");
 
-	builder->buildInitialDDDG(interval);
-	delete builder;
-	builder = nullptr;
+			PHASE_COUNTER(phase, "traceBytesRead", builder->getTraceBytesRead());
+			PHASE_COUNTER(phase, "traceSeeks", builder->getTraceSeeks());
+		}
 
-	postDDDGBuild();
+		builder->buildInitialDDDG(interval);
+		PHASE_COUNTER(dddgPhase, "arenaBytes", builder->getArenaBytes());
+		delete builder;
+		builder = nullptr;
+
+		postDDDGBuild();
+
+		PHASE_COUNTER(dddgPhase, "nodes", getNumNodes());
+		PHASE_COUNTER(dddgPhase, "edges", getNumEdges());
+	}
 
 	VERBOSE_PRINT(errs() << "[][][][][dynamicDatapath] Analysing DDDG for loop \"" << loopName << "\"\n");
 
@@ -85,6 +103,29 @@ DynamicDatapath::DynamicDatapath(
 #endif
 }
 
+// Constructor used for extrapolation samples (see Extrapolator). The estimation is returned as a result record
+// instead of being written (summaryFile is expected to be discarded by the caller). If the DDDG has no latency,
+// sample is left untouched
+DynamicDatapath::DynamicDatapath(
+	std::string kernelName, ConfigurationManager &CM, std::ofstream *summaryFile,
+	std::string loopName, unsigned loopLevel, uint64_t loopUnrollFactor,
+	bool enablePipelining, uint64_t asapII, ResultWriter::recordTy &sample
+) : BaseDatapath(kernelName, CM, summaryFile, loopName, loopLevel, loopUnrollFactor, enablePipelining, asapII) {
+	VERBOSE_PRINT(errs() << "[][][][dynamicDatapath] Analysing DDDG for loop \"" << loopName << "\" (extrapolation sample)\n");
+
+	deferResults = true;
+
+	initBaseAddress();
+
+	numCycles = fpgaEstimation();
+
+	if(deferredResults.size())
+		sample = deferredResults.back();
+	deferredResults.clear();
+
+	VERBOSE_PRINT(errs() << "[][][][dynamicDatapath] Finished\n");
+}
+
 DynamicDatapath::~DynamicDatapath() {}
 
 uint64_t DynamicDatapath::getASAPII() const {
@@ -102,8 +143,8 @@ void DynamicDatapath::printDatabase() {
 		errs() << "-- " << std::to_string(x) << "\n";
 	errs() << "-- --------\n";
 	errs() << "-- nameToVertex\n";
-	for(auto const &x : nameToVertex)
-		errs() << "-- " << std::to_string(x.first) << ": " << x.second << "\n";
+	for(unsigned i = 0; i < nameToVertex.size(); i++)
+		errs() << "-- " << std::to_string(i) << ": " << nameToVertex[i] << "\n";
 	errs() << "-- ------------\n";
 	errs() << "-- vertexToName\n";
 	VertexIterator vi, viEnd;
@@ -129,7 +170,7 @@ void DynamicDatapath::printDatabase() {
 	errs() << "-- --------------------\n";
 	errs() << "-- dynamicMemoryOps\n";
 	for(auto const &x : dynamicMemoryOps)
-		errs() << "-- " << x << "\n";
+		errs() << "-- " << std::to_string(x) << "\n";
 	errs() << "-- ----------------\n";
 	errs() << "-- asapScheduledTime\n";
 	for(auto const &x : asapScheduledTime)
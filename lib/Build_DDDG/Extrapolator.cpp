@@ -0,0 +1,314 @@
+#include "profile_h/Extrapolator.h"
+
+#include <cmath>
+
+Extrapolator::Extrapolator(
+	std::string kernelName, ConfigurationManager &CM, std::ofstream *summaryFile,
+	std::string loopName, unsigned loopLevel, uint64_t unrollFactor, uint64_t loopBound, bool enablePipelining
+) :
+	kernelName(kernelName), CM(CM), summaryFile(summaryFile),
+	loopName(loopName), loopLevel(loopLevel), unrollFactor(unrollFactor), loopBound(loopBound), enablePipelining(enablePipelining)
+{
+	firstFitSample = 0;
+	cyclesBound = 0;
+}
+
+bool Extrapolator::isApplicable(uint64_t unrollFactor) {
+	// Clock sweeps and non-perfect loop analysis generate several summary entries per loop, these are always exact
+	return args.fExtrapolate && !(args.fNPLA) && 1 == args.clockTargets.size() && unrollFactor >= EXTRAPOLATION_MIN_UNROLL_FACTOR;
+}
+
+std::map<std::string, double> Extrapolator::getValues(const ResultWriter::recordTy &record) {
+	std::map<std::string, double> values;
+
+	values["asapIL"] = record.asapIL;
+	values["rcIL"] = record.rcIL;
+	values["II"] = record.II;
+	values["resIIMem"] = record.resIIMem;
+	values["resIIOp"] = record.resIIOp;
+	values["recII"] = record.recII;
+	values["sharedLoads"] = record.sharedLoads;
+	values["repeatedStores"] = record.repeatedStores;
+	values["dsps"] = record.dsps;
+	values["ffs"] = record.ffs;
+	values["luts"] = record.luts;
+	values["bram18k"] = record.bram18k;
+
+	// Integer values of the pack (e.g. units of each hardware class, partitions and BRAM18k per array)
+	for(auto &it : record.fields) {
+		if(it.numeric && std::string::npos == it.value.find('.'))
+			values["f~" + it.name] = std::stod(it.value);
+	}
+
+	// Merged resource lists/trees
+	for(auto &it : record.resources) {
+		values["r~" + it.name + "~fus"] = it.fus;
+		values["r~" + it.name + "~dsps"] = it.dsps;
+		values["r~" + it.name + "~ffs"] = it.ffs;
+		values["r~" + it.name + "~luts"] = it.luts;
+	}
+
+	return values;
+}
+
+// Least squares fit of y = intercept + slope * x
+Extrapolator::fitTy Extrapolator::fit(const std::vector<double> &x, const std::vector<double> &y) {
+	fitTy f;
+	f.n = x.size();
+
+	double meanY = 0;
+	f.meanX = 0;
+	for(unsigned i = 0; i < f.n; i++) {
+		f.meanX += x[i];
+		meanY += y[i];
+	}
+	f.meanX /= f.n;
+	meanY /= f.n;
+
+	double sxy = 0;
+	f.sxx = 0;
+	for(unsigned i = 0; i < f.n; i++) {
+		f.sxx += (x[i] - f.meanX) * (x[i] - f.meanX);
+		sxy += (x[i] - f.meanX) * (y[i] - meanY);
+	}
+	f.slope = sxy / f.sxx;
+	f.intercept = meanY - f.slope * f.meanX;
+
+	double ssr = 0, maxDeviation = 0, maxY = 1;
+	for(unsigned i = 0; i < f.n; i++) {
+		double deviation = y[i] - predict(f, x[i]);
+		ssr += deviation * deviation;
+		maxDeviation = std::max(maxDeviation, std::fabs(deviation));
+		maxY = std::max(maxY, std::fabs(y[i]));
+	}
+	f.residual = maxDeviation / maxY;
+	f.stdError = (f.n > 2)? std::sqrt(ssr / (f.n - 2)) : 0;
+
+	return f;
+}
+
+double Extrapolator::predict(const fitTy &f, double x) {
+	return f.intercept + f.slope * x;
+}
+
+// Half-width of the prediction interval at x (one standard error), which grows with the distance from the samples
+double Extrapolator::getPredictionBound(const fitTy &f, double x) {
+	return f.stdError * std::sqrt(1 + 1.0 / f.n + (x - f.meanX) * (x - f.meanX) / f.sxx);
+}
+
+bool Extrapolator::sample(uint64_t factor) {
+	VERBOSE_PRINT(errs() << "[][][][extrapolator] Estimating sample with unroll factor " << std::to_string(factor) << "\n");
+
+	// Same recurrence-constrained II calculation as performed for the actual unroll factor
+	uint64_t recII = 0;
+	if(enablePipelining && !(args.fModuloScheduling)) {
+		uint64_t recIIUnrollFactor = (loopBound && loopBound < (factor << 1))? loopBound : (factor << 1);
+		DynamicDatapath DD(kernelName, CM, &discardedSummary, loopName, loopLevel, recIIUnrollFactor);
+		recII = DD.getASAPII();
+	}
+
+	ResultWriter::recordTy record;
+	DynamicDatapath DD(kernelName, CM, &discardedSummary, loopName, loopLevel, factor, enablePipelining, recII, record);
+
+	// DDDGs with no latency are not estimated
+	if(record.loopName.empty())
+		return false;
+
+	factors.push_back(factor);
+	samples.push_back(record);
+	referencedArrays = DD.getReferencedArrays();
+
+	return true;
+}
+
+bool Extrapolator::extrapolate() {
+	for(uint64_t factor = 1; samples.size() < EXTRAPOLATION_NUM_SAMPLES && factor < unrollFactor; factor <<= 1) {
+		if(loopBound && factor > loopBound)
+			break;
+
+		if(!sample(factor)) {
+			VERBOSE_PRINT(errs() << "[][][][extrapolator] Sample has no latency, extrapolation is not possible\n");
+			return false;
+		}
+	}
+
+	if(samples.size() < EXTRAPOLATION_MIN_FIT_SAMPLES) {
+		VERBOSE_PRINT(errs() << "[][][][extrapolator] Not enough samples, extrapolation is not possible\n");
+		return false;
+	}
+
+	// Only values present in all samples are extrapolated
+	std::vector<std::map<std::string, double>> values;
+	for(auto &it : samples)
+		values.push_back(getValues(it));
+	std::map<std::string, double> common = values.back();
+	for(auto &it : values) {
+		for(std::map<std::string, double>::iterator it2 = common.begin(); it2 != common.end();) {
+			if(it.end() == it.find(it2->first))
+				it2 = common.erase(it2);
+			else
+				it2++;
+		}
+	}
+
+	// Leading samples are dropped until all values grow linearly (steady state)
+	std::map<std::string, fitTy> fits;
+	bool steady = false;
+	for(firstFitSample = 0; !steady && samples.size() - firstFitSample >= EXTRAPOLATION_MIN_FIT_SAMPLES; firstFitSample++) {
+		std::vector<double> x(factors.begin() + firstFitSample, factors.end());
+		double maxResidual = 0;
+
+		fits.clear();
+		for(auto &it : common) {
+			std::vector<double> y;
+			for(unsigned i = firstFitSample; i < values.size(); i++)
+				y.push_back(values[i].at(it.first));
+
+			fitTy f = fit(x, y);
+			fits.insert(std::make_pair(it.first, f));
+			maxResidual = std::max(maxResidual, f.residual);
+		}
+
+		VERBOSE_PRINT(errs() << "[][][][extrapolator] Fit from unroll factor " << std::to_string(factors[firstFitSample]) <<
+			": maximum residual of " << std::to_string(100 * maxResidual) << " %\n");
+
+		steady = maxResidual <= args.extrapolationTolerance;
+	}
+
+	if(!steady) {
+		VERBOSE_PRINT(errs() << "[][][][extrapolator] No steady state found within tolerance, extrapolation is not possible\n");
+		return false;
+	}
+	firstFitSample--;
+
+	auto getPrediction = [this, &fits](std::string key) {
+		double prediction = std::round(predict(fits.at(key), unrollFactor));
+		return (uint64_t) ((prediction > 0)? prediction : 0);
+	};
+
+	// Values that are not extrapolated are kept from the largest sample
+	result = samples.back();
+	result.unrollFactor = unrollFactor;
+	result.asapIL = getPrediction("asapIL");
+	result.rcIL = getPrediction("rcIL");
+	result.resIIMem = getPrediction("resIIMem");
+	result.resIIOp = getPrediction("resIIOp");
+	result.recII = getPrediction("recII");
+	result.sharedLoads = getPrediction("sharedLoads");
+	result.repeatedStores = getPrediction("repeatedStores");
+	result.dsps = getPrediction("dsps");
+	result.ffs = getPrediction("ffs");
+	result.luts = getPrediction("luts");
+	result.bram18k = getPrediction("bram18k");
+	for(auto &it : result.fields) {
+		if(fits.count("f~" + it.name))
+			it.value = std::to_string(getPrediction("f~" + it.name));
+	}
+	for(auto &it : result.resources) {
+		if(fits.count("r~" + it.name + "~fus")) {
+			it.fus = getPrediction("r~" + it.name + "~fus");
+			it.dsps = getPrediction("r~" + it.name + "~dsps");
+			it.ffs = getPrediction("r~" + it.name + "~ffs");
+			it.luts = getPrediction("r~" + it.name + "~luts");
+		}
+	}
+	for(auto &it : samples)
+		result.achievedPeriod = std::max(result.achievedPeriod, it.achievedPeriod);
+
+	// II is never below its constraints
+	uint64_t constrainedII = std::max(std::max(result.resIIMem, result.resIIOp), result.recII);
+	result.II = std::max(getPrediction("II"), constrainedII);
+
+	// Same criteria as BaseDatapath::dumpSummary()
+	if(result.resIIMem > result.resIIOp && result.resIIMem > result.recII && result.resIIMem > 1)
+		result.limitedBy = "memory";
+	else if(result.resIIOp > result.resIIMem && result.resIIOp > result.recII && result.resIIOp > 1)
+		result.limitedBy = "operation";
+	else if(result.recII > result.resIIMem && result.recII > result.resIIOp && result.recII > 1)
+		result.limitedBy = "recurrence";
+	else
+		result.limitedBy = "none";
+
+	result.cycles = BaseDatapath::getLoopTotalLatency(loopName, loopLevel, enablePipelining, result.rcIL, result.II);
+
+	// Cycles are bounded by moving IL and II to the upper end of their prediction intervals
+	uint64_t rcILBound = std::ceil(getPredictionBound(fits.at("rcIL"), unrollFactor));
+	uint64_t IIBound = std::ceil(getPredictionBound(fits.at("II"), unrollFactor));
+	cyclesBound = BaseDatapath::getLoopTotalLatency(loopName, loopLevel, enablePipelining, result.rcIL + rcILBound, result.II + IIBound) - result.cycles;
+
+	std::string sampledFactors = std::to_string(factors[firstFitSample]);
+	for(unsigned i = firstFitSample + 1; i < factors.size(); i++)
+		sampledFactors += "," + std::to_string(factors[i]);
+	result.fields.push_back({"Extrapolated from unroll factors", false, sampledFactors});
+	result.fields.push_back({"Extrapolation error bound (cycles)", true, std::to_string(cyclesBound)});
+
+	VERBOSE_PRINT(errs() << "[][][][extrapolator] Extrapolated from unroll factors " << sampledFactors << ": " <<
+		std::to_string(result.cycles) << " +/- " << std::to_string(cyclesBound) << " cycles\n");
+
+	return true;
+}
+
+uint64_t Extrapolator::getCycles() const {
+	return result.cycles;
+}
+
+std::set<std::string> Extrapolator::getReferencedArrays() const {
+	return referencedArrays;
+}
+
+void Extrapolator::dumpSummary() {
+	*summaryFile << "================================================\n";
+	if(args.fNoTCS)
+		*summaryFile << "Time-constrained scheduling disabled\n";
+	*summaryFile << "Target clock: " << std::to_string(result.frequency) << " MHz\n";
+	*summaryFile << "Clock uncertainty: " << std::to_string(result.uncertainty) << " %\n";
+	*summaryFile << "Target clock period: " << std::to_string(1000 / result.frequency) << " ns\n";
+	*summaryFile << "Effective clock period: " << std::to_string(result.effectivePeriod) << " ns\n";
+	*summaryFile << "Achieved clock period: " << std::to_string(result.achievedPeriod) << " ns\n";
+	*summaryFile << "Loop name: " << loopName << "\n";
+	*summaryFile << "Loop level: " << std::to_string(loopLevel) << "\n";
+	*summaryFile << "DDDG type: full loop body (extrapolated)\n";
+	*summaryFile << "Loop unrolling factor: " << std::to_string(unrollFactor) << "\n";
+	*summaryFile << "Loop pipelining enabled? " << (enablePipelining? "yes" : "no") << "\n";
+	*summaryFile << "Total cycles: " << std::to_string(result.cycles) << "\n";
+	*summaryFile << "------------------------------------------------\n";
+
+	if(result.sharedLoads)
+		*summaryFile << "Number of shared loads detected: " << std::to_string(result.sharedLoads) << "\n";
+	if(result.repeatedStores)
+		*summaryFile << "Number of repeated stores detected: " << std::to_string(result.repeatedStores) << "\n";
+	if(result.sharedLoads || result.repeatedStores)
+		*summaryFile << "------------------------------------------------\n";
+
+	*summaryFile << "Ideal iteration latency (ASAP): " << std::to_string(result.asapIL) << "\n";
+	*summaryFile << "Constrained iteration latency: " << std::to_string(result.rcIL) << "\n";
+	*summaryFile << "Initiation interval (if applicable): " << std::to_string(result.II) << "\n";
+	*summaryFile << "resII (mem): " << std::to_string(result.resIIMem) << "\n";
+	*summaryFile << "resII (op): " << std::to_string(result.resIIOp) << "\n";
+	*summaryFile << "recII: " << std::to_string(result.recII) << "\n";
+
+	*summaryFile << "Limited by ";
+	if("memory" == result.limitedBy)
+		*summaryFile << "memory, array name: " << result.resIIMemArray << "\n";
+	else if("operation" == result.limitedBy)
+		*summaryFile << "floating point operation: " << result.resIIOpUnit << "\n";
+	else if("recurrence" == result.limitedBy)
+		*summaryFile << "loop-carried dependency\n";
+	else
+		*summaryFile << "none\n";
+	*summaryFile << "------------------------------------------------\n";
+
+	// Pack values, in the same order as the largest sample
+	for(auto &it : result.fields) {
+		*summaryFile << it.name << ": " << it.value << "\n";
+
+		if("Units limited by DSP usage" == it.name)
+			*summaryFile << "------------------------------------------------\n";
+	}
+	*summaryFile << "DSPs: " << std::to_string(result.dsps) << "\n";
+	*summaryFile << "FFs: " << std::to_string(result.ffs) << "\n";
+	*summaryFile << "LUTs: " << std::to_string(result.luts) << "\n";
+	*summaryFile << "BRAM18k: " << std::to_string(result.bram18k) << "\n";
+
+	resultWriter.write(result);
+}
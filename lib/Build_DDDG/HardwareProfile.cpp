@@ -1,6 +1,8 @@
 #include "profile_h/HardwareProfile.h"
 
-HardwareProfile::HardwareProfile() {
+HardwareProfile::HardwareProfile(double frequency, double uncertainty) : frequency(frequency), uncertainty(uncertainty) {
+	effectivePeriod = (1000 / frequency) - (10 * uncertainty / frequency);
+
 	fAddCount = 0;
 	fSubCount = 0;
 	fMulCount = 0;
@@ -31,18 +33,22 @@ HardwareProfile::HardwareProfile() {
 }
 
 HardwareProfile *HardwareProfile::createInstance() {
+	return createInstance(args.frequency, args.uncertainty);
+}
+
+HardwareProfile *HardwareProfile::createInstance(double frequency, double uncertainty) {
 	switch(args.target) {
 		case ArgPack::TARGET_XILINX_VC707:
 			assert(args.fNoTCS && "Time-constrained scheduling is currently not supported with the selected platform. Please activate the \"--fno-tcs\" flag");
-			return new XilinxVC707HardwareProfile();
+			return new XilinxVC707HardwareProfile(frequency, uncertainty);
 		case ArgPack::TARGET_XILINX_ZCU102:
-			return new XilinxZCU102HardwareProfile();
+			return new XilinxZCU102HardwareProfile(frequency, uncertainty);
 		case ArgPack::TARGET_XILINX_ZCU104:
-			return new XilinxZCU104HardwareProfile();
+			return new XilinxZCU104HardwareProfile(frequency, uncertainty);
 		case ArgPack::TARGET_XILINX_ZC702:
 		default:
 			assert(args.fNoTCS && "Time-constrained scheduling is currently not supported with the selected platform. Please activate the \"--fno-tcs\" flag");
-			return new XilinxZC702HardwareProfile();
+			return new XilinxZC702HardwareProfile(frequency, uncertainty);
 	}
 }
 
@@ -520,7 +526,7 @@ void HardwareProfile::callRelease() {
 	//assert(false && "Calls are not constrained");
 }
 
-XilinxHardwareProfile::XilinxHardwareProfile() {
+XilinxHardwareProfile::XilinxHardwareProfile(double frequency, double uncertainty) : HardwareProfile(frequency, uncertainty) {
 	maxDSP = 0;
 	maxFF = 0;
 	maxLUT = 0;
@@ -699,7 +705,7 @@ bool XilinxHardwareProfile::isPipelined(unsigned opcode) {
 }
 
 void XilinxHardwareProfile::calculateRequiredResources(
-	std::vector<int> &microops,
+	std::vector<uint8_t> &microops,
 	const ConfigurationManager::arrayInfoCfgMapTy &arrayInfoCfgMap,
 	std::unordered_map<int, std::pair<std::string, int64_t>> &baseAddress,
 	std::map<uint64_t, std::set<unsigned>> &maxTimesNodesMap
@@ -1272,9 +1278,7 @@ void XilinxZC702HardwareProfile::setResourceLimits() {
 	}
 }
 
-XilinxZCUHardwareProfile::XilinxZCUHardwareProfile() {
-	effectivePeriod = (1000 / args.frequency) - (10 * args.uncertainty / args.frequency);
-
+XilinxZCUHardwareProfile::XilinxZCUHardwareProfile(double frequency, double uncertainty) : XilinxHardwareProfile(frequency, uncertainty) {
 	/* Even if time-constrained scheduling is disabled, we still need to define the latencies of each instruction according to effective clock */
 	for(auto &it : timeConstrainedLatencies) {
 		unsigned currLatency;
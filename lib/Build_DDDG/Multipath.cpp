@@ -197,7 +197,8 @@ void Multipath::recursiveLookup(unsigned currLoopLevel, unsigned finalLoopLevel)
 	if(currLoopLevel >= finalLoopLevel) {
 		VERBOSE_PRINT(errs() << "[][][][multipath][" << std::to_string(finalLoopLevel) << "] Generating normal DDDG for this loop chain\n");
 
-		if(enablePipelining) {
+		// The modulo scheduler calculates the recurrence-constrained II from the loop-carried dependencies instead
+		if(enablePipelining && !(args.fModuloScheduling)) {
 			VERBOSE_PRINT(errs() << "[][][][multipath][" << std::to_string(finalLoopLevel) << "] Building dynamic datapath for recurrence-constrained II calculation\n");
 
 			DynamicDatapath DD(kernelName, CM, summaryFile, loopName, finalLoopLevel, actualLoopUnrollFactor);
@@ -215,6 +216,8 @@ void Multipath::recursiveLookup(unsigned currLoopLevel, unsigned finalLoopLevel)
 
 		latencies.push_back(std::make_tuple(finalLoopLevel, DatapathType::NORMAL_LOOP, DD.getRCIL(), DD.getMaxII()));
 		P.merge(DD.getPack());
+		std::set<std::string> ddArrays = DD.getReferencedArrays();
+		referencedArrays.insert(ddArrays.begin(), ddArrays.end());
 
 		return;
 	}
@@ -250,6 +253,8 @@ void Multipath::recursiveLookup(unsigned currLoopLevel, unsigned finalLoopLevel)
 				ddRCIL = DD.getRCIL();
 				latencies.push_back(std::make_tuple(currLoopLevel, DatapathType::NON_PERFECT_BEFORE, ddRCIL, 0));
 				P.merge(DD.getPack());
+				std::set<std::string> ddArrays = DD.getReferencedArrays();
+				referencedArrays.insert(ddArrays.begin(), ddArrays.end());
 			}
 			else {
 				VERBOSE_PRINT(errs() << "[][][][multipath][" << std::to_string(currLoopLevel) << "] Region before the nested loop not tagged for exploration, skipping\n");
@@ -263,6 +268,8 @@ void Multipath::recursiveLookup(unsigned currLoopLevel, unsigned finalLoopLevel)
 				dd2RCIL = DD2.getRCIL();
 				latencies.push_back(std::make_tuple(currLoopLevel, DatapathType::NON_PERFECT_AFTER, dd2RCIL, 0));
 				P.merge(DD2.getPack());
+				std::set<std::string> dd2Arrays = DD2.getReferencedArrays();
+				referencedArrays.insert(dd2Arrays.begin(), dd2Arrays.end());
 			}
 			else {
 				VERBOSE_PRINT(errs() << "[][][][multipath][" << std::to_string(currLoopLevel) << "] Region after the nested loop not tagged for exploration, skipping\n");
@@ -276,6 +283,8 @@ void Multipath::recursiveLookup(unsigned currLoopLevel, unsigned finalLoopLevel)
 					DynamicDatapath DD3(kernelName, CM, summaryFile, loopName, currLoopLevel, targetUnrollFactor, DatapathType::NON_PERFECT_BETWEEN);
 					latencies.push_back(std::make_tuple(currLoopLevel, DatapathType::NON_PERFECT_BETWEEN, DD3.getRCIL(), 0));
 					P.merge(DD3.getPack());
+					std::set<std::string> dd3Arrays = DD3.getReferencedArrays();
+					referencedArrays.insert(dd3Arrays.begin(), dd3Arrays.end());
 				}
 				else {
 					latencies.push_back(std::make_tuple(currLoopLevel, DatapathType::NON_PERFECT_BETWEEN, 0, 0));
@@ -306,6 +315,18 @@ void Multipath::dumpSummary() {
 	*summaryFile << "Total cycles: " << std::to_string(numCycles) << "\n";
 	*summaryFile << "------------------------------------------------\n";
 
+	// Same values as the summary, for --result-format. Values that are calculated per DDDG (e.g. II) are not set
+	ResultWriter::recordTy record;
+	record.loopName = loopName;
+	record.loopLevel = firstNonPerfectLoopLevel;
+	record.frequency = args.frequency;
+	record.uncertainty = args.uncertainty;
+	record.effectivePeriod = (1000 / args.frequency) - (10 * args.uncertainty / args.frequency);
+	record.achievedPeriod = std::stod(P.mergeElements<float>("Achieved period"));
+	record.unrollFactor = loopUnrollFactor;
+	record.pipelining = enablePipelining;
+	record.cycles = numCycles;
+
 	/* XXX Resource estimation! */
 
 	// Finalise shared resources calculation
@@ -410,6 +431,7 @@ void Multipath::dumpSummary() {
 			uint64_t value = sharedDSP + unsharedDSP;
 
 			*summaryFile << name << ": " << value << "\n";
+			record.dsps = value;
 			continue;
 		}
 		else if("FFs" == name) {
@@ -417,6 +439,7 @@ void Multipath::dumpSummary() {
 			uint64_t value = sharedFF + unsharedFF + rFF + mlFF;
 
 			*summaryFile << name << ": " << value << "\n";
+			record.ffs = value;
 			continue;
 		}
 		else if("LUTs" == name) {
@@ -433,42 +456,60 @@ void Multipath::dumpSummary() {
 			uint64_t value = sharedLUT + unsharedLUT + mLUT + exLUT + mlLUT;
 
 			*summaryFile << name << ": " << value << "\n";
+			record.luts = value;
 			continue;
 		}
 
+		std::string value;
 		if(Pack::MERGE_EQUAL == mergeType) {
 			if(Pack::TYPE_UNSIGNED == type) {
 				assert("true" == P.mergeElements<uint64_t>(name) && "Merged values from datapaths differ where it should not differ");
-				*summaryFile << name << ": " << std::to_string(P.getElements<uint64_t>(name)[0]) << "\n";
+				value = std::to_string(P.getElements<uint64_t>(name)[0]);
 			}
 			else if(Pack::TYPE_SIGNED == type) {
 				assert("true" == P.mergeElements<int64_t>(name) && "Merged values from datapaths differ where it should not differ");
-				*summaryFile << name << ": " << std::to_string(P.getElements<int64_t>(name)[0]) << "\n";
+				value = std::to_string(P.getElements<int64_t>(name)[0]);
 			}
 			else if(Pack::TYPE_FLOAT == type) {
 				assert("true" == P.mergeElements<float>(name) && "Merged values from datapaths differ where it should not differ");
-				*summaryFile << name << ": " << std::to_string(P.getElements<float>(name)[0]) << "\n";
+				value = std::to_string(P.getElements<float>(name)[0]);
 			}
 			else if(Pack::TYPE_STRING == type) {
 				assert("true" == P.mergeElements<std::string>(name) && "Merged values from datapaths differ where it should not differ");
-				*summaryFile << name << ": " << P.getElements<std::string>(name)[0] << "\n";
+				value = P.getElements<std::string>(name)[0];
 			}
 		}
 		else {
 			if(Pack::TYPE_UNSIGNED == type) {
-				*summaryFile << name << ": " << P.mergeElements<uint64_t>(name) << "\n";
+				value = P.mergeElements<uint64_t>(name);
 			}
 			else if(Pack::TYPE_SIGNED == type) {
-				*summaryFile << name << ": " << P.mergeElements<int64_t>(name) << "\n";
+				value = P.mergeElements<int64_t>(name);
 			}
 			else if(Pack::TYPE_FLOAT == type) {
-				*summaryFile << name << ": " << P.mergeElements<float>(name) << "\n";
+				value = P.mergeElements<float>(name);
 			}
 			else if(Pack::TYPE_STRING == type) {
 				std::string mergeResult = P.mergeElements<std::string>(name);
-				*summaryFile << name << ": " << (("" == mergeResult)? "none" : mergeResult) << "\n";
+				value = ("" == mergeResult)? "none" : mergeResult;
 			}
 		}
+
+		*summaryFile << name << ": " << value << "\n";
+
+		if("BRAM18k" == name)
+			record.bram18k = std::stoull(value);
+		else if("Number of shared loads detected" == name)
+			record.sharedLoads = std::stoull(value);
+		else if("Number of repeated stores detected" == name)
+			record.repeatedStores = std::stoull(value);
+		else
+			record.fields.push_back({name, ResultWriter::isNumeric(mergeType, type), value});
+	}
+
+	if(resultWriter.isActive()) {
+		ResultWriter::addResources(record, P);
+		resultWriter.write(record);
 	}
 }
 
@@ -504,6 +545,14 @@ uint64_t Multipath::getCycles() const {
 	return numCycles;
 }
 
+const std::set<std::string> &Multipath::getReferencedArrays() const {
+	return referencedArrays;
+}
+
+Pack &Multipath::getPack() {
+	return P;
+}
+
 #ifdef DBG_PRINT_ALL
 void Multipath::printDatabase() {
 	errs() << "-- latencies\n";
@@ -0,0 +1,305 @@
+#include "profile_h/SyntheticDatapath.h"
+
+#include <cmath>
+
+#include "profile_h/opcodes.h"
+
+// Arrays are placed 16MB apart, which is enough for the array sizes used by the microbenchmarks
+#define SYNTHETIC_ARRAY_SPACING (((int64_t) 1) << 24)
+#define SYNTHETIC_WORD_SIZE 4
+
+SyntheticDatapath::SyntheticDatapath(
+	std::string kernelName, ConfigurationManager &CM, std::string loopName, const shapeCfgTy &cfg
+) : BaseDatapath(kernelName, CM, nullptr, loopName, 1, 1, DatapathType::NORMAL_LOOP), CM(CM), cfg(cfg), rng(cfg.seed) {
+	staticFunction = kernelName;
+#ifdef LEGACY_SEPARATOR
+	dynamicFunction = kernelName + "-0";
+#else
+	dynamicFunction = kernelName + GLOBAL_SEPARATOR "0";
+#endif
+
+	assert(cfg.numOfArrays && "Synthetic DDDG must have at least one array");
+	assert(cfg.arraySize && cfg.arraySize * SYNTHETIC_WORD_SIZE <= SYNTHETIC_ARRAY_SPACING && "Invalid synthetic array size");
+
+	VERBOSE_PRINT(errs() << "[][][][syntheticDatapath] Generating " << getShapeName(cfg.shape) << " DDDG\n");
+
+	switch(cfg.shape) {
+		case SHAPE_CHAIN:
+			generateChain();
+			break;
+		case SHAPE_REDUCTION:
+			generateReduction();
+			break;
+		case SHAPE_STENCIL:
+			generateStencil();
+			break;
+		case SHAPE_RANDOM:
+			generateRandom();
+			break;
+		default:
+			assert(false && "Invalid synthetic DDDG shape");
+	}
+
+	// Nodes are only added to the graph through edges, make sure that all microops have a vertex
+	while(boost::num_vertices(graph) < microops.size())
+		boost::add_vertex(graph);
+
+	postDDDGBuild();
+	initBaseAddress();
+
+	VERBOSE_PRINT(errs() << "[][][][syntheticDatapath] Generated " << getNumNodes() << " nodes and " << getNumEdges() << " edges\n");
+}
+
+std::string SyntheticDatapath::getArrayName(unsigned array) {
+	return "arr" + std::to_string(array);
+}
+
+std::string SyntheticDatapath::getShapeName(unsigned shape) {
+	switch(shape) {
+		case SHAPE_CHAIN:
+			return "chain";
+		case SHAPE_REDUCTION:
+			return "reduction";
+		case SHAPE_STENCIL:
+			return "stencil";
+		case SHAPE_RANDOM:
+			return "random";
+		default:
+			return "unknown";
+	}
+}
+
+std::string SyntheticDatapath::getStageName(unsigned stage) {
+	switch(stage) {
+		case STAGE_REMOVE_SHARED_LOADS:
+			return "slr";
+		case STAGE_REMOVE_REPEATED_STORES:
+			return "rsr";
+		case STAGE_TREE_HEIGHT_REDUCTION:
+			return "thr";
+		case STAGE_ASAP:
+			return "asap";
+		case STAGE_ALAP:
+			return "alap";
+		case STAGE_RC_SCHEDULING:
+			return "rcs";
+		case STAGE_TC_SCHEDULING:
+			return "tcs";
+		default:
+			return "unknown";
+	}
+}
+
+void SyntheticDatapath::writeConfiguration(const shapeCfgTy &cfg, std::ostream &configFile) {
+	for(unsigned i = 0; i < cfg.numOfArrays; i++)
+		configFile << "array," << getArrayName(i) << "," << std::to_string(cfg.arraySize * SYNTHETIC_WORD_SIZE) << "," << SYNTHETIC_WORD_SIZE << "\n";
+
+	if(cfg.partitionFactor > 1) {
+		for(unsigned i = 0; i < cfg.numOfArrays; i++) {
+			configFile << "partition,cyclic," << getArrayName(i) << "," << std::to_string(cfg.arraySize * SYNTHETIC_WORD_SIZE) << "," <<
+				SYNTHETIC_WORD_SIZE << "," << std::to_string(cfg.partitionFactor) << "\n";
+		}
+	}
+}
+
+unsigned SyntheticDatapath::insertNode(int microop) {
+	unsigned nodeID = microops.size();
+
+	insertMicroop(microop);
+
+	// Same trace information that DDDGBuilder generates for a single basic block of the kernel
+	PC.appendToStaticInstIDList(staticFunction, dynamicFunction, std::to_string(nodeID), "0");
+	PC.appendToLineNoList(0);
+	PC.appendToCurrBBList("1");
+	PC.appendToResultSizeList(nodeID, 32);
+
+	return nodeID;
+}
+
+unsigned SyntheticDatapath::insertLoad(unsigned array, uint64_t index) {
+	int64_t base = (array + 1) * SYNTHETIC_ARRAY_SPACING;
+
+	unsigned gepID = insertNode(LLVM_IR_GetElementPtr);
+	PC.appendToGetElementPtrList(gepID, getArrayName(array), base);
+
+	unsigned loadID = insertNode(LLVM_IR_Load);
+	PC.appendToMemoryTraceList(loadID, base + (index % cfg.arraySize) * SYNTHETIC_WORD_SIZE, 32);
+	insertDDDGEdge(gepID, loadID, 1);
+
+	return loadID;
+}
+
+unsigned SyntheticDatapath::insertStore(unsigned value, unsigned array, uint64_t index) {
+	int64_t base = (array + 1) * SYNTHETIC_ARRAY_SPACING;
+
+	unsigned gepID = insertNode(LLVM_IR_GetElementPtr);
+	PC.appendToGetElementPtrList(gepID, getArrayName(array), base);
+
+	unsigned storeID = insertNode(LLVM_IR_Store);
+	PC.appendToMemoryTraceList(storeID, base + (index % cfg.arraySize) * SYNTHETIC_WORD_SIZE, 32);
+	insertDDDGEdge(value, storeID, 1);
+	insertDDDGEdge(gepID, storeID, 2);
+
+	return storeID;
+}
+
+unsigned SyntheticDatapath::insertOp(bool multiply, unsigned op1, unsigned op2) {
+	int microop;
+	if(cfg.floatingPoint)
+		microop = multiply? LLVM_IR_FMul : LLVM_IR_FAdd;
+	else
+		microop = multiply? LLVM_IR_Mul : LLVM_IR_Add;
+
+	unsigned opID = insertNode(microop);
+	insertDDDGEdge(op1, opID, 1);
+	insertDDDGEdge(op2, opID, 2);
+
+	return opID;
+}
+
+unsigned SyntheticDatapath::insertOp(bool multiply, unsigned op1) {
+	int microop;
+	if(cfg.floatingPoint)
+		microop = multiply? LLVM_IR_FMul : LLVM_IR_FAdd;
+	else
+		microop = multiply? LLVM_IR_Mul : LLVM_IR_Add;
+
+	// Second operand is a constant
+	unsigned opID = insertNode(microop);
+	insertDDDGEdge(op1, opID, 1);
+
+	return opID;
+}
+
+double SyntheticDatapath::uniform() {
+	return std::uniform_real_distribution<double>(0, 1)(rng);
+}
+
+unsigned SyntheticDatapath::pickArray() {
+	return std::uniform_int_distribution<unsigned>(0, cfg.numOfArrays - 1)(rng);
+}
+
+void SyntheticDatapath::generateChain() {
+	uint64_t index = 0;
+	unsigned value = insertLoad(0, index++);
+
+	while(microops.size() < cfg.numOfNodes) {
+		bool multiply = microops.size() & 1;
+
+		if(uniform() < cfg.memRatio) {
+			if(uniform() < cfg.storeRatio)
+				insertStore(value, pickArray(), index++);
+			else
+				value = insertOp(multiply, value, insertLoad(pickArray(), index++));
+		}
+		else {
+			value = insertOp(multiply, value);
+		}
+	}
+
+	insertStore(value, 0, index);
+}
+
+void SyntheticDatapath::generateReduction() {
+	unsigned arrayB = (cfg.numOfArrays > 1)? 1 : 0;
+	unsigned acc = insertOp(true, insertLoad(0, 0), insertLoad(arrayB, 0));
+
+	// Each iteration generates 6 nodes (2 getelementptr, 2 loads, multiplication and accumulation)
+	for(uint64_t i = 1; microops.size() < cfg.numOfNodes; i++)
+		acc = insertOp(false, acc, insertOp(true, insertLoad(0, i), insertLoad(arrayB, i)));
+
+	insertStore(acc, cfg.numOfArrays - 1, 0);
+}
+
+void SyntheticDatapath::generateStencil() {
+	unsigned arrayOut = (cfg.numOfArrays > 1)? 1 : 0;
+	// Each point generates 17 nodes (5 loads, 4 additions, 1 multiplication and 1 store, plus getelementptrs)
+	uint64_t side = std::max((uint64_t) std::ceil(std::sqrt(cfg.numOfNodes / 17.0)), (uint64_t) 1) + 2;
+
+	for(uint64_t i = 1; i < side - 1 && microops.size() < cfg.numOfNodes; i++) {
+		for(uint64_t j = 1; j < side - 1 && microops.size() < cfg.numOfNodes; j++) {
+			unsigned sum = insertOp(false, insertLoad(0, (i - 1) * side + j), insertLoad(0, (i + 1) * side + j));
+			sum = insertOp(false, sum, insertLoad(0, i * side + j - 1));
+			sum = insertOp(false, sum, insertLoad(0, i * side + j + 1));
+			sum = insertOp(false, sum, insertLoad(0, i * side + j));
+			insertStore(insertOp(true, sum), arrayOut, i * side + j);
+		}
+	}
+}
+
+void SyntheticDatapath::generateRandom() {
+	// Values (loads and operations) that may be consumed by other nodes
+	std::vector<unsigned> values;
+	unsigned window = std::max(cfg.window, 1u);
+
+	values.push_back(insertLoad(pickArray(), std::uniform_int_distribution<uint64_t>(0, cfg.arraySize - 1)(rng)));
+
+	while(microops.size() < cfg.numOfNodes) {
+		std::uniform_int_distribution<size_t> pickValue(values.size() > window? values.size() - window : 0, values.size() - 1);
+		uint64_t index = std::uniform_int_distribution<uint64_t>(0, cfg.arraySize - 1)(rng);
+
+		if(uniform() < cfg.memRatio) {
+			if(uniform() < cfg.storeRatio)
+				insertStore(values[pickValue(rng)], pickArray(), index);
+			else
+				values.push_back(insertLoad(pickArray(), index));
+		}
+		else {
+			values.push_back(insertOp(uniform() < 0.5, values[pickValue(rng)], values[pickValue(rng)]));
+		}
+	}
+}
+
+void SyntheticDatapath::prepareStage(unsigned stage) {
+	updateEdgeWeightsWithLatencies();
+
+	// DDDG optimisations and ASAP only depend on the latencies
+	if(STAGE_REMOVE_SHARED_LOADS == stage || STAGE_REMOVE_REPEATED_STORES == stage || STAGE_TREE_HEIGHT_REDUCTION == stage || STAGE_ASAP == stage)
+		return;
+
+	asapResult = asapScheduling();
+
+	if(STAGE_ALAP == stage)
+		return;
+
+	alapScheduling(asapResult);
+	identifyCriticalPaths();
+	// XXX: The optimisations performed inside are controlled by args, the microbenchmarks disable them all so that
+	// only the scheduler is timed
+	prepareRCScheduling();
+}
+
+uint64_t SyntheticDatapath::runStage(unsigned stage) {
+	// Each DDDG optimisation stage is a single sweep of the rewrite pass manager
+	RewritePassManager RPM(*this);
+
+	switch(stage) {
+		case STAGE_REMOVE_SHARED_LOADS:
+			removeSharedLoads(RPM);
+			RPM.run();
+			return sharedLoadsRemoved;
+		case STAGE_REMOVE_REPEATED_STORES:
+			removeRepeatedStores(RPM);
+			RPM.run();
+			return repeatedStoresRemoved;
+		case STAGE_TREE_HEIGHT_REDUCTION:
+			if(cfg.floatingPoint)
+				reduceTreeHeight(RPM, isFAssociative, true);
+			else
+				reduceTreeHeight(RPM, isAssociative, true);
+			RPM.run();
+			return getNumEdges();
+		case STAGE_ASAP:
+			asapResult = asapScheduling();
+			return std::get<0>(asapResult);
+		case STAGE_ALAP:
+			alapScheduling(asapResult);
+			return std::get<0>(asapResult);
+		case STAGE_RC_SCHEDULING:
+		case STAGE_TC_SCHEDULING:
+			return rcScheduling(CM.getPartitionCfgMap(), CM.getCompletePartitionCfgMap()).first;
+		default:
+			assert(false && "Invalid microbenchmark stage");
+			return 0;
+	}
+}
@@ -0,0 +1,57 @@
+#include "profile_h/ThreadBudget.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+ThreadBudget::ThreadBudget() {
+	unsigned numOfThreads = std::thread::hardware_concurrency();
+
+	// The main thread is already running
+	freeSlots = (numOfThreads > 1)? numOfThreads - 1 : 0;
+}
+
+unsigned ThreadBudget::acquire(unsigned wanted) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	unsigned granted = (wanted < freeSlots)? wanted : freeSlots;
+	freeSlots -= granted;
+
+	return granted;
+}
+
+void ThreadBudget::release(unsigned slots) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	freeSlots += slots;
+}
+
+ThreadBudget &ThreadBudget::getInstance() {
+	static ThreadBudget instance;
+
+	return instance;
+}
+
+void ThreadBudget::run(unsigned numOfTasks, unsigned maxHelpers, std::function<void(unsigned)> task) {
+	if(!numOfTasks)
+		return;
+
+	unsigned wanted = (maxHelpers < numOfTasks - 1)? maxHelpers : numOfTasks - 1;
+	unsigned helpers = wanted? acquire(wanted) : 0;
+
+	std::atomic<unsigned> nextTask(0);
+	auto worker = [&nextTask, numOfTasks, &task] {
+		for(unsigned i = nextTask++; i < numOfTasks; i = nextTask++)
+			task(i);
+	};
+
+	std::vector<std::thread> threads;
+	for(unsigned i = 0; i < helpers; i++)
+		threads.push_back(std::thread(worker));
+	worker();
+
+	for(auto &it : threads)
+		it.join();
+
+	release(helpers);
+}
@@ -13,6 +13,8 @@
 
 #include "profile_h/AssignBasicBlockIDPass.h"
 
+#include "profile_h/PhaseProfiler.h"
+
 // If using GCC, these pragmas will stop GCC from outputting the thousands of warnings generated by boost library (WHICH IS EXTREMELY ANNOYING)
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -46,6 +48,8 @@ void AssignBasicBlockID::getAnalysisUsage(AnalysisUsage &AU) const {
 }
 
 bool AssignBasicBlockID::runOnModule(Module &M) {
+	PHASE_SCOPE(phase, "assignBasicBlockID");
+
 	errs() << "========================================================\n";
 	errs() << "Assigning IDs to BBs, acquiring array names\n";
 
@@ -13,6 +13,8 @@
 
 #include "profile_h/AssignLoadStoreIDPass.h"
 
+#include "profile_h/PhaseProfiler.h"
+
 #define DEBUG_TYPE "assign-loadstore-id"
 
 using namespace llvm;
@@ -28,6 +30,8 @@ void AssignLoadStoreID::getAnalysisUsage(AnalysisUsage &AU) const {
 }
 
 bool AssignLoadStoreID::runOnModule(Module &M) {
+	PHASE_SCOPE(phase, "assignLoadStoreID");
+
 	errs() << "========================================================\n";
 	errs() << "Assigning IDs to load and store instructions\n";
 
@@ -14,6 +14,7 @@
 ///     Fourth tuple element: basic block ID of loop header
 
 #include "profile_h/ExtractLoopInfoPass.h"
+#include "profile_h/PhaseProfiler.h"
 #include "profile_h/auxiliary.h"
 
 #define DEBUG_TYPE "extract-loopinfo"
@@ -178,6 +179,8 @@ void ExtractLoopInfo::getAnalysisUsage(AnalysisUsage &AU) const {
 }
 
 bool ExtractLoopInfo::runOnLoop(Loop *L, LPPassManager &LPM) {
+	PHASE_SCOPE(phase, "extractLoopInfo");
+
 	DEBUG(dbgs() << "\n\nBegin ExtractLoopInfo Pass :\n");
 	LoopInfo *LI = &getAnalysis<LoopInfo>();
 	ScalarEvolution *SE = &getAnalysis<ScalarEvolution>();
@@ -12,6 +12,8 @@
 
 #include "profile_h/FunctionNameMapperPass.h"
 
+#include "profile_h/PhaseProfiler.h"
+
 // If using GCC, these pragmas will stop GCC from outputting the thousands of warnings generated by boost library (WHICH IS EXTREMELY ANNOYING)
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -53,6 +55,8 @@ bool FunctionNameMapper::doInitialization(Module &M) {
 }
 
 bool FunctionNameMapper::runOnFunction(Function &F) {
+	PHASE_SCOPE(phase, "functionNameMapper");
+
 	DEBUG(dbgs() << "\n\nBegin FunctionNameMapper Pass :\n");
 
 	if(firstRun) {
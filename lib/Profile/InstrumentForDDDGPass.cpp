@@ -1,5 +1,10 @@
 #include "profile_h/InstrumentForDDDGPass.h"
 
+#include "profile_h/PhaseProfiler.h"
+#include "profile_h/ResultWriter.h"
+#include "profile_h/StaticDatabase.h"
+#include "profile_h/ThreadBudget.h"
+
 #define DEBUG_TYPE "instrument-code-for-building-dddg"
 
 #ifdef FUTURE_CACHE
@@ -482,14 +487,22 @@ bool InstrumentForDDDG::runOnModule(Module &M) {
 	errs() << "Starting code instrumentation for DDDG generation\n";
 
 	bool result = false;
-	for(Module::iterator FI = M.begin(); FI != M.end(); FI++) {
-		if(isFunctionOfInterest(FI->getName())) {
-			VERBOSE_PRINT(errs() << "[instrumentForDDDG] Injecting trace code in \"" + demangleFunctionName(FI->getName()) + "\"\n");
-			for(Function::iterator BI = FI->begin(); BI != FI->end(); BI++)
-				result += performOnBasicBlock(*BI);
+	{
+		PHASE_SCOPE(phase, "instrumentation");
+
+		for(Module::iterator FI = M.begin(); FI != M.end(); FI++) {
+			if(isFunctionOfInterest(FI->getName())) {
+				VERBOSE_PRINT(errs() << "[instrumentForDDDG] Injecting trace code in \"" + demangleFunctionName(FI->getName()) + "\"\n");
+				for(Function::iterator BI = FI->begin(); BI != FI->end(); BI++)
+					result += performOnBasicBlock(*BI);
+			}
 		}
 	}
 
+	// All static analysis is done at this point. Save it, so that further estimation-only executions can skip the passes
+	VERBOSE_PRINT(errs() << "[instrumentForDDDG] Saving static database\n");
+	StaticDatabase::save();
+
 	if(args.MODE_TRACE_AND_ESTIMATE == args.mode || args.MODE_TRACE_ONLY == args.mode) {
 		VERBOSE_PRINT(errs() << "[instrumentForDDDG] Starting profiling engine\n");
 
@@ -520,7 +533,7 @@ bool InstrumentForDDDG::runOnModule(Module &M) {
 	assert(verifyModuleAndPrintErrors(M) && "Errors found in module\n");
 
 	// Perform the cycle estimation
-	loopBasedTraceAnalysis();
+	performEstimation();
 
 	VERBOSE_PRINT(errs() << "[instrumentForDDDG] Finished\n");
 
@@ -839,19 +852,43 @@ void InstrumentForDDDG::updateUnrollingDatabase(const std::vector<ConfigurationM
 	}
 }
 
+void InstrumentForDDDG::performEstimation() {
+	// Structured results of all kernels are written to the same file, named after the first kernel
+	resultWriter.open(args.kernelNames.at(0));
+
+	if(args.exploreFileName.empty())
+		loopBasedTraceAnalysis();
+	else
+		designSpaceExploration();
+
+	resultWriter.close();
+}
+
 void InstrumentForDDDG::loopBasedTraceAnalysis() {
 	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Loop-based trace analysis started\n");
 
-	std::string traceFileName = args.workDir + FILE_DYNAMIC_TRACE;
-	std::string kernelName = mangleFunctionName(args.kernelNames.at(0));
+	std::vector<std::unique_ptr<kernelAnalysisTy>> kernels;
+	std::vector<ConfigurationManager::unrollingCfgTy> unrollingCfg;
 
-	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Writing header of summary file\n");
-	openSummaryFile(kernelName); 
+	for(auto &it : args.kernelNames) {
+		kernels.push_back(std::unique_ptr<kernelAnalysisTy>(new kernelAnalysisTy()));
+		kernelAnalysisTy &kernel = *(kernels.back());
+		kernel.kernelName = mangleFunctionName(it);
+		kernel.traceCursor = 0;
+		kernel.traceInstCount = 0;
 
-	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Parsing configuration file\n");
-	ConfigurationManager CM(kernelName);
-	CM.parseAndPopulate(pipelineLoopLevelVec);
-	updateUnrollingDatabase(CM.getUnrollingCfg());
+		VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Writing header of summary file of " << it << "\n");
+		openSummaryFile(kernel.kernelName, kernel.summaryFileName, kernel.summaryFile);
+
+		VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Parsing configuration file of " << it << "\n");
+		kernel.CM.reset(new ConfigurationManager(kernel.kernelName));
+		kernel.CM->parseAndPopulate(kernel.pipelineLoopLevelVec);
+
+		// The unrolling database is shared by all kernels, each configuration only affects the loops of its kernel
+		const std::vector<ConfigurationManager::unrollingCfgTy> &kernelUnrollingCfg = kernel.CM->getUnrollingCfg();
+		unrollingCfg.insert(unrollingCfg.end(), kernelUnrollingCfg.begin(), kernelUnrollingCfg.end());
+	}
+	updateUnrollingDatabase(unrollingCfg);
 
 #ifdef FUTURE_CACHE
 	if(args.futureCache) {
@@ -863,57 +900,236 @@ void InstrumentForDDDG::loopBasedTraceAnalysis() {
 			VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Future cache file not found or is corrupt. Starting from scratch\n");
 	}
 #endif
+#ifdef RESULT_CACHE
+	// Cached results do not carry DDDG and scheduling dumps nor structured results, so the cache is bypassed if
+	// these are requested
+	bool useResultCache = args.resultCache && !(args.showPreOptDDDG) && !(args.showPostOptDDDG) && !(args.showScheduling) &&
+		!(resultWriter.isActive());
+
+	if(useResultCache) {
+		VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Use of result cache enabled\n");
+
+		// Each kernel has its own view of the result cache log (the log itself is locked when written)
+		for(auto &it : kernels) {
+			it->useResultCache = true;
+
+			if(it->resultCache.load())
+				VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Result cache file found.\n");
+			else
+				VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Result cache file not found or is corrupt. Starting from scratch\n");
+		}
+	}
+#endif
+#ifdef PROGRESSIVE_TRACE_CURSOR
+	if(args.progressive && kernels.size() > 1)
+		indexTraceSegments(kernels);
+#endif
+
+	/**
+	 * Kernels are analysed concurrently, except when:
+	 * - some loop bound is not known statically: it is calculated from the trace and written to the global databases;
+	 * - compressed files are used: the parsed trace containers use fixed file names.
+	 */
+	bool concurrent = kernels.size() > 1 && !(args.compressed);
+	for(auto &it : wholeloopName2loopBoundMap) {
+		if(!(it.second))
+			concurrent = false;
+	}
+
+	if(concurrent) {
+		VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Analysing " << kernels.size() << " kernels concurrently\n");
+
+		// Kernels beyond the available threads are analysed as the first ones finish
+		ThreadBudget::getInstance().run(kernels.size(), kernels.size(), [this, &kernels] (unsigned i) { analyseKernel(*(kernels[i])); });
+	}
+	else {
+		for(auto &it : kernels)
+			analyseKernel(*it);
+	}
+
+#ifdef FUTURE_CACHE
+	if(args.futureCache) {
+		// XXX: The future cache is shared by all kernels, so are its statistics
+		for(auto &it : kernels)
+			futureCache.dumpSummary(&(it->summaryFile));
+		futureCache.writeResults();
+
+		VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Saving future cache\n");
+		futureCache.save();
+	}
+#endif
+#ifdef RESULT_CACHE
+	if(useResultCache) {
+		for(auto &it : kernels) {
+			it->resultCache.dumpSummary(&(it->summaryFile));
+
+			VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Saving result cache\n");
+			it->resultCache.save();
+		}
+	}
+#endif
+
+	for(auto &it : kernels)
+		closeSummaryFile(it->summaryFile);
+	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Summary files closed\n");
+
+	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Finished\n");
+
+
+#ifdef DBG_PRINT_ALL
+	for(auto &it : kernels)
+		it->CM->parseToFiles();
+#endif
+}
+
+#ifdef PROGRESSIVE_TRACE_CURSOR
+void InstrumentForDDDG::indexTraceSegments(std::vector<std::unique_ptr<kernelAnalysisTy>> &kernels) {
+	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Indexing trace segments of each kernel\n");
+
+	std::string traceFileName = args.workDir + FILE_DYNAMIC_TRACE;
+	gzFile traceFile = gzopen(traceFileName.c_str(), "r");
+	assert(traceFile != Z_NULL && "Could not open trace input file");
+
+	std::map<std::string, kernelAnalysisTy *> pendingKernels;
+	for(auto &it : kernels)
+		pendingKernels.insert(std::make_pair(it->kernelName, it.get()));
+
+	// The segment of a kernel starts at its first traced instruction. Its progressive trace cursor starts there, as if
+	// the loops of all kernels executed before were already analysed
+	uint64_t instCount = 0;
+	char buffer[BUFF_STR_SZ];
+	while(pendingKernels.size() && !gzeof(traceFile)) {
+		if(Z_NULL == gzgets(traceFile, buffer, sizeof(buffer)))
+			continue;
+
+		std::string line(buffer);
+		if(line.compare(0, 2, "0,"))
+			continue;
+
+		char funcName[BUFF_STR_SZ];
+		if(1 == sscanf(line.c_str(), "0,%*d,%[^,]", funcName)) {
+			std::map<std::string, kernelAnalysisTy *>::iterator found = pendingKernels.find(funcName);
+
+			if(found != pendingKernels.end()) {
+				found->second->traceCursor = gztell(traceFile) - line.size();
+				found->second->traceInstCount = instCount;
+
+				VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Trace segment of " << demangleFunctionName(funcName) <<
+					" starts at byte " << std::to_string(found->second->traceCursor) << "\n");
+
+				pendingKernels.erase(found);
+			}
+		}
+
+		instCount++;
+	}
+
+	gzclose(traceFile);
+
+	for(auto &it : pendingKernels)
+		errs() << "[][loopBasedTraceAnalysis] Warning: kernel " << demangleFunctionName(it.first) << " was not found in the trace\n";
+}
+#endif
+
+void InstrumentForDDDG::analyseKernel(kernelAnalysisTy &kernel) {
+	std::string kernelName = kernel.kernelName;
+	ConfigurationManager &CM = *(kernel.CM);
+	std::ofstream &summaryFile = kernel.summaryFile;
+#ifdef RESULT_CACHE
+	std::string &summaryFileName = kernel.summaryFileName;
+	ResultCache &resultCache = kernel.resultCache;
+#endif
+
+	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Analysing kernel " << demangleFunctionName(kernelName) << "\n");
+
+#ifdef PROGRESSIVE_TRACE_CURSOR
+	progressiveTraceCursor = kernel.traceCursor;
+	progressiveTraceInstCount = kernel.traceInstCount;
+#endif
 
 	for(auto &it : loopName2levelUnrollVecMap) {
 		std::string loopName = it.first;
-		std::string loopIndex = std::to_string(std::get<1>(parseLoopName(loopName)));
 
-		// Skip loop if it is not of interest
-		std::vector<std::string>::iterator found = std::find(args.targetLoops.begin(), args.targetLoops.end(), loopIndex);
-		if(args.targetLoops.end() == found)
+		// Skip loop if it is not of interest or belongs to another kernel
+		if(!isTargetLoop(loopName) || std::get<0>(parseLoopName(loopName)) != kernelName)
 			continue;
 
 		std::vector<unsigned> &levelUnrollVec = it.second;
-		int targetLoopLevel = 1;
-		unsigned targetUnrollFactor = 1;
-		unsigned targetLoopBound;
-		std::string targetWholeLoopName = appendDepthToLoopName(loopName, targetLoopLevel);
-		bool enablePipelining = false;
-
-		// Acquire target unroll factors, loop bound and pipelining flag
-		for(int i = (int) (levelUnrollVec.size() - 1); i >= 0 && 1 == targetLoopLevel; i--) {
-			// This value is always > 0
-			targetUnrollFactor = levelUnrollVec.at(i);
-			std::string wholeLoopName = appendDepthToLoopName(loopName, i + 1);
-
-			wholeloopName2loopBoundMapTy::iterator found2 = wholeloopName2loopBoundMap.find(wholeLoopName);
-			assert(found2 != wholeloopName2loopBoundMap.end() && "Could not find loop in wholeloopName2loopBoundMap");
-			targetLoopBound = found2->second;
-
-			/**
-			 * If loop bound is not known statically (0 == targetLoopBound), this "if" always executes (targetUnrollFactor is always > 0)
-			 * If loop bound is known (targetLoopBound > 1), this "if" will execute in the following situations:
-			 * - No unroll was specified
-			 * - Unroll was specified, but the unroll factor is different from the loop bound
-			 * The first execution of this "if" breaks the "for" loop.
-			 */
-			if(targetUnrollFactor != targetLoopBound) {
-				targetLoopLevel = i + 1;
-				targetWholeLoopName = wholeLoopName;
+		loopTargetTy target = getLoopTarget(loopName, levelUnrollVec, kernel.pipelineLoopLevelVec);
+		int targetLoopLevel = target.loopLevel;
+		unsigned targetUnrollFactor = target.targetUnrollFactor;
+		unsigned targetLoopBound = target.loopBound;
+		std::string targetWholeLoopName = target.wholeLoopName;
+		bool enablePipelining = target.enablePipelining;
+		unsigned unrollFactor = target.unrollFactor;
+		unsigned firstNonPerfectLoopLevel = 1;
+		std::vector<uint64_t> estimatedCycles;
+		std::set<std::string> referencedArrays;
+
+#ifdef RESULT_CACHE
+		std::string baseKey;
+		ResultCache::resultTy cachedResult;
+		std::streampos summaryBegin;
+
+		if(kernel.useResultCache) {
+			baseKey = resultCache.constructBaseKey(kernelName, targetWholeLoopName, targetLoopLevel, levelUnrollVec, unrollFactor, enablePipelining);
+
+			if(resultCache.findReferencedArrays(baseKey, referencedArrays) && resultCache.find(resultCache.constructFullKey(baseKey, referencedArrays, CM), cachedResult)) {
+				VERBOSE_PRINT(errs() << "[][][" << targetWholeLoopName << "] Result found in result cache, skipping estimation\n");
+
+				summaryFile << resultCache.rewriteSummary(cachedResult.summary, referencedArrays, CM);
+
+				if(cachedResult.cycles.size() > 1) {
+					for(unsigned i = 0; i < cachedResult.cycles.size(); i++) {
+						errs() << "[][][" << targetWholeLoopName << "] Estimated cycles @ " << std::to_string(args.clockTargets[i].first) << " MHz: " <<
+							std::to_string(cachedResult.cycles[i]) << "\n";
+					}
+				}
+				else {
+					errs() << "[][][" << targetWholeLoopName << "] Estimated cycles: " << std::to_string(cachedResult.cycles.at(0)) << "\n";
+				}
+
+#ifdef PROGRESSIVE_TRACE_CURSOR
+				// The trace cursor is moved as if this loop was analysed, as long as the trace was at the same position
+				if(args.progressive && cachedResult.cursorBefore == progressiveTraceCursor && cachedResult.instCountBefore == progressiveTraceInstCount) {
+					progressiveTraceCursor = cachedResult.cursorAfter;
+					progressiveTraceInstCount = cachedResult.instCountAfter;
+				}
+#endif
+
+				continue;
 			}
 
-			std::vector<std::string>::iterator found3 = std::find(pipelineLoopLevelVec.begin(), pipelineLoopLevelVec.end(), wholeLoopName);
-			enablePipelining = found3 != pipelineLoopLevelVec.end();
+			summaryFile.flush();
+			summaryBegin = summaryFile.tellp();
+#ifdef PROGRESSIVE_TRACE_CURSOR
+			cachedResult.cursorBefore = progressiveTraceCursor;
+			cachedResult.instCountBefore = progressiveTraceInstCount;
+#else
+			cachedResult.cursorBefore = 0;
+			cachedResult.instCountBefore = 0;
+#endif
 		}
+#endif
 
-		unsigned firstNonPerfectLoopLevel = 1;
+		// Loops with large unroll factors may be extrapolated from a few smaller DDDGs instead (see Extrapolator)
+		bool extrapolated = false;
+		if(Extrapolator::isApplicable(unrollFactor)) {
+			VERBOSE_PRINT(errs() << "[][][" << targetWholeLoopName << "] Extrapolation triggered: building sample datapaths\n");
 
-		VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Target loop: " << targetWholeLoopName << "\n");
-		VERBOSE_PRINT(errs() << "[][][" << targetWholeLoopName << "] Target unroll factor: " << targetUnrollFactor << "\n");
-		VERBOSE_PRINT(errs() << "[][][" << targetWholeLoopName << "] Target loop bound: " << targetLoopBound << "\n");
-		VERBOSE_PRINT(errs() << "[][][" << targetWholeLoopName << "] Pipelining: " << (enablePipelining? "enabled" : "disabled") << "\n");
+			Extrapolator EX(kernelName, CM, &summaryFile, loopName, targetLoopLevel, unrollFactor, targetLoopBound, enablePipelining);
+			if(EX.extrapolate()) {
+				EX.dumpSummary();
+				errs() << "[][][" << targetWholeLoopName << "] Estimated cycles (extrapolated): " << std::to_string(EX.getCycles()) << "\n";
 
-		unsigned unrollFactor = (targetLoopBound < targetUnrollFactor && targetLoopBound)? targetLoopBound : targetUnrollFactor;
+				estimatedCycles.push_back(EX.getCycles());
+				referencedArrays = EX.getReferencedArrays();
+				extrapolated = true;
+			}
+			else {
+				VERBOSE_PRINT(errs() << "[][][" << targetWholeLoopName << "] Extrapolation failed, falling back to full estimation\n");
+			}
+		}
 
 		// There used to be logic to control NPLA here, but for now it is always active as long --f-npla is set
 		if(args.fNPLA) {
@@ -924,58 +1140,383 @@ void InstrumentForDDDG::loopBasedTraceAnalysis() {
 
 				Multipath MD(kernelName, CM, &summaryFile, loopName, targetLoopLevel, firstNonPerfectLoopLevel, unrollFactor, levelUnrollVec, actualUnrollFactor);
 				errs() << "[][][" << targetWholeLoopName << "] Estimated cycles: " << std::to_string(MD.getCycles()) << "\n";
+
+				estimatedCycles.push_back(MD.getCycles());
+				referencedArrays = MD.getReferencedArrays();
 			}
 			else {
 				Multipath MD(kernelName, CM, &summaryFile, loopName, targetLoopLevel, firstNonPerfectLoopLevel, unrollFactor, levelUnrollVec);
 				errs() << "[][][" << targetWholeLoopName << "] Estimated cycles: " << std::to_string(MD.getCycles()) << "\n";
+
+				estimatedCycles.push_back(MD.getCycles());
+				referencedArrays = MD.getReferencedArrays();
 			}
 		}
-		else {
+		else if(!extrapolated) {
 			unsigned recII = 0;
+			std::vector<uint64_t> sweepRecII;
 
-			// Get recurrence-constrained II
-			if(enablePipelining) {
+			// Get recurrence-constrained II (the modulo scheduler calculates it from the loop-carried dependencies instead)
+			if(enablePipelining && !(args.fModuloScheduling)) {
 				VERBOSE_PRINT(errs() << "[][][" << targetWholeLoopName << "] Building dynamic datapath for recurrence-constrained II calculation\n");
 
 				unsigned actualUnrollFactor = (targetLoopBound < (targetUnrollFactor << 1) && targetLoopBound)? targetLoopBound : (targetUnrollFactor << 1);
 				DynamicDatapath DD(kernelName, CM, &summaryFile, loopName, targetLoopLevel, actualUnrollFactor);
 				recII = DD.getASAPII();
+				sweepRecII = DD.getSweepASAPII();
 
 				VERBOSE_PRINT(errs() << "[][][" << targetWholeLoopName << "] Recurrence-constrained II: " << recII << "\n");
 			}
 
 			VERBOSE_PRINT(errs() << "[][][" << targetWholeLoopName << "] Building dynamic datapath\n");
-			DynamicDatapath DD(kernelName, CM, &summaryFile, loopName, targetLoopLevel, unrollFactor, enablePipelining, recII);
+			DynamicDatapath DD(kernelName, CM, &summaryFile, loopName, targetLoopLevel, unrollFactor, enablePipelining, recII, sweepRecII);
+
+			if(DD.getSweepCycles().size()) {
+				for(unsigned i = 0; i < DD.getSweepCycles().size(); i++) {
+					errs() << "[][][" << targetWholeLoopName << "] Estimated cycles @ " << std::to_string(args.clockTargets[i].first) << " MHz: " <<
+						std::to_string(DD.getSweepCycles()[i]) << "\n";
+				}
+			}
+			else {
+				errs() << "[][][" << targetWholeLoopName << "] Estimated cycles: " << std::to_string(DD.getCycles()) << "\n";
+			}
+
+			estimatedCycles = DD.getSweepCycles();
+			if(!(estimatedCycles.size()))
+				estimatedCycles.push_back(DD.getCycles());
+			referencedArrays = DD.getReferencedArrays();
+		}
+
+#ifdef RESULT_CACHE
+		if(kernel.useResultCache) {
+			// Everything written to the summary file during this loop estimation is saved
+			summaryFile.flush();
+			std::streampos summaryEnd = summaryFile.tellp();
+			std::ifstream summaryIn(summaryFileName);
+			summaryIn.seekg(summaryBegin);
+			cachedResult.summary.assign(summaryEnd - summaryBegin, '\0');
+			summaryIn.read(&(cachedResult.summary[0]), cachedResult.summary.size());
+
+			if(summaryIn.good()) {
+				cachedResult.cycles = estimatedCycles;
+#ifdef PROGRESSIVE_TRACE_CURSOR
+				cachedResult.cursorAfter = progressiveTraceCursor;
+				cachedResult.instCountAfter = progressiveTraceInstCount;
+#else
+				cachedResult.cursorAfter = 0;
+				cachedResult.instCountAfter = 0;
+#endif
+				resultCache.insert(baseKey, referencedArrays, resultCache.constructFullKey(baseKey, referencedArrays, CM), cachedResult);
+			}
+		}
+#endif
+	}
+}
+
+bool InstrumentForDDDG::isTargetLoop(std::string loopName) {
+	std::string loopIndex = std::to_string(std::get<1>(parseLoopName(loopName)));
+	return std::find(args.targetLoops.begin(), args.targetLoops.end(), loopIndex) != args.targetLoops.end();
+}
+
+InstrumentForDDDG::loopTargetTy InstrumentForDDDG::getLoopTarget(
+	std::string loopName, std::vector<unsigned> &levelUnrollVec, std::vector<std::string> &pipelineLoopLevelVec
+) {
+	loopTargetTy target;
+	target.loopLevel = 1;
+	target.targetUnrollFactor = 1;
+	target.loopBound = 0;
+	target.wholeLoopName = appendDepthToLoopName(loopName, target.loopLevel);
+	target.enablePipelining = false;
+
+	// Acquire target unroll factors, loop bound and pipelining flag
+	for(int i = (int) (levelUnrollVec.size() - 1); i >= 0 && 1 == target.loopLevel; i--) {
+		// This value is always > 0
+		target.targetUnrollFactor = levelUnrollVec.at(i);
+		std::string wholeLoopName = appendDepthToLoopName(loopName, i + 1);
+
+		wholeloopName2loopBoundMapTy::iterator found2 = wholeloopName2loopBoundMap.find(wholeLoopName);
+		assert(found2 != wholeloopName2loopBoundMap.end() && "Could not find loop in wholeloopName2loopBoundMap");
+		target.loopBound = found2->second;
+
+		/**
+		 * If loop bound is not known statically (0 == targetLoopBound), this "if" always executes (targetUnrollFactor is always > 0)
+		 * If loop bound is known (targetLoopBound > 1), this "if" will execute in the following situations:
+		 * - No unroll was specified
+		 * - Unroll was specified, but the unroll factor is different from the loop bound
+		 * The first execution of this "if" breaks the "for" loop.
+		 */
+		if(target.targetUnrollFactor != target.loopBound) {
+			target.loopLevel = i + 1;
+			target.wholeLoopName = wholeLoopName;
+		}
+
+		std::vector<std::string>::iterator found3 = std::find(pipelineLoopLevelVec.begin(), pipelineLoopLevelVec.end(), wholeLoopName);
+		target.enablePipelining = found3 != pipelineLoopLevelVec.end();
+	}
+
+	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Target loop: " << target.wholeLoopName << "\n");
+	VERBOSE_PRINT(errs() << "[][][" << target.wholeLoopName << "] Target unroll factor: " << target.targetUnrollFactor << "\n");
+	VERBOSE_PRINT(errs() << "[][][" << target.wholeLoopName << "] Target loop bound: " << target.loopBound << "\n");
+	VERBOSE_PRINT(errs() << "[][][" << target.wholeLoopName << "] Pipelining: " << (target.enablePipelining? "enabled" : "disabled") << "\n");
+
+	target.unrollFactor = (target.loopBound < target.targetUnrollFactor && target.loopBound)? target.loopBound : target.targetUnrollFactor;
+
+	return target;
+}
+
+static void writeExploreRow(std::ofstream &exploreFile, std::string code, std::string loopName, double frequency, uint64_t cycles, Pack P) {
+	std::string dsps = "0", ffs = "0", luts = "0", bram18k = "0";
+
+	// Empty datapaths do not fill their packs
+	for(auto &it : P.getStructure()) {
+		std::string name = std::get<0>(it);
+
+		if("DSPs" == name)
+			dsps = P.mergeElements<uint64_t>(name);
+		else if("FFs" == name)
+			ffs = P.mergeElements<uint64_t>(name);
+		else if("LUTs" == name)
+			luts = P.mergeElements<uint64_t>(name);
+		else if("BRAM18k" == name)
+			bram18k = std::to_string(P.getElements<uint64_t>(name)[0]);
+	}
+
+	exploreFile << code << "," << std::get<1>(parseLoopName(loopName)) << "," << frequency << "," << cycles << "," <<
+		dsps << "," << ffs << "," << luts << "," << bram18k << "\n";
+}
+
+void InstrumentForDDDG::exploreDesignGroup(std::string kernelName, designGroupTy &group, double uncertainty, std::ofstream &exploreFile) {
+	VERBOSE_PRINT(errs() << "[][designSpaceExploration] Exploring loop configuration " << group.loopsCode << "\n");
+
+	// All design points of this group share the same loop configuration, thus the unrolling database is built once
+	std::vector<std::unique_ptr<ConfigurationManager>> CMs;
+	for(unsigned i = 0; i < group.partitionings.size(); i++) {
+		std::stringstream configStream(group.partitionings[i].second + group.loopsCfg);
+		std::vector<std::string> scratchPipelineLoopLevelVec;
+
+		CMs.push_back(std::unique_ptr<ConfigurationManager>(new ConfigurationManager(kernelName)));
+		CMs.back()->parseAndPopulate(i? scratchPipelineLoopLevelVec : pipelineLoopLevelVec, configStream);
+	}
+	ConfigurationManager &CM = *(CMs.at(0));
+	updateUnrollingDatabase(CM.getUnrollingCfg());
+
+	// Frequencies are evaluated together as a clock sweep when possible, otherwise one at a time
+	std::vector<std::vector<unsigned>> batches;
+	if(!(args.compressed) && !(args.fNPLA)) {
+		batches.push_back(std::vector<unsigned>());
+		for(unsigned i = 0; i < group.frequencies.size(); i++)
+			batches.back().push_back(i);
+	}
+	else {
+		for(unsigned i = 0; i < group.frequencies.size(); i++)
+			batches.push_back(std::vector<unsigned>(1, i));
+	}
+
+	for(auto &batch : batches) {
+		args.clockTargets.clear();
+		for(auto &it : batch)
+			args.clockTargets.push_back(std::make_pair(group.frequencies[it].first, uncertainty));
+		args.frequency = args.clockTargets[0].first;
+		args.uncertainty = args.clockTargets[0].second;
+
+		// Structured results are identified by the design point code of their clock target and partitioning
+		auto setDesignPoints = [&group, &batch](unsigned partitioning) {
+			std::vector<std::pair<double, std::string>> points;
+			for(unsigned j = 0; j < batch.size(); j++) {
+				points.push_back(std::make_pair(
+					args.clockTargets[j].first, group.frequencies[batch[j]].second + group.loopsCode + group.partitionings[partitioning].first
+				));
+			}
+			resultWriter.setDesignPoints(points);
+		};
+
+#ifdef PROGRESSIVE_TRACE_CURSOR
+		// Loops are traversed from the beginning of the trace for every batch
+		progressiveTraceCursor = 0;
+		progressiveTraceInstCount = 0;
+#endif
+
+		for(auto &it : loopName2levelUnrollVecMap) {
+			std::string loopName = it.first;
+
+			if(!isTargetLoop(loopName))
+				continue;
+
+			std::vector<unsigned> &levelUnrollVec = it.second;
+			loopTargetTy target = getLoopTarget(loopName, levelUnrollVec, pipelineLoopLevelVec);
+			unsigned actualUnrollFactor = (target.loopBound < (target.targetUnrollFactor << 1) && target.loopBound)?
+				target.loopBound : (target.targetUnrollFactor << 1);
 
-			errs() << "[][][" << targetWholeLoopName << "] Estimated cycles: " << std::to_string(DD.getCycles()) << "\n";
+			if(args.fNPLA) {
+				// Multipaths are rebuilt for each partitioning, starting from the same trace position
+#ifdef PROGRESSIVE_TRACE_CURSOR
+				long int savedTraceCursor = progressiveTraceCursor;
+				uint64_t savedTraceInstCount = progressiveTraceInstCount;
+#endif
+
+				for(unsigned i = 0; i < group.partitionings.size(); i++) {
+#ifdef PROGRESSIVE_TRACE_CURSOR
+					progressiveTraceCursor = savedTraceCursor;
+					progressiveTraceInstCount = savedTraceInstCount;
+#endif
+					std::string code = group.frequencies[batch[0]].second + group.loopsCode + group.partitionings[i].first;
+					setDesignPoints(i);
+
+					if(target.enablePipelining) {
+						Multipath MD(
+							kernelName, *(CMs[i]), &summaryFile, loopName, target.loopLevel, 1, target.unrollFactor, levelUnrollVec, actualUnrollFactor
+						);
+						writeExploreRow(exploreFile, code, loopName, args.frequency, MD.getCycles(), MD.getPack());
+					}
+					else {
+						Multipath MD(kernelName, *(CMs[i]), &summaryFile, loopName, target.loopLevel, 1, target.unrollFactor, levelUnrollVec);
+						writeExploreRow(exploreFile, code, loopName, args.frequency, MD.getCycles(), MD.getPack());
+					}
+				}
+			}
+			else {
+				unsigned recII = 0;
+				std::vector<uint64_t> sweepRecII;
+
+				if(target.enablePipelining && !(args.fModuloScheduling)) {
+					DynamicDatapath DD(kernelName, CM, &summaryFile, loopName, target.loopLevel, actualUnrollFactor);
+					recII = DD.getASAPII();
+					sweepRecII = DD.getSweepASAPII();
+				}
+
+				// The DDDG is built and optimised once, other partitionings only repeat the resource-constrained part
+				setDesignPoints(0);
+				DynamicDatapath DD(kernelName, CM, &summaryFile, loopName, target.loopLevel, target.unrollFactor, target.enablePipelining, recII, sweepRecII);
+
+				for(unsigned i = 0; i < group.partitionings.size(); i++) {
+					if(i) {
+						setDesignPoints(i);
+						DD.reestimateWithPartitions(CMs[i]->getPartitionCfgMap(), CMs[i]->getCompletePartitionCfgMap());
+					}
+
+					for(unsigned j = 0; j < batch.size(); j++) {
+						std::string code = group.frequencies[batch[j]].second + group.loopsCode + group.partitionings[i].first;
+
+						if(DD.getSweepCycles().size())
+							writeExploreRow(exploreFile, code, loopName, args.clockTargets[j].first, DD.getSweepCycles()[j], DD.getSweepPacks()[j]);
+						else
+							writeExploreRow(exploreFile, code, loopName, args.clockTargets[j].first, DD.getCycles(), DD.getPack());
+					}
+				}
+			}
+
+			errs() << "[][][" << target.wholeLoopName << "] Explored " << std::to_string(batch.size() * group.partitionings.size()) <<
+				" design points for configuration " << group.loopsCode << "\n";
+		}
+	}
+}
+
+void InstrumentForDDDG::designSpaceExploration() {
+	VERBOSE_PRINT(errs() << "[][designSpaceExploration] Design space exploration started\n");
+
+	std::string kernelName = mangleFunctionName(args.kernelNames.at(0));
+	DesignSpace DS(args.exploreFileName, kernelName);
+
+	// The platform in the design space file, if any, overrides the target
+	std::string platform = DS.getPlatform();
+	std::transform(platform.begin(), platform.end(), platform.begin(), ::toupper);
+	if("ZC702" == platform)
+		args.target = ArgPack::TARGET_XILINX_ZC702;
+	else if("ZCU102" == platform)
+		args.target = ArgPack::TARGET_XILINX_ZCU102;
+	else if("ZCU104" == platform)
+		args.target = ArgPack::TARGET_XILINX_ZCU104;
+	else if("VC707" == platform)
+		args.target = ArgPack::TARGET_XILINX_VC707;
+	else
+		assert(platform.empty() && "Invalid platform in design space file");
+
+	// Design points are grouped by loop configuration, since only this part changes the DDDGs
+	VERBOSE_PRINT(errs() << "[][designSpaceExploration] Enumerating design points\n");
+	std::vector<designGroupTy> groups;
+	unsigned numOfPoints = 0;
+	while(DS.generateDesignPoint()) {
+		if(DS.bypass())
+			continue;
+
+		std::string loopsCode = DS.getLoopsCode();
+		std::string arraysCode = DS.getArraysCode();
+		std::string code = DS.getCode();
+		std::string freqCode = code.substr(0, code.size() - loopsCode.size() - arraysCode.size());
+
+		std::vector<designGroupTy>::iterator found = std::find_if(groups.begin(), groups.end(),
+			[&loopsCode](const designGroupTy &group) { return loopsCode == group.loopsCode; });
+		if(groups.end() == found) {
+			std::stringstream loopsCfg;
+			DS.writeLoopsConfiguration(loopsCfg);
+
+			groups.push_back(designGroupTy());
+			groups.back().loopsCode = loopsCode;
+			groups.back().loopsCfg = loopsCfg.str();
+			found = groups.end() - 1;
+		}
+
+		std::vector<std::pair<double, std::string>> &frequencies = found->frequencies;
+		if(frequencies.end() == std::find_if(frequencies.begin(), frequencies.end(),
+			[&freqCode](const std::pair<double, std::string> &freq) { return freqCode == freq.second; }))
+			frequencies.push_back(std::make_pair(DS.getFrequency(), freqCode));
+
+		std::vector<std::pair<std::string, std::string>> &partitionings = found->partitionings;
+		if(partitionings.end() == std::find_if(partitionings.begin(), partitionings.end(),
+			[&arraysCode](const std::pair<std::string, std::string> &part) { return arraysCode == part.first; })) {
+			std::stringstream arraysCfg;
+			DS.writeArraysConfiguration(arraysCfg);
+			partitionings.push_back(std::make_pair(arraysCode, arraysCfg.str()));
 		}
+
+		numOfPoints++;
 	}
+	errs() << "[][designSpaceExploration] " << std::to_string(numOfPoints) << " design points in " << std::to_string(groups.size()) << " loop configurations\n";
+
+	openSummaryFile(kernelName, summaryFileName, summaryFile);
+
+	std::string exploreFileName(args.outWorkDir + demangleFunctionName(kernelName) + FILE_EXPLORE_SUFFIX);
+	std::ofstream exploreFile(exploreFileName);
+	assert(exploreFile.is_open() && "Could not open exploration output file");
+	exploreFile << "code,loop,frequency,cycles,dsps,ffs,luts,bram18k\n";
+
+#ifdef FUTURE_CACHE
+	if(args.futureCache) {
+		if(futureCache.load())
+			VERBOSE_PRINT(errs() << "[][designSpaceExploration] Future cache file found.\n");
+		else
+			VERBOSE_PRINT(errs() << "[][designSpaceExploration] Future cache file not found or is corrupt. Starting from scratch\n");
+	}
+#endif
+
+	std::vector<std::pair<double, double>> clockTargets = args.clockTargets;
+	for(auto &it : groups)
+		exploreDesignGroup(kernelName, it, clockTargets[0].second, exploreFile);
+	args.clockTargets = clockTargets;
+	args.frequency = args.clockTargets[0].first;
+	args.uncertainty = args.clockTargets[0].second;
 
 #ifdef FUTURE_CACHE
 	if(args.futureCache) {
 		futureCache.dumpSummary(&summaryFile);
+		futureCache.writeResults();
 
-		VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Saving future cache\n");
+		VERBOSE_PRINT(errs() << "[][designSpaceExploration] Saving future cache\n");
 		futureCache.save();
 	}
 #endif
 
-	closeSummaryFile();
-	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Summary file closed\n");
+	exploreFile.close();
+	closeSummaryFile(summaryFile);
 
-	VERBOSE_PRINT(errs() << "[][loopBasedTraceAnalysis] Finished\n");
-
-
-#ifdef DBG_PRINT_ALL
-	CM.parseToFiles();
-#endif
+	VERBOSE_PRINT(errs() << "[][designSpaceExploration] Finished\n");
 }
 
-void InstrumentForDDDG::openSummaryFile(std::string kernelName) {
-	std::string fileName(args.outWorkDir + demangleFunctionName(kernelName) + FILE_SUMMARY_SUFFIX);
+void InstrumentForDDDG::openSummaryFile(std::string kernelName, std::string &summaryFileName, std::ofstream &summaryFile) {
+	summaryFileName = args.outWorkDir + demangleFunctionName(kernelName) + FILE_SUMMARY_SUFFIX;
 	if(summaryFile.is_open())
 		summaryFile.close();
-	summaryFile.open(fileName);
+	summaryFile.open(summaryFileName);
 
 	assert(summaryFile.is_open() && "Could not open summary output file");
 
@@ -985,7 +1526,7 @@ void InstrumentForDDDG::openSummaryFile(std::string kernelName) {
 	summaryFile << "Function name: " << demangleFunctionName(kernelName) << "\n";
 }
 
-void InstrumentForDDDG::closeSummaryFile() {
+void InstrumentForDDDG::closeSummaryFile(std::ofstream &summaryFile) {
 	summaryFile << "================================================\n";
 	summaryFile.close();
 }
@@ -994,6 +1535,8 @@ ProfilingEngine::ProfilingEngine(Module &M, TraceLogger &TL) : M(M), TL(TL) {
 }
 
 void ProfilingEngine::runOnProfiler() {
+	PHASE_SCOPE(phase, "jitTrace");
+
 	VERBOSE_PRINT(errs() << "[][profilingEngine] Profiling engine started\n");
 
 	VERBOSE_PRINT(errs() << "[][profilingEngine] Creating context\n");
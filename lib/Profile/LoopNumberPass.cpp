@@ -14,6 +14,8 @@
 
 #include "profile_h/LoopNumberPass.h"
 
+#include "profile_h/PhaseProfiler.h"
+
 #define DEBUG_TYPE "loop-number"
 
 using namespace llvm;
@@ -52,6 +54,8 @@ void LoopNumber::getAnalysisUsage(AnalysisUsage &AU) const {
 }
 
 bool LoopNumber::runOnLoop(Loop *L, LPPassManager &LPM) {
+	PHASE_SCOPE(phase, "loopNumber");
+
 	/// Check whether loop is in a simplify form
 	assert(L->isLoopSimplifyForm() && "Loop is not in a simplify form!\n");
 
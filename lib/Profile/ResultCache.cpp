@@ -0,0 +1,303 @@
+#include "profile_h/ResultCache.h"
+
+#ifdef RESULT_CACHE
+#include <iomanip>
+#include <sstream>
+
+void ResultCache::dumpSummary(std::ofstream *summaryFile) {
+	*summaryFile << "================================================\n";
+	*summaryFile << "No. of result cache miss: " << std::to_string(cacheMiss) << "\n";
+	*summaryFile << "No. of result cache hit: " << std::to_string(cacheHit) << "\n";
+}
+
+std::string ResultCache::hashKey(const std::string &canonicalKey) {
+	// FNV-1a (64 bits). Collisions are resolved by comparing the canonical keys
+	uint64_t hash = 14695981039346656037ull;
+
+	for(auto &it : canonicalKey) {
+		hash ^= (uint8_t) it;
+		hash *= 1099511628211ull;
+	}
+
+	std::stringstream ss;
+	ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+
+	return ss.str();
+}
+
+bool ResultCache::consumeEntry(const std::string &payload) {
+	size_t pos = 0;
+	std::string hash, canonicalKey, value;
+
+	/* Each payload: hash, canonical key and value */
+	if(!AppendLog::extractElement(payload, pos, hash) || !AppendLog::extractElement(payload, pos, canonicalKey) ||
+		!AppendLog::extractElement(payload, pos, value) || pos != payload.size())
+		return false;
+
+	cache.insert(std::make_pair(hash, std::make_pair(canonicalKey, value)));
+
+	return true;
+}
+
+bool ResultCache::findEntry(const std::string &canonicalKey, std::string &value) {
+	std::string hash = hashKey(canonicalKey);
+	auto found = cache.find(hash);
+
+	// Other executions may have found this entry in the meantime
+	if(cache.end() == found && cacheLog.isOpen()) {
+		cacheLog.catchUp([this](const std::string &payload) { return consumeEntry(payload); });
+		found = cache.find(hash);
+	}
+
+	if(cache.end() == found || found->second.first != canonicalKey)
+		return false;
+
+	value = found->second.second;
+
+	return true;
+}
+
+void ResultCache::insertEntry(const std::string &canonicalKey, const std::string &value) {
+	std::string hash = hashKey(canonicalKey);
+
+	cacheLog.append(
+		[this](const std::string &payload) { return consumeEntry(payload); },
+		[this, &hash, &canonicalKey, &value](std::string &payload) {
+			if(!(cache.insert(std::make_pair(hash, std::make_pair(canonicalKey, value))).second))
+				return false;
+
+			AppendLog::appendElement(payload, hash);
+			AppendLog::appendElement(payload, canonicalKey);
+			AppendLog::appendElement(payload, value);
+
+			return true;
+		}
+	);
+}
+
+ResultCache::~ResultCache() {
+	save();
+}
+
+bool ResultCache::load() {
+	clear();
+	save();
+
+	return cacheLog.open(args.workDir + FILE_RESULT_CACHE, FILE_RESULT_CACHE_MAGIC_STRING, [this](const std::string &payload) { return consumeEntry(payload); });
+}
+
+// Entries are already in the log when inserted, only the log is closed here
+void ResultCache::save() {
+	cacheLog.close();
+}
+
+std::string ResultCache::constructBaseKey(
+	std::string kernelName, std::string wholeLoopName, unsigned loopLevel,
+	const std::vector<unsigned> &levelUnrollVec, uint64_t unrollFactor, bool enablePipelining
+) {
+	std::stringstream key;
+	uint64_t traceSize = 0, traceModTime = 0, bitcodeSize = 0, bitcodeModTime = 0;
+
+	// Results are only valid for the same dynamic trace and bitcode
+	getFileStamp(args.workDir + FILE_DYNAMIC_TRACE, traceSize, traceModTime);
+	getFileStamp(args.inputFileName, bitcodeSize, bitcodeModTime);
+
+	key << "version=" << RESULT_CACHE_VERSION << "\n";
+	key << "trace=" << traceSize << "," << traceModTime << "\n";
+	key << "bitcode=" << bitcodeSize << "," << bitcodeModTime << "\n";
+	key << "kernel=" << kernelName << "\n";
+	key << "loop=" << wholeLoopName << "," << loopLevel << "\n";
+	key << "unroll=" << unrollFactor;
+	for(auto &it : levelUnrollVec)
+		key << "," << it;
+	key << "\n";
+	key << "pipelining=" << enablePipelining << "\n";
+	key << "target=" << args.target << "\n";
+
+	// Only the effective period is used by the estimation. The clock itself is patched in the summary on a hit
+	key << "periods=";
+	for(auto &it : args.clockTargets)
+		key << std::to_string((1000 / it.first) - (10 * it.second / it.first)) << ",";
+	key << "\n";
+
+	key << "flags=" << args.fNPLA << args.fNoTCS << args.fSBOpt << args.fSLROpt << args.fNoSLROpt << args.fRSROpt <<
+		args.fTHRFloatOpt << args.fTHRIntOpt << args.fMemDisambuigOpt << args.fNoFPUThresOpt << args.fExtraScalar <<
+		args.fRWRWMem << args.fModuloScheduling << args.fArgRes << args.fILL << "\n";
+	if(args.fExtrapolate)
+		key << "extrapolation=" << args.extrapolationTolerance << "\n";
+
+	return key.str();
+}
+
+std::string ResultCache::constructFullKey(std::string baseKey, const std::set<std::string> &referencedArrays, const ConfigurationManager &CM) {
+	std::stringstream key;
+	const ConfigurationManager::partitionCfgMapTy &partitionCfgMap = CM.getPartitionCfgMap();
+	const ConfigurationManager::partitionCfgMapTy &completePartitionCfgMap = CM.getCompletePartitionCfgMap();
+
+	key << baseKey;
+
+	// arrayInfoCfgMap is ordered, thus the key is canonical
+	for(auto &it : CM.getArrayInfoCfgMap()) {
+		std::string arrayName = it.first;
+		unsigned scope = it.second.scope;
+		bool shouldCount = (ConfigurationManager::arrayInfoCfgTy::ARRAY_SCOPE_ROVAR == scope || ConfigurationManager::arrayInfoCfgTy::ARRAY_SCOPE_RWVAR == scope)
+			|| (args.fArgRes && scope != ConfigurationManager::arrayInfoCfgTy::ARRAY_SCOPE_NOCOUNT);
+
+		key << "array=" << arrayName;
+
+		// Arrays not accessed by the loop only affect the estimation through memory resources (if counted)
+		if(!(referencedArrays.count(arrayName)) && !shouldCount) {
+			key << "\n";
+			continue;
+		}
+
+		key << "," << it.second.totalSize << "," << it.second.wordSize << "," << scope;
+
+		ConfigurationManager::partitionCfgMapTy::const_iterator found = completePartitionCfgMap.find(arrayName);
+		ConfigurationManager::partitionCfgMapTy::const_iterator found2 = partitionCfgMap.find(arrayName);
+		if(found != completePartitionCfgMap.end())
+			key << ",complete," << found->second.size;
+		else if(found2 != partitionCfgMap.end())
+			key << ",partition," << found2->second.type << "," << found2->second.size << "," << found2->second.wordSize << "," << found2->second.pFactor;
+		else
+			key << ",none";
+
+		key << "\n";
+	}
+
+	return key.str();
+}
+
+// A cached summary may come from a different clock target with same effective period, and from a different
+// partitioning of arrays that are not accessed by the loop. These lines are rewritten for the current configuration
+std::string ResultCache::rewriteSummary(const std::string &summary, const std::set<std::string> &referencedArrays, const ConfigurationManager &CM) {
+	const ConfigurationManager::partitionCfgMapTy &partitionCfgMap = CM.getPartitionCfgMap();
+	const ConfigurationManager::partitionCfgMapTy &completePartitionCfgMap = CM.getCompletePartitionCfgMap();
+	const std::string clockPrefix("Target clock: ");
+	const std::string uncertaintyPrefix("Clock uncertainty: ");
+	const std::string periodPrefix("Target clock period: ");
+	const std::string partitionsPrefix("Number of partitions for array \"");
+
+	std::map<std::string, uint64_t> unreferencedPartitions;
+	for(auto &it : CM.getArrayInfoCfgMap()) {
+		std::string arrayName = it.first;
+		if(referencedArrays.count(arrayName))
+			continue;
+
+		// Same number of partitions set by XilinxHardwareProfile::setMemoryCurrentUsage()
+		ConfigurationManager::partitionCfgMapTy::const_iterator found = completePartitionCfgMap.find(arrayName);
+		ConfigurationManager::partitionCfgMapTy::const_iterator found2 = partitionCfgMap.find(arrayName);
+		if(found != completePartitionCfgMap.end())
+			unreferencedPartitions[demangleArrayName(arrayName)] = 0;
+		else if(found2 != partitionCfgMap.end())
+			unreferencedPartitions[demangleArrayName(arrayName)] = found2->second.pFactor;
+		else
+			unreferencedPartitions[demangleArrayName(arrayName)] = 1;
+	}
+
+	std::stringstream in(summary);
+	std::string out, line;
+	unsigned clockCount = 0, uncertaintyCount = 0, periodCount = 0;
+	unsigned numOfTargets = args.clockTargets.size();
+
+	while(std::getline(in, line)) {
+		if(!(line.compare(0, clockPrefix.size(), clockPrefix))) {
+			line = clockPrefix + std::to_string(args.clockTargets[clockCount++ % numOfTargets].first) + " MHz";
+		}
+		else if(!(line.compare(0, uncertaintyPrefix.size(), uncertaintyPrefix))) {
+			line = uncertaintyPrefix + std::to_string(args.clockTargets[uncertaintyCount++ % numOfTargets].second) + " %";
+		}
+		else if(!(line.compare(0, periodPrefix.size(), periodPrefix))) {
+			line = periodPrefix + std::to_string(1000 / args.clockTargets[periodCount++ % numOfTargets].first) + " ns";
+		}
+		else if(!(line.compare(0, partitionsPrefix.size(), partitionsPrefix))) {
+			size_t nameEnd = line.rfind("\": ");
+			if(nameEnd != std::string::npos) {
+				std::string arrayName = line.substr(partitionsPrefix.size(), nameEnd - partitionsPrefix.size());
+				std::map<std::string, uint64_t>::iterator found = unreferencedPartitions.find(arrayName);
+				if(found != unreferencedPartitions.end())
+					line = line.substr(0, nameEnd + 3) + std::to_string(found->second);
+			}
+		}
+
+		out += line + "\n";
+	}
+
+	return out;
+}
+
+bool ResultCache::findReferencedArrays(std::string baseKey, std::set<std::string> &referencedArrays) {
+	std::string value;
+
+	referencedArrays.clear();
+	if(!findEntry(baseKey, value))
+		return false;
+
+	size_t pos = 0;
+	size_t numOfArrays;
+	if(!AppendLog::extractElement(value, pos, numOfArrays))
+		return false;
+
+	for(size_t i = 0; i < numOfArrays; i++) {
+		std::string arrayName;
+		if(!AppendLog::extractElement(value, pos, arrayName)) {
+			referencedArrays.clear();
+			return false;
+		}
+
+		referencedArrays.insert(arrayName);
+	}
+
+	return true;
+}
+
+bool ResultCache::find(std::string fullKey, ResultCache::resultTy &result) {
+	std::string value;
+
+	if(!findEntry(fullKey, value)) {
+		cacheMiss++;
+		return false;
+	}
+
+	size_t pos = 0;
+	size_t numOfCycles;
+	bool success = AppendLog::extractElement(value, pos, numOfCycles);
+
+	result.cycles.clear();
+	for(size_t i = 0; success && i < numOfCycles; i++) {
+		uint64_t cycles;
+		success = AppendLog::extractElement(value, pos, cycles);
+		result.cycles.push_back(cycles);
+	}
+
+	success = success && AppendLog::extractElement(value, pos, result.cursorBefore) && AppendLog::extractElement(value, pos, result.instCountBefore) &&
+		AppendLog::extractElement(value, pos, result.cursorAfter) && AppendLog::extractElement(value, pos, result.instCountAfter) &&
+		AppendLog::extractElement(value, pos, result.summary);
+
+	if(success)
+		cacheHit++;
+	else
+		cacheMiss++;
+
+	return success;
+}
+
+void ResultCache::insert(std::string baseKey, const std::set<std::string> &referencedArrays, std::string fullKey, const ResultCache::resultTy &result) {
+	std::string arraysValue;
+	AppendLog::appendElement(arraysValue, referencedArrays.size());
+	for(auto &it : referencedArrays)
+		AppendLog::appendElement(arraysValue, it);
+	insertEntry(baseKey, arraysValue);
+
+	std::string resultValue;
+	AppendLog::appendElement(resultValue, result.cycles.size());
+	for(auto &it : result.cycles)
+		AppendLog::appendElement(resultValue, it);
+	AppendLog::appendElement(resultValue, result.cursorBefore);
+	AppendLog::appendElement(resultValue, result.instCountBefore);
+	AppendLog::appendElement(resultValue, result.cursorAfter);
+	AppendLog::appendElement(resultValue, result.instCountAfter);
+	AppendLog::appendElement(resultValue, result.summary);
+	insertEntry(fullKey, resultValue);
+}
+#endif
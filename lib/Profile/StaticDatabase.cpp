@@ -0,0 +1,200 @@
+#include "profile_h/StaticDatabase.h"
+
+using namespace llvm;
+
+template<typename T> static void writeElement(std::ofstream &out, const T &value) {
+	out.write((const char *) &value, sizeof(T));
+}
+
+static void writeElement(std::ofstream &out, const std::string &value) {
+	size_t size = value.size();
+	out.write((const char *) &size, sizeof(size_t));
+	out.write(value.c_str(), size);
+}
+
+template<typename T, typename U> static void writeElement(std::ofstream &out, const std::pair<T, U> &value) {
+	writeElement(out, value.first);
+	writeElement(out, value.second);
+}
+
+template<typename T> static void writeMap(std::ofstream &out, const T &map) {
+	size_t size = map.size();
+	out.write((const char *) &size, sizeof(size_t));
+
+	for(auto &it : map) {
+		writeElement(out, it.first);
+		writeElement(out, it.second);
+	}
+}
+
+template<typename T> static void readElement(std::ifstream &in, T &value) {
+	in.read((char *) &value, sizeof(T));
+}
+
+static void readElement(std::ifstream &in, std::string &value) {
+	size_t size = 0;
+	in.read((char *) &size, sizeof(size_t));
+	if(!(in.good()))
+		return;
+
+	value.resize(size);
+	if(size)
+		in.read(&value[0], size);
+}
+
+template<typename T, typename U> static void readElement(std::ifstream &in, std::pair<T, U> &value) {
+	readElement(in, value.first);
+	readElement(in, value.second);
+}
+
+template<typename T> static bool readMap(std::ifstream &in, T &map) {
+	size_t size = 0;
+	in.read((char *) &size, sizeof(size_t));
+
+	map.clear();
+	for(size_t i = 0; i < size && in.good(); i++) {
+		typename T::key_type key;
+		typename T::mapped_type value;
+		readElement(in, key);
+		readElement(in, value);
+		map.insert(std::make_pair(key, value));
+	}
+
+	return in.good();
+}
+
+// The database covers all kernels of the run (a single kernel keeps the same layout as before)
+static std::string getKernelList() {
+	std::string kernelList = args.kernelNames.at(0);
+
+	for(unsigned i = 1; i < args.kernelNames.size(); i++)
+		kernelList += "," + args.kernelNames[i];
+
+	return kernelList;
+}
+
+void StaticDatabase::clear() {
+	functionName2MangledNameMap.clear();
+	mangledName2FunctionNameMap.clear();
+	getElementPtrName2arrayNameMap.clear();
+	arrayName2MangledNameMap.clear();
+	mangledName2ArrayNameMap.clear();
+	funcBBNmPair2numInstInBBMap.clear();
+	funcName2loopNumMap.clear();
+	bbFuncNamePair2lpNameLevelPairMap.clear();
+	headerBBFuncnamePair2lpNameLevelPairMap.clear();
+	exitBBFuncnamePair2lpNameLevelPairMap.clear();
+	LpName2numLevelMap.clear();
+	lpNameLevelPair2headBBnameMap.clear();
+	lpNameLevelPair2exitingBBnameMap.clear();
+	wholeloopName2loopBoundMap.clear();
+	wholeloopName2perfectOrNotMap.clear();
+	staticInstID2OpcodeMap.clear();
+	instName2bbNameMap.clear();
+	headerBBFuncNamePair2lastInstMap.clear();
+	exitingBBFuncNamePair2lastInstMap.clear();
+}
+
+bool StaticDatabase::load() {
+	std::ifstream databaseFile;
+	uint64_t bitcodeSize, bitcodeModTime;
+
+	if(!getFileStamp(args.inputFileName, bitcodeSize, bitcodeModTime))
+		return false;
+
+	databaseFile.open(args.workDir + FILE_STATIC_DATABASE, std::ios::in | std::ios::binary);
+	if(!(databaseFile.is_open()))
+		return false;
+
+	/* Check for magic bits and version */
+	char magicBits[4];
+	databaseFile.read(magicBits, std::string(FILE_STATIC_DATABASE_MAGIC_STRING).size());
+	magicBits[3] = '\0';
+	uint32_t version = 0;
+	readElement(databaseFile, version);
+	if(!(databaseFile.good()) || std::string(magicBits) != FILE_STATIC_DATABASE_MAGIC_STRING || version != STATIC_DATABASE_VERSION) {
+		databaseFile.close();
+		return false;
+	}
+
+	/* Check if the database was generated for these kernels and bitcode */
+	std::string kernelName;
+	uint64_t savedBitcodeSize = 0, savedBitcodeModTime = 0;
+	readElement(databaseFile, kernelName);
+	readElement(databaseFile, savedBitcodeSize);
+	readElement(databaseFile, savedBitcodeModTime);
+	if(!(databaseFile.good()) || kernelName != getKernelList() || savedBitcodeSize != bitcodeSize || savedBitcodeModTime != bitcodeModTime) {
+		databaseFile.close();
+		return false;
+	}
+
+	bool success = readMap(databaseFile, functionName2MangledNameMap) &&
+		readMap(databaseFile, mangledName2FunctionNameMap) &&
+		readMap(databaseFile, getElementPtrName2arrayNameMap) &&
+		readMap(databaseFile, arrayName2MangledNameMap) &&
+		readMap(databaseFile, mangledName2ArrayNameMap) &&
+		readMap(databaseFile, funcBBNmPair2numInstInBBMap) &&
+		readMap(databaseFile, funcName2loopNumMap) &&
+		readMap(databaseFile, bbFuncNamePair2lpNameLevelPairMap) &&
+		readMap(databaseFile, headerBBFuncnamePair2lpNameLevelPairMap) &&
+		readMap(databaseFile, exitBBFuncnamePair2lpNameLevelPairMap) &&
+		readMap(databaseFile, LpName2numLevelMap) &&
+		readMap(databaseFile, lpNameLevelPair2headBBnameMap) &&
+		readMap(databaseFile, lpNameLevelPair2exitingBBnameMap) &&
+		readMap(databaseFile, wholeloopName2loopBoundMap) &&
+		readMap(databaseFile, wholeloopName2perfectOrNotMap) &&
+		readMap(databaseFile, staticInstID2OpcodeMap) &&
+		readMap(databaseFile, instName2bbNameMap) &&
+		readMap(databaseFile, headerBBFuncNamePair2lastInstMap) &&
+		readMap(databaseFile, exitingBBFuncNamePair2lastInstMap);
+
+	databaseFile.close();
+
+	// A truncated database is discarded as a whole, the passes will populate everything again
+	if(!success)
+		clear();
+
+	return success;
+}
+
+void StaticDatabase::save() {
+	std::ofstream databaseFile;
+	uint64_t bitcodeSize, bitcodeModTime;
+
+	// Without a bitcode stamp, the database could never be validated when loaded
+	if(!getFileStamp(args.inputFileName, bitcodeSize, bitcodeModTime))
+		return;
+
+	databaseFile.open(args.workDir + FILE_STATIC_DATABASE, std::ios::out | std::ios::binary);
+	assert(databaseFile.is_open() && "Could not open static database file for writing");
+
+	databaseFile.write(FILE_STATIC_DATABASE_MAGIC_STRING, std::string(FILE_STATIC_DATABASE_MAGIC_STRING).size());
+	uint32_t version = STATIC_DATABASE_VERSION;
+	writeElement(databaseFile, version);
+
+	writeElement(databaseFile, getKernelList());
+	writeElement(databaseFile, bitcodeSize);
+	writeElement(databaseFile, bitcodeModTime);
+
+	writeMap(databaseFile, functionName2MangledNameMap);
+	writeMap(databaseFile, mangledName2FunctionNameMap);
+	writeMap(databaseFile, getElementPtrName2arrayNameMap);
+	writeMap(databaseFile, arrayName2MangledNameMap);
+	writeMap(databaseFile, mangledName2ArrayNameMap);
+	writeMap(databaseFile, funcBBNmPair2numInstInBBMap);
+	writeMap(databaseFile, funcName2loopNumMap);
+	writeMap(databaseFile, bbFuncNamePair2lpNameLevelPairMap);
+	writeMap(databaseFile, headerBBFuncnamePair2lpNameLevelPairMap);
+	writeMap(databaseFile, exitBBFuncnamePair2lpNameLevelPairMap);
+	writeMap(databaseFile, LpName2numLevelMap);
+	writeMap(databaseFile, lpNameLevelPair2headBBnameMap);
+	writeMap(databaseFile, lpNameLevelPair2exitingBBnameMap);
+	writeMap(databaseFile, wholeloopName2loopBoundMap);
+	writeMap(databaseFile, wholeloopName2perfectOrNotMap);
+	writeMap(databaseFile, staticInstID2OpcodeMap);
+	writeMap(databaseFile, instName2bbNameMap);
+	writeMap(databaseFile, headerBBFuncNamePair2lastInstMap);
+	writeMap(databaseFile, exitingBBFuncNamePair2lastInstMap);
+
+	databaseFile.close();
+}
@@ -22,10 +22,12 @@ const std::string helpMessage =
 	"    an expansion of the Lin-Analyzer High Level Analysis Tool for FPGA Accelerators\n"
 	"    visit: https://github.com/zhguanw/lin-analyzer\n"
 	"\n"
-	"Usage: lina [OPTION]... BYTECODEFILE KERNELNAME\n"
+	"Usage: lina [OPTION]... BYTECODEFILE KERNELNAME [KERNELNAME]...\n"
 	"Where:\n"
 	"    BYTECODEFILE is the optimised .bc file generated with the LLVM toolchain\n"
-	"    KERNELNAME is the kernel name (i.e. function name) to be analysed\n"
+	"    KERNELNAME is the kernel name (i.e. function name) to be analysed. If more\n"
+	"        than one is provided, all kernels are traced in a single run and\n"
+	"        analysed concurrently, each with its own summary file\n"
 	"    OPTION may be:\n"
 	"        -h       , --help             : this message\n"
 	"        -i PATH  , --workdir=PATH     : input working directory where trace should happen\n"
@@ -34,7 +36,9 @@ const std::string helpMessage =
 	"        -o PATH  , --out-workdir=PATH : output working directory where temporary files\n"
 	"                                        will be written. Default is $CWD\n"
 	"        -c FILE  , --config-file=FILE : use FILE as the configuration file for this\n"
-	"                                        application. Default is workdir/config.cfg\n"
+	"                                        application. Default is workdir/config.cfg.\n"
+	"                                        With several kernels, FILE may be a\n"
+	"                                        comma-separated list with one file per kernel\n"
 	"        -m MODE  , --mode=MODE        : set execution mode to MODE, where MODE may be:\n"
 	"                                            all       : perform dynamic trace and cycle\n"
 	"                                                        estimation (DEFAULT)\n"
@@ -62,8 +66,36 @@ const std::string helpMessage =
 	"                                        cursor is active with -p | --progressive. Future cache is\n"
 	"                                        disabled when runtime loop bound analysis is required.\n"
 #endif
+#ifdef RESULT_CACHE
+	"                   --result-cache     : use result cache. The estimation of each loop is\n"
+	"                                        cached in resultcache.db and reused by successive\n"
+	"                                        executions of Lina with an equivalent loop\n"
+	"                                        configuration (same effective unroll factors,\n"
+	"                                        pipelining, platform, effective clock period and\n"
+	"                                        partitioning of the arrays accessed by the loop).\n"
+	"                                        Bypassed if DDDG or scheduling dumps are requested\n"
+#endif
+#ifdef ENABLE_TIMER
+	"                   --phase-profile    : record wall time, CPU time and peak memory usage of\n"
+	"                                        each execution phase (passes, DDDG generation,\n"
+	"                                        optimisations, scheduling, etc.) per loop and\n"
+	"                                        datapath type in <kernel>_phases.json\n"
+#endif
+	"                   --result-format=FMT: also write the estimation results in a structured\n"
+	"                                        format to <kernel>_results.FMT, where FMT may be:\n"
+	"                                            jsonl : one JSON object per estimation, with\n"
+	"                                                    all values and resources\n"
+	"                                            csv   : one line per estimation, fixed columns\n"
+	"                                            bin   : same as jsonl, in binary form (see\n"
+	"                                                    misc/largedse/results.py)\n"
+	"                                        Result cache is bypassed if this is set\n"
 	"        -l LOOPS , --loops=LOOPS      : specify loops to be analysed comma-separated (e.g.\n"
 	"                                        --loops=2,3 only analyse loops 2 and 3)\n"
+	"                   --explore=FILE     : explore the design space described in FILE (JSON,\n"
+	"                                        see misc/largedse) in a single execution. The\n"
+	"                                        configuration file and -f | --frequency are ignored.\n"
+	"                                        One CSV line per design point and loop is written\n"
+	"                                        to <kernel>_explore.csv\n"
 	"                   --mem-trace        : obtain memory trace for access pattern analysis.\n"
 	"                                        Ignored if -m estimation | --mode=estimation is\n"
 	"                                        set.\n"
@@ -72,15 +104,40 @@ const std::string helpMessage =
 	"                   --show-detail-cfg  : dump detailed CFG with instructions\n"
 	"                   --show-pre-dddg    : dump DDDG before optimisation\n"
 	"                   --show-post-dddg   : dump DDDG after optimisation\n"
+	"                   --dddg-format=FMT  : format of the DDDG dumps, where FMT may be:\n"
+	"                                            dot : Graphviz DOT (default)\n"
+	"                                            bin : compact binary with microops, ASAP/ALAP\n"
+	"                                                  times and edges (see misc/largedse/dddg.py)\n"
+	"                   --dddg-filter=FILTER: dump only part of the DDDG (DOT only), where FILTER\n"
+	"                                        may be:\n"
+	"                                            iter:N : nodes of the N-th iteration (from 0)\n"
+	"                                                     of the analysed loop\n"
+	"                                            cpath  : nodes of the critical path (requires\n"
+	"                                                     --show-post-dddg only)\n"
 	"                   --show-scheduling  : dump constrained-scheduling\n"
 	"\n"
 	"Analysis enable/disable flags:\n"
 	"                   --f-npla           : enable non-perfect loop analysis\n"
 	"                   --fno-tcs          : disable timing-constrained scheduling\n"
+	"                   --f-extrapolate    : estimate loops with unroll factor of 16 or more by\n"
+	"                                        extrapolating from the DDDGs with unroll factors 1,\n"
+	"                                        2, 4 and 8. Falls back to full estimation if the\n"
+	"                                        samples do not scale linearly. Not supported with\n"
+	"                                        clock sweeps or --f-npla, ignored with --explore\n"
+	"                   --extrapolation-tol=TOL: maximum deviation (in %) of the samples from\n"
+	"                                        the extrapolation fit. Default is 5\n"
 	"\n"
 	"Timing-constrained flags (ignored if \"--fno-tcs\" is set):\n"
-	"        -f FREQ  , --frequency=FREQ   : specify the target clock (in MHz)\n"
-	"        -u UNCTY , --uncertainty=UNCTY: specify the clock uncertainty (in %)\n"
+	"        -f FREQ  , --frequency=FREQ   : specify the target clock (in MHz). A comma-separated\n"
+	"                                        list (e.g. --frequency=100,200,250) performs a clock\n"
+	"                                        sweep: the DDDG of each loop is built and optimised\n"
+	"                                        once and scheduled for each target in parallel,\n"
+	"                                        generating one summary entry per target. Not supported\n"
+	"                                        with -x | --compressed or --f-npla\n"
+	"        -u UNCTY , --uncertainty=UNCTY: specify the clock uncertainty (in %). When a clock\n"
+	"                                        sweep is performed, either a single value (applied\n"
+	"                                        to all targets) or one value per target must be\n"
+	"                                        provided comma-separated\n"
 	"\n"
 	"Lin-Analyzer flags:\n"
 	"                   --fno-sb           : disable store-buffer optimisation\n"
@@ -93,10 +150,14 @@ const std::string helpMessage =
 	"                                        operations\n"
 	"                   --f-thr-int        : enable tree-height-reduction for integer\n"
 	"                                        operations\n"
-	"                   --f-md             : enable memory-disambiguation optimisation\n"
+	"                   --f-md             : enable memory disambiguation: loads that depend on\n"
+	"                                        more than one store are serialised with the stores\n"
+	"                                        whose addresses are not affine\n"
 	"                   --fno-ft           : disable FPU threshold optimisation\n"
 	"                   --f-es             : enable extra-scalar\n"
 	"                   --f-rwrwm          : enable RWRW memory\n"
+	"                   --f-ms             : calculate II and IL of pipelined loops using\n"
+	"                                        iterative modulo scheduling\n"
 	"Other flags:\n"
 	"                   --f-argres         : consider resource used by function arguments\n"
 	"\n"
@@ -104,10 +165,26 @@ const std::string helpMessage =
 
 ArgPack args;
 #ifdef PROGRESSIVE_TRACE_CURSOR
-long int progressiveTraceCursor = 0;
-uint64_t progressiveTraceInstCount = 0;
+thread_local long int progressiveTraceCursor = 0;
+thread_local uint64_t progressiveTraceInstCount = 0;
 #endif
 
+static std::vector<std::string> splitCommaSeparated(std::string str) {
+	std::vector<std::string> elements;
+	size_t commaPos;
+
+	while((commaPos = str.find(",")) != std::string::npos) {
+		std::string element = str.substr(0, commaPos);
+		str.erase(0, commaPos + 1);
+		if(element != "")
+			elements.push_back(element);
+	}
+	if(str != "")
+		elements.push_back(str);
+
+	return elements;
+}
+
 int main(int argc, char **argv) {
 #ifdef DBG_FILE
 	debugFile.open(DBG_FILE);
@@ -125,11 +202,44 @@ int main(int argc, char **argv) {
 	errs() << "░░▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▒▒\n";
 	errs() << "▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒▒\n";
 
+	// When only estimating, the static analysis saved when the trace was generated makes the IR passes unnecessary
+	if(args.MODE_ESTIMATE_ONLY == args.mode) {
+		// The pass constructor resets part of the static database, thus it must be created before loading
+		InstrumentForDDDG estimator;
+
+		bool staticDatabaseLoaded;
+		{
+			PHASE_SCOPE(phase, "staticDatabaseLoad");
+			staticDatabaseLoaded = StaticDatabase::load();
+		}
+
+		if(staticDatabaseLoaded) {
+			VERBOSE_PRINT(errs() << "Static database loaded, skipping IR passes\n");
+
+			estimator.performEstimation();
+
+#ifdef ENABLE_TIMER
+			phaseProfiler.dump(args.kernelNames.at(0));
+#endif
+
+#ifdef DBG_FILE
+			debugFile.close();
+#endif
+
+			return 0;
+		}
+
+		VERBOSE_PRINT(errs() << "Static database not found or outdated, running IR passes\n");
+	}
+
 	LLVMContext &Context = getGlobalContext();
 	SMDiagnostic Err;
 
 	std::unique_ptr<Module> M;
-	M.reset(ParseIRFile(InputFilename, Err, Context));
+	{
+		PHASE_SCOPE(phase, "bitcodeLoad");
+		M.reset(ParseIRFile(InputFilename, Err, Context));
+	}
 	if(!M.get()) {
 		Err.print(argv[0], errs());
 		return 1;
@@ -177,6 +287,10 @@ int main(int argc, char **argv) {
 	// Declare success.
 	Out->keep();
 
+#ifdef ENABLE_TIMER
+	phaseProfiler.dump(args.kernelNames.at(0));
+#endif
+
 #ifdef DBG_FILE
 	debugFile.close();
 #endif
@@ -191,12 +305,15 @@ void parseInputArguments(int argc, char **argv) {
 		exit(-1);
 	}
 	std::string optargStr;
-	size_t commaPos;
+	char *optargEnd;
+	std::vector<double> frequencies;
+	std::vector<double> uncertainties;
 
 	args.inputFileName = "";
 	args.workDir = temp;
 	args.outWorkDir = temp;
 	args.configFileName = "config.cfg";
+	args.exploreFileName = "";
 	args.mode = args.MODE_TRACE_AND_ESTIMATE;
 	args.target = args.TARGET_XILINX_ZC702;
 	args.compressed = false;
@@ -206,6 +323,13 @@ void parseInputArguments(int argc, char **argv) {
 #ifdef FUTURE_CACHE
 	args.futureCache = false;
 #endif
+#ifdef RESULT_CACHE
+	args.resultCache = false;
+#endif
+#ifdef ENABLE_TIMER
+	args.phaseProfile = false;
+#endif
+	args.resultFormat = args.RESULT_FORMAT_NONE;
 	args.frequency = 100.0;
 	args.uncertainty = 27;
 	args.verbose = false;
@@ -214,6 +338,9 @@ void parseInputArguments(int argc, char **argv) {
 	args.showCFGDetailed = false;
 	args.showPreOptDDDG = false;
 	args.showPostOptDDDG = false;
+	args.dddgFormat = args.DDDG_FORMAT_DOT;
+	args.dddgFilter = args.DDDG_FILTER_NONE;
+	args.dddgFilterIteration = 0;
 	args.showScheduling = false;
 	args.fNPLA = false;
 	args.fNoTCS = false;
@@ -227,10 +354,13 @@ void parseInputArguments(int argc, char **argv) {
 	args.fNoFPUThresOpt = false;
 	args.fExtraScalar = false;
 	args.fRWRWMem = false;
+	args.fModuloScheduling = false;
 	args.fArgRes = false;
 	// XXX: Does not seem to make sense for me right now to leave this deactivated
 	// since according to Vivado reports, the load latency is in fact 2
 	args.fILL = true;
+	args.fExtrapolate = false;
+	args.extrapolationTolerance = EXTRAPOLATION_DEFAULT_TOLERANCE;
 
 	int c;
 	while(true) {
@@ -271,6 +401,19 @@ void parseInputArguments(int argc, char **argv) {
 			{"f-es", no_argument, 0, 0xF10},
 			{"f-rwrwm", no_argument, 0, 0xF11},
 			{"f-argres", no_argument, 0, 0xF12},
+			{"f-ms", no_argument, 0, 0xF13},
+			{"explore", required_argument, 0, 0xF14},
+#ifdef RESULT_CACHE
+			{"result-cache", no_argument, 0, 0xF15},
+#endif
+#ifdef ENABLE_TIMER
+			{"phase-profile", no_argument, 0, 0xF16},
+#endif
+			{"result-format", required_argument, 0, 0xF17},
+			{"f-extrapolate", no_argument, 0, 0xF18},
+			{"extrapolation-tol", required_argument, 0, 0xF19},
+			{"dddg-format", required_argument, 0, 0xF1A},
+			{"dddg-filter", required_argument, 0, 0xF1B},
 			{0, 0, 0, 0}
 		};
 		int optionIndex = 0;
@@ -299,7 +442,7 @@ void parseInputArguments(int argc, char **argv) {
 				args.outWorkDir = optarg;
 				break;
 			case 'c':
-				args.configFileName = optarg;
+				args.kernelConfigFileNames = splitCommaSeparated(optarg);
 				break;
 			case 'm':
 				optargStr = optarg;
@@ -334,28 +477,18 @@ void parseInputArguments(int argc, char **argv) {
 				break;
 #endif
 			case 'f':
-				args.frequency = std::stof(optarg);
+				frequencies.clear();
+				for(auto &it : splitCommaSeparated(optarg))
+					frequencies.push_back(std::stof(it));
 				break;
 			case 'u':
-				args.uncertainty = std::stof(optarg);
+				uncertainties.clear();
+				for(auto &it : splitCommaSeparated(optarg))
+					uncertainties.push_back(std::stof(it));
 				break;
 			case 'l':
-				optargStr = optarg;
-				commaPos = optargStr.find(",");
-				if(std::string::npos == commaPos) {
-					args.targetLoops.push_back(optargStr);
-				}
-				else {
-					while(optargStr.find(",") != std::string::npos) {
-						commaPos = optargStr.find(",");
-						std::string loopIndex = optargStr.substr(0, commaPos);
-						optargStr.erase(0, commaPos + 1);
-						if(loopIndex != "")
-							args.targetLoops.push_back(loopIndex);
-					}
-					if(optargStr != "")
-						args.targetLoops.push_back(optargStr);
-				}
+				for(auto &it : splitCommaSeparated(optarg))
+					args.targetLoops.push_back(it);
 				break;
 			case 0xF00:
 				args.memTrace = true;
@@ -414,6 +547,76 @@ void parseInputArguments(int argc, char **argv) {
 			case 0xF12:
 				args.fArgRes = true;
 				break;
+			case 0xF13:
+				args.fModuloScheduling = true;
+				break;
+			case 0xF14:
+				args.exploreFileName = optarg;
+				break;
+#ifdef RESULT_CACHE
+			case 0xF15:
+				args.resultCache = true;
+				break;
+#endif
+#ifdef ENABLE_TIMER
+			case 0xF16:
+				args.phaseProfile = true;
+				break;
+#endif
+			case 0xF17:
+				optargStr = optarg;
+				if(!optargStr.compare("jsonl"))
+					args.resultFormat = args.RESULT_FORMAT_JSONL;
+				else if(!optargStr.compare("csv"))
+					args.resultFormat = args.RESULT_FORMAT_CSV;
+				else if(!optargStr.compare("bin"))
+					args.resultFormat = args.RESULT_FORMAT_BINARY;
+				else {
+					errs() << "Invalid result format: " << optargStr << "\n";
+					exit(-1);
+				}
+				break;
+			case 0xF18:
+				args.fExtrapolate = true;
+				break;
+			case 0xF19:
+				args.extrapolationTolerance = strtof(optarg, &optargEnd) / 100;
+				if(optargEnd == optarg || *optargEnd != '\0') {
+					errs() << "Invalid extrapolation tolerance: " << optarg << "\n";
+					exit(-1);
+				}
+				break;
+			case 0xF1A:
+				optargStr = optarg;
+				if(!optargStr.compare("dot")) {
+					args.dddgFormat = args.DDDG_FORMAT_DOT;
+				}
+				else if(!optargStr.compare("bin")) {
+					args.dddgFormat = args.DDDG_FORMAT_BINARY;
+				}
+				else {
+					errs() << "Invalid DDDG format: " << optargStr << "\n";
+					exit(-1);
+				}
+				break;
+			case 0xF1B:
+				optargStr = optarg;
+				if(!optargStr.compare("cpath")) {
+					args.dddgFilter = args.DDDG_FILTER_CRITICAL_PATH;
+				}
+				else if(!optargStr.compare(0, 5, "iter:") && optargStr.size() > 5 && isdigit(optargStr[5])) {
+					args.dddgFilter = args.DDDG_FILTER_ITERATION;
+					args.dddgFilterIteration = strtoull(optarg + 5, &optargEnd, 10);
+					if(*optargEnd != '\0') {
+						errs() << "Invalid DDDG filter: " << optargStr << "\n";
+						exit(-1);
+					}
+				}
+				else {
+					errs() << "Invalid DDDG filter: " << optargStr << "\n";
+					exit(-1);
+				}
+				break;
 		}
 	}
 
@@ -426,7 +629,7 @@ void parseInputArguments(int argc, char **argv) {
 	args.outWorkDir += "/";
 #endif
 
-	if((argc - optind) != 2) {
+	if((argc - optind) < 2) {
 		errs() << "Missing input arguments (run \"" << argv[0] << " --help\" for help)\n";
 		exit(-1);
 	}
@@ -440,7 +643,22 @@ void parseInputArguments(int argc, char **argv) {
 	}
 
 	args.kernelNames.clear();
-	args.kernelNames.push_back(argv[optind + 1]);
+	for(int i = optind + 1; i < argc; i++) {
+		if(std::find(args.kernelNames.begin(), args.kernelNames.end(), argv[i]) != args.kernelNames.end()) {
+			errs() << "Kernel \"" << argv[i] << "\" was provided more than once\n";
+			exit(-1);
+		}
+		args.kernelNames.push_back(argv[i]);
+	}
+
+	// Either a single configuration file shared by all kernels or one per kernel
+	if(args.kernelConfigFileNames.size()) {
+		if(args.kernelConfigFileNames.size() != 1 && args.kernelConfigFileNames.size() != args.kernelNames.size()) {
+			errs() << "Number of configuration files must be either 1 or equal to the number of kernels\n";
+			exit(-1);
+		}
+		args.configFileName = args.kernelConfigFileNames[0];
+	}
 
 	if(!args.targetLoops.size())
 		args.targetLoops.push_back("0");
@@ -466,25 +684,103 @@ void parseInputArguments(int argc, char **argv) {
 	}
 #endif
 
-	if(args.uncertainty < 0.0 || args.uncertainty > 100.0) {
-		errs() << "Uncertainty must be between 0.0 and 100.0 %\n";
+	if(args.exploreFileName.size()) {
+		if(args.MODE_TRACE_ONLY == args.mode) {
+			errs() << "Design space exploration (--explore) requires cycle estimation\n";
+			exit(-1);
+		}
+		if(args.kernelNames.size() > 1) {
+			errs() << "Design space exploration (--explore) supports only a single kernel\n";
+			exit(-1);
+		}
+		if(uncertainties.size() > 1) {
+			errs() << "Design space exploration (--explore) supports only a single uncertainty value\n";
+			exit(-1);
+		}
+	}
+
+	if(!frequencies.size())
+		frequencies.push_back(args.frequency);
+	if(!uncertainties.size())
+		uncertainties.push_back(args.uncertainty);
+	if(uncertainties.size() != 1 && uncertainties.size() != frequencies.size()) {
+		errs() << "Number of uncertainties must be either 1 or equal to the number of target frequencies\n";
 		exit(-1);
 	}
-	if(args.frequency < 0.0) {
-		errs() << "Target frequency must be positive\n";
+
+	args.clockTargets.clear();
+	for(unsigned i = 0; i < frequencies.size(); i++) {
+		double frequency = frequencies[i];
+		double uncertainty = (1 == uncertainties.size())? uncertainties[0] : uncertainties[i];
+
+		if(uncertainty < 0.0 || uncertainty > 100.0) {
+			errs() << "Uncertainty must be between 0.0 and 100.0 %\n";
+			exit(-1);
+		}
+		if(frequency <= 0.0) {
+			errs() << "Target frequency must be positive\n";
+			exit(-1);
+		}
+		if(frequency > 500.0) {
+			errs() << "Lina does not support estimation with target frequency above 500 Mhz\n";
+			exit(-1);
+		}
+
+		args.clockTargets.push_back(std::make_pair(frequency, uncertainty));
+	}
+
+	// The first clock target is the reference one, used wherever a single clock is considered
+	args.frequency = args.clockTargets[0].first;
+	args.uncertainty = args.clockTargets[0].second;
+
+	if(args.clockTargets.size() > 1) {
+		if(args.compressed) {
+			errs() << "Clock sweep is not supported with compressed files (-x | --compressed)\n";
+			exit(-1);
+		}
+		if(args.fNPLA) {
+			errs() << "Clock sweep is not supported with non-perfect loop analysis (--f-npla)\n";
+			exit(-1);
+		}
+		if(args.fExtrapolate) {
+			errs() << "Clock sweep is not supported with extrapolation (--f-extrapolate)\n";
+			exit(-1);
+		}
+	}
+
+	if(args.fExtrapolate && args.fNPLA) {
+		errs() << "Extrapolation (--f-extrapolate) is not supported with non-perfect loop analysis (--f-npla)\n";
 		exit(-1);
 	}
-	if(args.frequency > 500.0) {
-		errs() << "Lina does not support estimation with target frequency above 500 Mhz\n";
+	if(args.extrapolationTolerance < 0.0) {
+		errs() << "Extrapolation tolerance must be non-negative\n";
+		exit(-1);
+	}
+
+	if(args.dddgFilter != args.DDDG_FILTER_NONE && args.dddgFormat != args.DDDG_FORMAT_DOT) {
+		errs() << "DDDG filters (--dddg-filter) are only supported with DOT dumps\n";
+		exit(-1);
+	}
+	// The critical path is only known after ALAP scheduling
+	if(args.DDDG_FILTER_CRITICAL_PATH == args.dddgFilter && args.showPreOptDDDG) {
+		errs() << "Critical path filter (--dddg-filter=cpath) is not supported with --show-pre-dddg\n";
 		exit(-1);
 	}
 
 	VERBOSE_PRINT(
 		errs() << "Input bitcode file: " << InputFilename << "\n";
-		errs() << "Kernel name: " << args.kernelNames[0] << "\n";
+		errs() << "Kernel name: " << args.kernelNames[0];
+		for(unsigned int i = 1; i < args.kernelNames.size(); i++)
+			errs() << ", " << args.kernelNames[i];
+		errs() << "\n";
 		errs() << "Input working directory: " << args.workDir << "\n";
 		errs() << "Output working directory: " << args.outWorkDir << "\n";
-		errs() << "Configuration file: " << args.configFileName << "\n";
+		errs() << "Configuration file: " << args.configFileName;
+		for(unsigned int i = 1; i < args.kernelConfigFileNames.size(); i++)
+			errs() << ", " << args.kernelConfigFileNames[i];
+		errs() << "\n";
+		if(args.exploreFileName.size())
+			errs() << "Design space file: " << args.exploreFileName << "\n";
 		errs() << "Mode: ";
 		switch(args.mode) {
 			case ArgPack::MODE_TRACE_ONLY:
@@ -513,10 +809,12 @@ void parseInputArguments(int argc, char **argv) {
 				errs() << "Xilinx Zynq-7000 SoC\n";
 				break;
 		}
-		errs() << "Target clock: " << std::to_string(args.frequency) << ((args.fNoTCS)? " MHz (disabled)\n" : " MHz\n");
-		errs() << "Clock uncertainty: " << std::to_string(args.uncertainty) << ((args.fNoTCS)? " % (disabled)\n" : " %\n");
-		errs() << "Target clock period: " << std::to_string(1000 / args.frequency) << ((args.fNoTCS)? " ns (disabled)\n" : " ns\n");
-		errs() << "Effective clock period: " << std::to_string((1000 / args.frequency) - (10 * args.uncertainty / args.frequency)) << ((args.fNoTCS)? " ns (disabled)\n" : " ns\n");
+		for(auto &it : args.clockTargets) {
+			errs() << "Target clock: " << std::to_string(it.first) << ((args.fNoTCS)? " MHz (disabled)\n" : " MHz\n");
+			errs() << "Clock uncertainty: " << std::to_string(it.second) << ((args.fNoTCS)? " % (disabled)\n" : " %\n");
+			errs() << "Target clock period: " << std::to_string(1000 / it.first) << ((args.fNoTCS)? " ns (disabled)\n" : " ns\n");
+			errs() << "Effective clock period: " << std::to_string((1000 / it.first) - (10 * it.second / it.first)) << ((args.fNoTCS)? " ns (disabled)\n" : " ns\n");
+		}
 		errs() << "Target loops: " << args.targetLoops[0];
 		for(unsigned int i = 1; i < args.targetLoops.size(); i++)
 			errs() << ", " << args.targetLoops[i];
@@ -525,7 +823,8 @@ void parseInputArguments(int argc, char **argv) {
 
 	// Loading kernel names into kernel_names vector
 	DEBUG(dbgs() << "We only focus on the kernel for this application: \n");
-	DEBUG(dbgs() << "\tKernel name: " << args.kernelNames[0] << "\n");
+	for(auto &it : args.kernelNames)
+		DEBUG(dbgs() << "\tKernel name: " << it << "\n");
 
 	DEBUG(dbgs() << "Please make sure all functions within a kernel function are included.");
 	DEBUG(dbgs() << "We also need to consider these functions. Otherwise, the tool will ");
@@ -0,0 +1,482 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <malloc.h>
+#include <memory>
+#include <sstream>
+#include <unistd.h>
+
+#include "profile_h/Extrapolator.h"
+#include "profile_h/SyntheticDatapath.h"
+
+using namespace llvm;
+
+const std::string helpMessage =
+	"lina-microbench: microbenchmarks of the DDDG optimisations and schedulers of Lina\n"
+	"    using synthetic DDDGs of controlled shape and size\n"
+	"\n"
+	"Usage: lina-microbench [OPTION]...\n"
+	"Where OPTION may be:\n"
+	"        -h        , --help             : this message\n"
+	"        -s SHAPES , --shapes=SHAPES    : comma-separated DDDG shapes to be generated, where\n"
+	"                                         SHAPE may be chain, reduction, stencil or random.\n"
+	"                                         Default is all shapes\n"
+	"        -n SIZES  , --sizes=SIZES      : comma-separated number of nodes of each generated\n"
+	"                                         DDDG. Default is 1000,10000,100000\n"
+	"        -g STAGES , --stages=STAGES    : comma-separated stages to be timed, where STAGE\n"
+	"                                         may be:\n"
+	"                                             slr : shared-load removal\n"
+	"                                             rsr : repeated-store removal\n"
+	"                                             thr : tree height reduction\n"
+	"                                             asap: ASAP scheduling\n"
+	"                                             alap: ALAP scheduling\n"
+	"                                             rcs : resource-constrained scheduling\n"
+	"                                                   without timing constraints\n"
+	"                                             tcs : resource-constrained scheduling\n"
+	"                                                   with timing constraints\n"
+	"                                         Default is all stages\n"
+	"        -r REPEAT , --repeat=REPEAT    : repeat each measurement REPEAT times, the median\n"
+	"                                         is reported. Default is 3\n"
+	"        -t TARGET , --target=TARGET    : select TARGET FPGA platform (see lina --help).\n"
+	"                                         Default is ZCU104. The tcs stage is skipped for\n"
+	"                                         platforms without timing-constrained scheduling\n"
+	"        -f FREQ   , --frequency=FREQ   : specify the target clock (in MHz). Default is 100\n"
+	"        -u UNCTY  , --uncertainty=UNCTY: specify the clock uncertainty (in %). Default is 27\n"
+	"        -o FILE   , --output=FILE      : write results as CSV to FILE. Default is stdout\n"
+	"        -v        , --verbose          : be verbose, print a lot of information\n"
+	"\n"
+	"DDDG generation flags:\n"
+	"                    --mem-ratio=RATIO  : ratio of memory operations among the generated\n"
+	"                                         values (chain and random). Default is 0.3\n"
+	"                    --store-ratio=RATIO: ratio of stores among the memory operations\n"
+	"                                         (chain and random). Default is 0.3\n"
+	"                    --arrays=NUM       : number of arrays accessed. Default is 2\n"
+	"                    --array-size=NUM   : number of 32-bit words of each array. Default is\n"
+	"                                         1024\n"
+	"                    --partition=FACTOR : cyclic partitioning factor of all arrays. Default\n"
+	"                                         is 4\n"
+	"                    --window=NUM       : maximum distance between a random operation and its\n"
+	"                                         operands. Default is 16\n"
+	"                    --float            : generate floating point instead of integer\n"
+	"                                         operations\n"
+	"                    --seed=SEED        : seed of the DDDG generator. Default is 1\n"
+	"\n"
+	"Time is the wall time of the stage alone (its prerequisites are prepared before). Memory\n"
+	"is the growth of the heap in use while the DDDG is generated and prepared (dddgKB) and\n"
+	"while the stage runs (stageKB). Memory allocated and freed inside the stage is not\n"
+	"accounted for. Without glibc 2.33 or above, resident set size is used instead, which is\n"
+	"an approximation since freed memory is not always returned to the system.\n";
+
+ArgPack args;
+#ifdef PROGRESSIVE_TRACE_CURSOR
+thread_local long int progressiveTraceCursor = 0;
+thread_local uint64_t progressiveTraceInstCount = 0;
+#endif
+
+std::vector<unsigned> shapes;
+std::vector<unsigned> sizes;
+std::vector<unsigned> stages;
+unsigned repeat;
+std::string outputFileName;
+SyntheticDatapath::shapeCfgTy baseCfg;
+
+void parseInputArguments(int argc, char **argv);
+long getCurrentMemoryKB();
+
+int main(int argc, char **argv) {
+#ifdef DBG_FILE
+	debugFile.open(DBG_FILE);
+#endif
+
+	parseInputArguments(argc, argv);
+
+	std::ofstream outputFile;
+	if(outputFileName.size()) {
+		outputFile.open(outputFileName);
+		if(!(outputFile.is_open())) {
+			errs() << "Could not open output file\n";
+			return 1;
+		}
+	}
+	std::ostream &out = outputFileName.size()? outputFile : std::cout;
+
+	// Configuration is the same for all generated DDDGs
+	std::string kernelName = "synthetic";
+	std::string loopName = constructLoopName(kernelName, 0);
+	ConfigurationManager CM(kernelName);
+	std::stringstream configFile;
+	SyntheticDatapath::writeConfiguration(baseCfg, configFile);
+	std::vector<std::string> pipelineLoopLevelVec;
+	CM.parseAndPopulate(pipelineLoopLevelVec, configFile);
+
+	// XXX: Optimisations are timed as separate stages, thus they are not performed inside prepareRCScheduling()
+	args.fNoSLROpt = true;
+	args.fRSROpt = false;
+	args.fTHRFloatOpt = false;
+	args.fTHRIntOpt = false;
+	args.fMemDisambuigOpt = false;
+	bool platformHasTCS = args.TARGET_XILINX_ZCU102 == args.target || args.TARGET_XILINX_ZCU104 == args.target;
+
+	out << "shape,stage,nodes,edges,result,ms,nsPerNode,nsPerEdge,dddgKB,stageKB,bytesPerNode,bytesPerEdge\n";
+
+	for(auto &shape : shapes) {
+		for(auto &stage : stages) {
+			if(SyntheticDatapath::STAGE_TC_SCHEDULING == stage && !platformHasTCS) {
+				errs() << "Skipping stage \"tcs\", selected platform does not support timing-constrained scheduling\n";
+				continue;
+			}
+
+			args.fNoTCS = !platformHasTCS || SyntheticDatapath::STAGE_RC_SCHEDULING == stage;
+
+			// Median times of the smallest and largest DDDGs, used to estimate how the stage scales
+			unsigned firstNodes = 0, lastNodes = 0;
+			double firstMs = 0, lastMs = 0;
+
+			for(auto &size : sizes) {
+				SyntheticDatapath::shapeCfgTy cfg = baseCfg;
+				cfg.shape = shape;
+				cfg.numOfNodes = size;
+
+				std::vector<double> times;
+				std::vector<long> dddgKBs, stageKBs;
+				unsigned numOfNodes = 0, numOfEdges = 0;
+				uint64_t result = 0;
+
+				for(unsigned i = 0; i < repeat; i++) {
+					long memBefore = getCurrentMemoryKB();
+					std::unique_ptr<SyntheticDatapath> datapath(new SyntheticDatapath(kernelName, CM, loopName, cfg));
+					datapath->prepareStage(stage);
+					long memPrepared = getCurrentMemoryKB();
+
+					numOfNodes = datapath->getNumNodes();
+					numOfEdges = datapath->getNumEdges();
+
+					std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+					result = datapath->runStage(stage);
+					times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+					dddgKBs.push_back(memPrepared - memBefore);
+					stageKBs.push_back(getCurrentMemoryKB() - memPrepared);
+				}
+
+				std::sort(times.begin(), times.end());
+				std::sort(dddgKBs.begin(), dddgKBs.end());
+				std::sort(stageKBs.begin(), stageKBs.end());
+				double ms = times[repeat / 2];
+				long dddgKB = dddgKBs[repeat / 2];
+				long stageKB = stageKBs[repeat / 2];
+				double totalBytes = (dddgKB + stageKB) * 1024.0;
+
+				out << SyntheticDatapath::getShapeName(shape) << "," << SyntheticDatapath::getStageName(stage) << "," <<
+					numOfNodes << "," << numOfEdges << "," << result << "," << ms << "," <<
+					(numOfNodes? ms * 1000000 / numOfNodes : 0) << "," << (numOfEdges? ms * 1000000 / numOfEdges : 0) << "," <<
+					dddgKB << "," << stageKB << "," <<
+					(numOfNodes? totalBytes / numOfNodes : 0) << "," << (numOfEdges? totalBytes / numOfEdges : 0) << "\n";
+				out.flush();
+
+				if(!firstNodes) {
+					firstNodes = numOfNodes;
+					firstMs = ms;
+				}
+				lastNodes = numOfNodes;
+				lastMs = ms;
+			}
+
+			// Exponent k of time ~ nodes^k between the smallest and largest DDDGs. Anything well above 1 is superlinear
+			if(lastNodes > firstNodes && firstMs > 0 && lastMs > 0) {
+				errs() << SyntheticDatapath::getShapeName(shape) << "/" << SyntheticDatapath::getStageName(stage) << ": time ~ nodes^" <<
+					std::to_string(std::log(lastMs / firstMs) / std::log((double) lastNodes / firstNodes)) << "\n";
+			}
+		}
+	}
+
+	if(outputFile.is_open())
+		outputFile.close();
+
+#ifdef DBG_FILE
+	debugFile.close();
+#endif
+
+	return 0;
+}
+
+long getCurrentMemoryKB() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+	// Memory in use by the heap is more precise than the resident set size, since the latter does not shrink when
+	// memory is freed and reused by the next allocations
+	struct mallinfo2 info = mallinfo2();
+	return (info.uordblks + info.hblkhd) / 1024;
+#else
+	std::ifstream statm("/proc/self/statm");
+	long size = 0, resident = 0;
+
+	if(!(statm >> size >> resident))
+		return 0;
+
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+std::vector<std::string> splitList(std::string list) {
+	std::vector<std::string> elements;
+	std::stringstream listStream(list);
+	std::string element;
+
+	while(std::getline(listStream, element, ',')) {
+		if(element.size())
+			elements.push_back(element);
+	}
+
+	return elements;
+}
+
+void parseInputArguments(int argc, char **argv) {
+	char temp[PATH_MAX];
+	if(NULL == getcwd(temp, PATH_MAX)) {
+		errs() << "Error: " << strerror(errno) << "\n";
+		exit(-1);
+	}
+	std::string optargStr;
+	std::vector<std::string> shapeNames;
+	std::vector<std::string> stageNames;
+
+	args.inputFileName = "";
+	args.workDir = temp;
+	args.outWorkDir = temp;
+	args.configFileName = "";
+	args.exploreFileName = "";
+	args.kernelNames.clear();
+	args.kernelNames.push_back("synthetic");
+	args.mode = args.MODE_ESTIMATE_ONLY;
+	args.target = args.TARGET_XILINX_ZCU104;
+	// Synthetic trace information is kept in memory
+	args.compressed = false;
+#ifdef PROGRESSIVE_TRACE_CURSOR
+	args.progressive = false;
+#endif
+#ifdef FUTURE_CACHE
+	args.futureCache = false;
+#endif
+#ifdef RESULT_CACHE
+	args.resultCache = false;
+#endif
+#ifdef ENABLE_TIMER
+	args.phaseProfile = false;
+#endif
+	args.frequency = 100.0;
+	args.uncertainty = 27;
+	args.verbose = false;
+	args.memTrace = false;
+	args.showCFG = false;
+	args.showCFGDetailed = false;
+	args.showPreOptDDDG = false;
+	args.showPostOptDDDG = false;
+	args.dddgFormat = args.DDDG_FORMAT_DOT;
+	args.dddgFilter = args.DDDG_FILTER_NONE;
+	args.dddgFilterIteration = 0;
+	args.showScheduling = false;
+	args.fNPLA = false;
+	args.fNoTCS = false;
+	args.fSBOpt = true;
+	args.fSLROpt = false;
+	args.fNoSLROpt = false;
+	args.fRSROpt = true;
+	args.fTHRFloatOpt = false;
+	args.fTHRIntOpt = false;
+	args.fMemDisambuigOpt = false;
+	args.fNoFPUThresOpt = false;
+	args.fExtraScalar = false;
+	args.fRWRWMem = false;
+	args.fModuloScheduling = false;
+	args.fArgRes = false;
+	args.fILL = true;
+	args.fExtrapolate = false;
+	args.extrapolationTolerance = EXTRAPOLATION_DEFAULT_TOLERANCE;
+
+	repeat = 3;
+	outputFileName = "";
+	baseCfg.shape = SyntheticDatapath::SHAPE_CHAIN;
+	baseCfg.numOfNodes = 0;
+	baseCfg.memRatio = 0.3;
+	baseCfg.storeRatio = 0.3;
+	baseCfg.numOfArrays = 2;
+	baseCfg.arraySize = 1024;
+	baseCfg.partitionFactor = 4;
+	baseCfg.window = 16;
+	baseCfg.floatingPoint = false;
+	baseCfg.seed = 1;
+
+	int c;
+	while(true) {
+		static struct option longOptions[] = {
+			{"help", no_argument, 0, 'h'},
+			{"shapes", required_argument, 0, 's'},
+			{"sizes", required_argument, 0, 'n'},
+			{"stages", required_argument, 0, 'g'},
+			{"repeat", required_argument, 0, 'r'},
+			{"target", required_argument, 0, 't'},
+			{"frequency", required_argument, 0, 'f'},
+			{"uncertainty", required_argument, 0, 'u'},
+			{"output", required_argument, 0, 'o'},
+			{"verbose", no_argument, 0, 'v'},
+			{"mem-ratio", required_argument, 0, 0xF00},
+			{"store-ratio", required_argument, 0, 0xF01},
+			{"arrays", required_argument, 0, 0xF02},
+			{"array-size", required_argument, 0, 0xF03},
+			{"partition", required_argument, 0, 0xF04},
+			{"window", required_argument, 0, 0xF05},
+			{"float", no_argument, 0, 0xF06},
+			{"seed", required_argument, 0, 0xF07},
+			{0, 0, 0, 0}
+		};
+		int optionIndex = 0;
+
+		c = getopt_long(argc, argv, "hs:n:g:r:t:f:u:o:v", longOptions, &optionIndex);
+		if(-1 == c)
+			break;
+
+		switch(c) {
+			case 'h':
+				errs() << helpMessage;
+				exit(-1);
+				break;
+			case 's':
+				shapeNames = splitList(optarg);
+				break;
+			case 'n':
+				sizes.clear();
+				for(auto &it : splitList(optarg))
+					sizes.push_back(std::stoul(it));
+				break;
+			case 'g':
+				stageNames = splitList(optarg);
+				break;
+			case 'r':
+				repeat = std::stoul(optarg);
+				break;
+			case 't':
+				optargStr = optarg;
+				if(!optargStr.compare("VC707"))
+					args.target = args.TARGET_XILINX_VC707;
+				else if(!optargStr.compare("ZCU102"))
+					args.target = args.TARGET_XILINX_ZCU102;
+				else if(!optargStr.compare("ZCU104"))
+					args.target = args.TARGET_XILINX_ZCU104;
+				else if(!optargStr.compare("ZC702"))
+					args.target = args.TARGET_XILINX_ZC702;
+				break;
+			case 'f':
+				args.frequency = std::stod(optarg);
+				break;
+			case 'u':
+				args.uncertainty = std::stod(optarg);
+				break;
+			case 'o':
+				outputFileName = optarg;
+				break;
+			case 'v':
+				args.verbose = true;
+				break;
+			case 0xF00:
+				baseCfg.memRatio = std::stod(optarg);
+				break;
+			case 0xF01:
+				baseCfg.storeRatio = std::stod(optarg);
+				break;
+			case 0xF02:
+				baseCfg.numOfArrays = std::stoul(optarg);
+				break;
+			case 0xF03:
+				baseCfg.arraySize = std::stoull(optarg);
+				break;
+			case 0xF04:
+				baseCfg.partitionFactor = std::stoull(optarg);
+				break;
+			case 0xF05:
+				baseCfg.window = std::stoul(optarg);
+				break;
+			case 0xF06:
+				baseCfg.floatingPoint = true;
+				break;
+			case 0xF07:
+				baseCfg.seed = std::stoul(optarg);
+				break;
+		}
+	}
+
+	// Note: The path should include \5C in Unix or / in Windows in the end!
+#ifdef _MSC_VER
+	args.workDir += "\\";
+	args.outWorkDir += "\\";
+#else
+	args.workDir += "/";
+	args.outWorkDir += "/";
+#endif
+
+	if(!shapeNames.size())
+		shapeNames = {"chain", "reduction", "stencil", "random"};
+	for(auto &it : shapeNames) {
+		unsigned shape = 0;
+		while(shape < SyntheticDatapath::SHAPE_COUNT && SyntheticDatapath::getShapeName(shape) != it)
+			shape++;
+
+		if(SyntheticDatapath::SHAPE_COUNT == shape) {
+			errs() << "Invalid DDDG shape \"" << it << "\"\n";
+			exit(-1);
+		}
+
+		shapes.push_back(shape);
+	}
+
+	if(!stageNames.size()) {
+		for(unsigned stage = 0; stage < SyntheticDatapath::STAGE_COUNT; stage++)
+			stages.push_back(stage);
+	}
+	for(auto &it : stageNames) {
+		unsigned stage = 0;
+		while(stage < SyntheticDatapath::STAGE_COUNT && SyntheticDatapath::getStageName(stage) != it)
+			stage++;
+
+		if(SyntheticDatapath::STAGE_COUNT == stage) {
+			errs() << "Invalid stage \"" << it << "\"\n";
+			exit(-1);
+		}
+
+		stages.push_back(stage);
+	}
+
+	if(!sizes.size())
+		sizes = {1000, 10000, 100000};
+	std::sort(sizes.begin(), sizes.end());
+
+	if(!repeat) {
+		errs() << "Number of repetitions must be positive\n";
+		exit(-1);
+	}
+	if(baseCfg.memRatio < 0.0 || baseCfg.memRatio > 1.0 || baseCfg.storeRatio < 0.0 || baseCfg.storeRatio > 1.0) {
+		errs() << "Memory and store ratios must be between 0.0 and 1.0\n";
+		exit(-1);
+	}
+	if(!(baseCfg.numOfArrays) || !(baseCfg.arraySize) || !(baseCfg.partitionFactor)) {
+		errs() << "Number of arrays, array size and partitioning factor must be positive\n";
+		exit(-1);
+	}
+	if(baseCfg.arraySize > 4194304) {
+		errs() << "Array size must not be above 4194304 words\n";
+		exit(-1);
+	}
+	if(args.uncertainty < 0.0 || args.uncertainty > 100.0) {
+		errs() << "Uncertainty must be between 0.0 and 100.0 %\n";
+		exit(-1);
+	}
+	if(args.frequency <= 0.0 || args.frequency > 500.0) {
+		errs() << "Target frequency must be positive and not above 500 MHz\n";
+		exit(-1);
+	}
+
+	args.clockTargets.clear();
+	args.clockTargets.push_back(std::make_pair(args.frequency, args.uncertainty));
+}
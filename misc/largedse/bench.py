@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+
+
+import json, os, shutil, statistics, subprocess, sys, time
+
+from run import Configurator, writeConfigFile, writeMakefile
+
+
+appName = os.path.splitext(sys.argv[0])[0].replace("./", "")
+
+# Kernels and design points are fixed so that results from different Lina versions are comparable
+benchExperiment = "hls"
+benchKernels = ["gemm", "syrk", "syr2k", "bicg", "mvt", "gesummv", "jacobi_1d", "jacobi_2d", "seidel_2d", "heat_3d", "floyd_warshall"]
+benchVersion = 1
+
+# Phases (as recorded by lina --phase-profile) accounted for in each reported category
+phaseCategories = {
+	"dddg": ["dddgBuild", "initBaseAddress"],
+	"optimisation": [
+		"removeInductionDependencies", "removePhiNodes", "storeBufferOptimisation", "memoryDisambiguation",
+		"removeSharedLoads", "removeRepeatedStores", "treeHeightReduction"
+	],
+	"scheduling": ["asapScheduling", "alapScheduling", "rcScheduling", "moduloScheduling", "resIIMem", "resIIOp", "recII"]
+}
+
+
+def selectDesignPoints(jsonContent, noOfPoints):
+	codes = []
+	cfgator = Configurator(jsonContent)
+
+	while cfgator.generateDesignPoint():
+		if not cfgator.bypass():
+			codes.append(cfgator.getCode())
+
+	# Evenly spaced over the enumeration order, so that the subset covers unrolling, pipelining and partitioning
+	if len(codes) <= noOfPoints:
+		return codes
+	if 1 == noOfPoints:
+		return [codes[0]]
+	return [codes[round(i * (len(codes) - 1) / (noOfPoints - 1))] for i in range(noOfPoints)]
+
+
+def generateDesignPoint(jsonContent, kernel, code, pointDir):
+	cfgator = Configurator(jsonContent)
+
+	while cfgator.generateDesignPoint():
+		if code == cfgator.getCode():
+			writeConfigFile(os.path.join(pointDir, "config.cfg"), kernel, jsonContent, cfgator)
+			return cfgator
+
+	raise KeyError("Design point \"{}\" not found for kernel \"{}\"".format(code, kernel))
+
+
+def readPhases(fileName):
+	with open(fileName, "r") as phasesF:
+		phases = json.loads(phasesF.read())
+
+	result = {"wall-s": phases["total"]["wallMs"] / 1000.0, "peak-rss-kb": phases["total"]["peakRSSKB"], "nodes": 0}
+	for cat in phaseCategories:
+		result["{}-s".format(cat)] = 0.0
+
+	for phase in phases["phases"]:
+		# Fused DDDG rewrites are recorded as a single phase (e.g. "removeInductionDependencies+removePhiNodes")
+		for cat in phaseCategories:
+			if any(name in phaseCategories[cat] for name in phase["phase"].split("+")):
+				result["{}-s".format(cat)] += phase["wallMs"] / 1000.0
+		if "dddgBuild" == phase["phase"] and "nodes" in phase["counters"]:
+			result["nodes"] += phase["counters"]["nodes"]
+
+	return result
+
+
+def generate(options, kernels):
+	modEnv = os.environ
+	if options["PATH"][1] is not None:
+		modEnv["PATH"] = "{}:{}".format(options["PATH"][1], modEnv["PATH"])
+	linaBaseCmd = ["lina", "-l", str(options["LOOPID"][1]), "--mode", "trace", "--phase-profile"]
+
+	for k in kernels:
+		baseDir = os.path.join(options["WORKSPACE"][1], k, "base")
+
+		# Traces are generated only once, further runs reuse them
+		if os.path.exists(os.path.join(baseDir, "dynamic_trace.gz")):
+			print("INFO: Trace for {} found, skipping".format(k))
+			continue
+
+		if os.path.exists(baseDir):
+			shutil.rmtree(baseDir)
+		os.makedirs(baseDir)
+
+		with open(os.path.join(benchExperiment, k, "{}.json".format(k)), "r") as jsonF:
+			jsonContent = json.loads(jsonF.read())
+
+		srcFiles = ["{}.h".format(k), "{}.cpp".format(k), "{}_tb.h".format(k), "{}_tb.cpp".format(k)]
+		if "support-files" in jsonContent:
+			srcFiles += jsonContent["support-files"]
+		for srcF in srcFiles:
+			shutil.copy(os.path.join(benchExperiment, k, srcF), os.path.join(baseDir, srcF))
+
+		print("INFO: Generating bitcode for {}".format(k))
+		writeMakefile(os.path.join(baseDir, "Makefile"), k)
+		with open(os.path.join(baseDir, "make.out"), "w") as outF:
+			subprocess.run(["make", "linked_opt.bc"], cwd=baseDir, env=modEnv, check=True, stderr=subprocess.STDOUT, stdout=outF)
+
+		print("INFO: Generating trace for {}".format(k))
+		with open(os.path.join(baseDir, "lina.trace.out"), "w") as outF:
+			before = time.time_ns()
+			subprocess.run(linaBaseCmd + ["linked_opt.bc", k], cwd=baseDir, env=modEnv, check=True, stderr=subprocess.STDOUT, stdout=outF)
+			after = time.time_ns()
+
+		with open(os.path.join(baseDir, "trace.time"), "w") as timeF:
+			timeF.write("{}ns\n".format(after - before))
+
+		print("INFO: Trace for {} generated in {:.3f}s".format(k, (after - before) / 1e9))
+
+
+def bench(options, kernels):
+	modEnv = os.environ
+	if options["PATH"][1] is not None:
+		modEnv["PATH"] = "{}:{}".format(options["PATH"][1], modEnv["PATH"])
+	uncStr = str(options["UNCERTAINTY"][1])
+	results = {"version": benchVersion, "points-per-kernel": options["POINTS"][1], "repeat": options["REPEAT"][1], "kernels": {}}
+
+	for k in kernels:
+		baseDir = os.path.join(options["WORKSPACE"][1], k, "base")
+		if not os.path.exists(os.path.join(baseDir, "dynamic_trace.gz")):
+			raise FileNotFoundError("Trace for kernel \"{}\" not found, run \"{} generate\" first".format(k, appName))
+
+		with open(os.path.join(benchExperiment, k, "{}.json".format(k)), "r") as jsonF:
+			jsonContent = json.loads(jsonF.read())
+
+		partStr = jsonContent["platform"].upper()
+		codes = selectDesignPoints(jsonContent, options["POINTS"][1])
+		kernelResult = {"points": codes, "runs": []}
+
+		with open(os.path.join(baseDir, "trace.time"), "r") as timeF:
+			kernelResult["trace-s"] = int(timeF.read().strip().replace("ns", "")) / 1e9
+
+		freqStrs = {}
+		for code in codes:
+			pointDir = os.path.join(options["WORKSPACE"][1], k, code)
+			if not os.path.exists(pointDir):
+				os.mkdir(pointDir)
+				for linkF in ["linked_opt.bc", "dynamic_trace.gz", "staticdatabase.db"]:
+					if os.path.exists(os.path.join(baseDir, linkF)):
+						os.symlink(os.path.join("..", "base", linkF), os.path.join(pointDir, linkF))
+			freqStrs[code] = str(int(generateDesignPoint(jsonContent, k, code, pointDir).getFrequency()))
+
+		# Each repetition estimates all selected design points. Caches are not used, so that every point is fully estimated
+		for r in range(options["REPEAT"][1]):
+			run = {"wall-s": 0.0, "peak-rss-kb": 0, "nodes": 0}
+			for cat in phaseCategories:
+				run["{}-s".format(cat)] = 0.0
+
+			for code in codes:
+				pointDir = os.path.join(options["WORKSPACE"][1], k, code)
+
+				print("INFO: Estimating {} {} (run {}/{})".format(k, code, r + 1, options["REPEAT"][1]))
+				with open(os.path.join(pointDir, "lina.bench.out"), "w") as outF:
+					subprocess.run(
+						[
+							"lina", "-c", "config.cfg",
+							"-l", str(options["LOOPID"][1]), "-t", partStr, "-f", freqStrs[code], "-u", uncStr,
+							"--f-argres", "--f-npla", "--mode", "estimation", "--phase-profile", "linked_opt.bc", k
+						],
+						cwd=pointDir, env=modEnv, check=True, stderr=subprocess.STDOUT, stdout=outF
+					)
+
+				pointResult = readPhases(os.path.join(pointDir, "{}_phases.json".format(k)))
+				for key in pointResult:
+					if "peak-rss-kb" == key:
+						run[key] = max(run[key], pointResult[key])
+					else:
+						run[key] += pointResult[key]
+
+			kernelResult["runs"].append(run)
+
+		# The median run is reported, which is less sensitive to noise than the mean
+		for key in kernelResult["runs"][0]:
+			kernelResult[key] = statistics.median([run[key] for run in kernelResult["runs"]])
+		kernelResult["points-per-s"] = len(codes) / kernelResult["wall-s"] if kernelResult["wall-s"] > 0 else 0.0
+		kernelResult["nodes-per-s"] = kernelResult["nodes"] / kernelResult["dddg-s"] if kernelResult["dddg-s"] > 0 else 0.0
+
+		print("INFO: {}: {:.3f} points/s, {:.0f} DDDG nodes/s".format(k, kernelResult["points-per-s"], kernelResult["nodes-per-s"]))
+		results["kernels"][k] = kernelResult
+
+	totalPoints = sum([len(results["kernels"][k]["points"]) for k in results["kernels"]])
+	totalWall = sum([results["kernels"][k]["wall-s"] for k in results["kernels"]])
+	totalNodes = sum([results["kernels"][k]["nodes"] for k in results["kernels"]])
+	totalDDDG = sum([results["kernels"][k]["dddg-s"] for k in results["kernels"]])
+	results["total"] = {
+		"points-per-s": totalPoints / totalWall if totalWall > 0 else 0.0,
+		"nodes-per-s": totalNodes / totalDDDG if totalDDDG > 0 else 0.0
+	}
+
+	with open(options["RESULTS"][1], "w") as resultsF:
+		resultsF.write(json.dumps(results, indent=4))
+
+	print("INFO: Total: {:.3f} points/s, {:.0f} DDDG nodes/s".format(results["total"]["points-per-s"], results["total"]["nodes-per-s"]))
+	print("INFO: Results saved to {}".format(options["RESULTS"][1]))
+
+
+def compare(options, kernels):
+	with open(options["RESULTS"][1], "r") as resultsF:
+		results = json.loads(resultsF.read())
+	with open(options["BASELINE"][1], "r") as baselineF:
+		baseline = json.loads(baselineF.read())
+
+	if results["version"] != baseline["version"] or results["points-per-kernel"] != baseline["points-per-kernel"]:
+		raise RuntimeError("Results and baseline were generated with different benchmark settings")
+
+	threshold = options["THRESHOLD"][1]
+	regressions = 0
+
+	# Throughput metrics: higher is better. Times: lower is better
+	metrics = [("points-per-s", True), ("nodes-per-s", True), ("trace-s", False), ("optimisation-s", False), ("scheduling-s", False)]
+
+	print("{:16s} {:16s} {:>14s} {:>14s} {:>9s}".format("kernel", "metric", "baseline", "current", "change"))
+	for k in kernels:
+		if k not in results["kernels"] or k not in baseline["kernels"]:
+			print("{:16s} not present in both results and baseline, skipping".format(k))
+			continue
+
+		for metric, higherIsBetter in metrics:
+			base = baseline["kernels"][k][metric]
+			curr = results["kernels"][k][metric]
+			if 0 == base:
+				continue
+
+			change = 100.0 * (curr - base) / base
+			regression = (-change if higherIsBetter else change) > threshold
+			regressions += 1 if regression else 0
+
+			print("{:16s} {:16s} {:14.3f} {:14.3f} {:+8.2f}%{}".format(k, metric, base, curr, change, " REGRESSION" if regression else ""))
+
+	if regressions:
+		print("{} regression(s) above {}% found".format(regressions, threshold))
+		exit(1)
+	else:
+		print("No regressions above {}% found".format(threshold))
+
+
+if "__main__" == __name__:
+	options = {
+		"PATH": [str, None],
+		"WORKSPACE": [str, "benchspace"],
+		"RESULTS": [str, "bench.json"],
+		"BASELINE": [str, "bench.baseline.json"],
+		"POINTS": [int, 4],
+		"REPEAT": [int, 3],
+		"THRESHOLD": [float, 5.0],
+		"UNCERTAINTY": [float, 27.0],
+		"LOOPID": [int, 0]
+	}
+	filteredArgv = [x for x in sys.argv[1:] if "=" not in x]
+	for x in sys.argv[1:]:
+		if "=" in x:
+			xSplit = x.split("=")
+
+			if xSplit[0] not in options:
+				raise KeyError("Option not found: {}".format(xSplit[0]))
+
+			options[xSplit[0]][1] = options[xSplit[0]][0](xSplit[1])
+			print("INFO: Option {} set to {}".format(xSplit[0], options[xSplit[0]][1]))
+
+	if len(filteredArgv) < 1:
+		sys.stderr.write("Usage: {} [OPTION=VALUE]... COMMAND [KERNELS]...\n".format(appName))
+		sys.stderr.write("    [OPTION=VALUE]... change options (e.g. REPEAT=5):\n")
+		sys.stderr.write("                          PATH        the path to Lina and its LLVM bins\n")
+		sys.stderr.write("                                      (will use $PATH when omitted)\n")
+		sys.stderr.write("                                      DEFAULT: empty\n")
+		sys.stderr.write("                          WORKSPACE   folder where traces and design points\n")
+		sys.stderr.write("                                      are generated\n")
+		sys.stderr.write("                                      DEFAULT: benchspace\n")
+		sys.stderr.write("                          RESULTS     benchmark results file\n")
+		sys.stderr.write("                                      DEFAULT: bench.json\n")
+		sys.stderr.write("                          BASELINE    baseline results file used by \"compare\"\n")
+		sys.stderr.write("                                      DEFAULT: bench.baseline.json\n")
+		sys.stderr.write("                          POINTS      number of design points per kernel\n")
+		sys.stderr.write("                                      DEFAULT: 4\n")
+		sys.stderr.write("                          REPEAT      number of repetitions (median is reported)\n")
+		sys.stderr.write("                                      DEFAULT: 3\n")
+		sys.stderr.write("                          THRESHOLD   regression tolerance, in % (\"compare\")\n")
+		sys.stderr.write("                                      DEFAULT: 5.0\n")
+		sys.stderr.write("                          UNCERTAINTY (in %)\n")
+		sys.stderr.write("                                      DEFAULT: 27.0\n")
+		sys.stderr.write("                          LOOPID      the loop nest number to be analysed by\n")
+		sys.stderr.write("                                      Lina\n")
+		sys.stderr.write("                                      DEFAULT: 0\n")
+		sys.stderr.write("    COMMAND           may be\n")
+		sys.stderr.write("                          generate    generate bitcode and traces (only once)\n")
+		sys.stderr.write("                          bench       estimate the design points and save results\n")
+		sys.stderr.write("                          compare     compare results against baseline\n")
+		sys.stderr.write("    [KERNELS]...      the kernels to run the command on\n")
+		sys.stderr.write("                      (will consider all benchmark kernels when omitted)\n")
+		exit(-1)
+
+	command = filteredArgv[0]
+	kernels = benchKernels if 1 == len(filteredArgv) else filteredArgv[1:]
+
+	if "generate" == command:
+		generate(options, kernels)
+	elif "bench" == command:
+		bench(options, kernels)
+	elif "compare" == command:
+		compare(options, kernels)
+	else:
+		raise RuntimeError("Invalid command received: {}".format(command))
@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+
+
+import json, struct, sys
+
+
+# Must match include/profile_h/BaseDatapath.h
+binaryMagic = b"LINADDG"
+binaryVersion = 2
+nodeFormat = "=BQQ"
+edgeFormat = "=IIB"
+
+
+# Read a DDDG dumped with lina --dddg-format=bin. Returns the nodes (dicts with microop and ASAP/ALAP scheduled
+# times, indexed by node ID) and the edges (dicts with from, to and weight)
+def readDDDG(fileName):
+	with open(fileName, "rb") as inFile:
+		data = inFile.read()
+
+	if data[:len(binaryMagic)] != binaryMagic:
+		raise ValueError("{}: not a Lina DDDG file".format(fileName))
+	offset = len(binaryMagic)
+	version, numNodes, numEdges = struct.unpack_from("=IQQ", data, offset)
+	if version != binaryVersion:
+		raise ValueError("{}: unsupported DDDG file version".format(fileName))
+	offset += struct.calcsize("=IQQ")
+
+	nodes = []
+	for microop, asap, alap in struct.iter_unpack(nodeFormat, data[offset:offset + numNodes * struct.calcsize(nodeFormat)]):
+		nodes.append({"microop": microop, "asap": asap, "alap": alap})
+	offset += numNodes * struct.calcsize(nodeFormat)
+
+	edges = []
+	for source, target, weight in struct.iter_unpack(edgeFormat, data[offset:offset + numEdges * struct.calcsize(edgeFormat)]):
+		edges.append({"from": source, "to": target, "weight": weight})
+	offset += numEdges * struct.calcsize(edgeFormat)
+
+	if offset != len(data):
+		raise ValueError("{}: corrupt DDDG file".format(fileName))
+
+	return nodes, edges
+
+
+if "__main__" == __name__:
+	if len(sys.argv) != 2:
+		print("Usage: {} DDDGFILE".format(sys.argv[0]))
+		print("    Print the nodes and edges of a DDDG dumped by lina --dddg-format=bin as JSON lines")
+		exit(-1)
+
+	nodes, edges = readDDDG(sys.argv[1])
+	for nodeID, node in enumerate(nodes):
+		print(json.dumps(dict(node, node=nodeID)))
+	for edge in edges:
+		print(json.dumps(edge))
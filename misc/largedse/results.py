@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+
+
+import csv, json, os, struct, sys
+
+
+# Must match include/profile_h/ResultWriter.h
+binaryMagic = b"LINARES"
+binaryVersion = 1
+recordEstimation = 0
+recordCache = 1
+
+# Fixed fields of an estimation record, in the order they are written (s: string, u: unsigned, d: double)
+estimationFields = [
+	("point", "s"), ("loop", "s"), ("level", "u"), ("type", "s"),
+	("frequency", "d"), ("uncertainty", "d"), ("effectivePeriod", "d"), ("achievedPeriod", "d"),
+	("unroll", "u"), ("pipelining", "u"),
+	("cycles", "u"), ("asapIL", "u"), ("rcIL", "u"), ("ii", "u"),
+	("resIIMem", "u"), ("resIIMemArray", "s"), ("resIIOp", "u"), ("resIIOpUnit", "s"), ("recII", "u"), ("limitedBy", "s"),
+	("sharedLoads", "u"), ("repeatedStores", "u"),
+	("dsps", "u"), ("ffs", "u"), ("luts", "u"), ("bram18k", "u")
+]
+
+
+class BinaryReader:
+	def __init__(self, data):
+		self.data = data
+		self.offset = 0
+
+	def eof(self):
+		return self.offset >= len(self.data)
+
+	def read(self, fmt):
+		value = struct.unpack_from(fmt, self.data, self.offset)[0]
+		self.offset += struct.calcsize(fmt)
+		return value
+
+	def readString(self):
+		size = self.read("=I")
+		value = self.data[self.offset:self.offset + size].decode()
+		self.offset += size
+		return value
+
+	def readField(self, fieldType):
+		if "s" == fieldType:
+			return self.readString()
+		elif "d" == fieldType:
+			return self.read("=d")
+		else:
+			return self.read("=Q")
+
+
+def readBinary(fileName):
+	with open(fileName, "rb") as inFile:
+		reader = BinaryReader(inFile.read())
+
+	if reader.data[:len(binaryMagic)] != binaryMagic:
+		raise ValueError("{}: not a Lina result file".format(fileName))
+	reader.offset = len(binaryMagic)
+	if reader.read("=I") != binaryVersion:
+		raise ValueError("{}: unsupported result file version".format(fileName))
+
+	records = []
+	while not reader.eof():
+		recordType = reader.read("=B")
+
+		if recordCache == recordType:
+			records.append({"record": "cache", "cache": reader.readString(), "miss": reader.read("=Q"), "hit": reader.read("=Q")})
+		elif recordEstimation == recordType:
+			record = {"record": "estimation"}
+			for name, fieldType in estimationFields:
+				record[name] = reader.readField(fieldType)
+			record["pipelining"] = bool(record["pipelining"])
+
+			record["values"] = {}
+			for i in range(reader.read("=Q")):
+				name = reader.readString()
+				numeric = reader.read("=B")
+				value = reader.readString()
+				record["values"][name] = json.loads(value) if numeric else value
+
+			record["resources"] = []
+			for i in range(reader.read("=Q")):
+				record["resources"].append({
+					"name": reader.readString(), "fus": reader.read("=Q"), "dsps": reader.read("=Q"), "ffs": reader.read("=Q"), "luts": reader.read("=Q")
+				})
+
+			records.append(record)
+		else:
+			raise ValueError("{}: corrupt result file".format(fileName))
+
+	return records
+
+
+def readJSONL(fileName):
+	with open(fileName, "r") as inFile:
+		return [json.loads(line) for line in inFile if line.strip()]
+
+
+def readCSV(fileName):
+	types = {name: fieldType for name, fieldType in estimationFields}
+	records = []
+
+	with open(fileName, "r") as inFile:
+		for row in csv.DictReader(inFile):
+			record = {"record": "estimation"}
+			for name, value in row.items():
+				if "s" == types[name]:
+					record[name] = value
+				elif "d" == types[name]:
+					record[name] = float(value)
+				else:
+					record[name] = int(value)
+			record["pipelining"] = bool(record["pipelining"])
+			records.append(record)
+
+	return records
+
+
+# Read a file written by lina --result-format=FMT. Returns a list of records (dicts) with the same keys as the jsonl format
+def readResults(fileName):
+	extension = os.path.splitext(fileName)[1]
+
+	if ".bin" == extension:
+		return readBinary(fileName)
+	elif ".csv" == extension:
+		return readCSV(fileName)
+	else:
+		return readJSONL(fileName)
+
+
+if "__main__" == __name__:
+	if len(sys.argv) != 2:
+		print("Usage: {} RESULTFILE".format(sys.argv[0]))
+		print("    Print the records of a result file written by lina --result-format as JSON lines")
+		exit(-1)
+
+	for record in readResults(sys.argv[1]):
+		print(json.dumps(record))
@@ -273,6 +273,67 @@ class Configurator(object):
 			return
 
 
+def writeConfigFile(fileName, kernel, jsonContent, cfg):
+	with open(fileName, "w") as outFile:
+		# Write basic array info
+		for a in jsonContent["arrays"]:
+			wordSize = int(jsonContent["arrays"][a]["size"])
+			totalSize = int(jsonContent["arrays"][a]["words"]) * wordSize
+			# Args are not resource-counted in Lina (unless --f-argres is active, check the makefile string above)
+			# By default arrays will be considered as "arg" and inarrays as "rovar/rwvar" depending on the readonly flag
+			# You can override an array scope by using the "forcescope" flag
+			scope = "arg"
+			if "forcescope" in jsonContent["arrays"][a]:
+				scope = jsonContent["arrays"][a]["forcescope"]
+			outFile.write("array,{},{},{},{}\n".format(a, totalSize, wordSize, scope))
+
+		# Write inarrays, that are not going to be partitioned
+		if "inarrays" in jsonContent:
+			for a in jsonContent["inarrays"]:
+				wordSize = int(jsonContent["inarrays"][a]["size"])
+				totalSize = int(jsonContent["inarrays"][a]["words"]) * wordSize
+				readonly = jsonContent["inarrays"][a]["readonly"] if "readonly" in jsonContent["inarrays"][a] else False
+				outFile.write("array,{},{},{},{}\n".format(a, totalSize, wordSize, "rovar" if readonly else "rwvar"))
+
+		# Write partitioning info
+		for arr in cfg.getArrays():
+			if "complete" == arr["type"]:
+				wordSize = int(jsonContent["arrays"][arr["name"]]["size"])
+				totalSize = int(jsonContent["arrays"][arr["name"]]["words"]) * wordSize
+				outFile.write("partition,complete,{},{}\n".format(arr["name"], totalSize))
+			elif arr["type"] in ("cyclic", "block"):
+				wordSize = int(jsonContent["arrays"][arr["name"]]["size"])
+				totalSize = int(jsonContent["arrays"][arr["name"]]["words"]) * wordSize
+				outFile.write("partition,{},{},{},{},{}\n".format(arr["type"], arr["name"], totalSize, wordSize, arr["factor"]))
+
+		# Write loop info
+		for lop in cfg.getLoops():
+			if lop["pipelining"]:
+				outFile.write("pipeline,{},{},{}\n".format(kernel, lop["id"], lop["depth"]))
+			if lop["unrolling"] is not None:
+				loopCfg = jsonContent["loops"][lop["id"]]
+				for j in range(lop["depth"] - 1):
+					loopCfg = loopCfg["nest"]
+				outFile.write("unrolling,{},{},{},{},{}\n".format(kernel, lop["id"], lop["depth"], loopCfg["line"], lop["unrolling"]))
+
+
+def writeMakefile(fileName, kernel):
+	with open(fileName, "w") as mkF:
+		mkF.write(
+			"linked_opt.bc: linked.bc\n"
+			"	opt -mem2reg -instnamer -lcssa -indvars linked.bc -o linked_opt.bc\n"
+			"\n"
+			"linked.bc: main.bc {0}.bc\n"
+			"	llvm-link main.bc {0}.bc -o linked.bc\n"
+			"\n"
+			"main.bc: {0}_tb.cpp {0}.h {0}_tb.h\n"
+			"	clang -g -O1 -emit-llvm -c {0}_tb.cpp -o main.bc\n"
+			"\n"
+			"{0}.bc: {0}.cpp {0}.h\n"
+			"	clang -g -O1 -emit-llvm -c {0}.cpp -o {0}.bc\n".format(kernel)
+		)
+
+
 def generate(console, options, experiment, kernels):
 	if not os.path.exists("workspace"):
 		os.mkdir("workspace")
@@ -377,63 +438,10 @@ def generate(console, options, experiment, kernels):
 				os.path.join("workspace", experiment, k, code, "dynamic_trace.gz")
 			)
 
-			with open(os.path.join("workspace", experiment, k, code, "config.cfg"), "w") as outFile:
-				# Write basic array info
-				for a in jsonContent["arrays"]:
-					wordSize = int(jsonContent["arrays"][a]["size"])
-					totalSize = int(jsonContent["arrays"][a]["words"]) * wordSize
-					# Args are not resource-counted in Lina (unless --f-argres is active, check the makefile string above)
-					# By default arrays will be considered as "arg" and inarrays as "rovar/rwvar" depending on the readonly flag
-					# You can override an array scope by using the "forcescope" flag
-					scope = "arg"
-					if "forcescope" in jsonContent["arrays"][a]:
-						scope = jsonContent["arrays"][a]["forcescope"]
-					outFile.write("array,{},{},{},{}\n".format(a, totalSize, wordSize, scope))
-
-				# Write inarrays, that are not going to be partitioned
-				if "inarrays" in jsonContent:
-					for a in jsonContent["inarrays"]:
-						wordSize = int(jsonContent["inarrays"][a]["size"])
-						totalSize = int(jsonContent["inarrays"][a]["words"]) * wordSize
-						readonly = jsonContent["inarrays"][a]["readonly"] if "readonly" in jsonContent["inarrays"][a] else False
-						outFile.write("array,{},{},{},{}\n".format(a, totalSize, wordSize, "rovar" if readonly else "rwvar"))
-
-				# Write partitioning info
-				for arr in cfgGen.getArrays():
-					if "complete" == arr["type"]:
-						wordSize = int(jsonContent["arrays"][arr["name"]]["size"])
-						totalSize = int(jsonContent["arrays"][arr["name"]]["words"]) * wordSize
-						outFile.write("partition,complete,{},{}\n".format(arr["name"], totalSize))
-					elif arr["type"] in ("cyclic", "block"):
-						wordSize = int(jsonContent["arrays"][arr["name"]]["size"])
-						totalSize = int(jsonContent["arrays"][arr["name"]]["words"]) * wordSize
-						outFile.write("partition,{},{},{},{},{}\n".format(arr["type"], arr["name"], totalSize, wordSize, arr["factor"]))
-
-				# Write loop info
-				for lop in cfgGen.getLoops():
-					if lop["pipelining"]:
-						outFile.write("pipeline,{},{},{}\n".format(k, lop["id"], lop["depth"]))
-					if lop["unrolling"] is not None:
-						loopCfg = jsonContent["loops"][lop["id"]]
-						for j in range(lop["depth"] - 1):
-							loopCfg = loopCfg["nest"]
-						outFile.write("unrolling,{},{},{},{},{}\n".format(k, lop["id"], lop["depth"], loopCfg["line"], lop["unrolling"]))
+			writeConfigFile(os.path.join("workspace", experiment, k, code, "config.cfg"), k, jsonContent, cfgGen)
 
 		console.setProgress(0, 100, "Generating base LLVM IR and bytecodes...")
-		with open(os.path.join("workspace", experiment, k, "base", "Makefile"), "w") as mkF:
-			mkF.write(
-				"linked_opt.bc: linked.bc\n"
-				"	opt -mem2reg -instnamer -lcssa -indvars linked.bc -o linked_opt.bc\n"
-				"\n"
-				"linked.bc: main.bc {0}.bc\n"
-				"	llvm-link main.bc {0}.bc -o linked.bc\n"
-				"\n"
-				"main.bc: {0}_tb.cpp {0}.h {0}_tb.h\n"
-				"	clang -g -O1 -emit-llvm -c {0}_tb.cpp -o main.bc\n"
-				"\n"
-				"{0}.bc: {0}.cpp {0}.h\n"
-				"	clang -g -O1 -emit-llvm -c {0}.cpp -o {0}.bc\n".format(k)
-			)
+		writeMakefile(os.path.join("workspace", experiment, k, "base", "Makefile"), k)
 		with open(os.path.join("workspace", experiment, k, "base", "make.out"), "w") as outF:
 			subprocess.run(
 				["make", "linked_opt.bc"],
@@ -523,10 +531,12 @@ def explore(console, options, experiment, kernels):
 
 			if "yes" == options["CACHE"][1]:
 				for i in range(noOfJobs):
-					console.setProgress(i, 0, "Removing futurecache.db.{}...".format(i), "Exploring {} (job {})".format(k, i + 1))
+					console.setProgress(i, 0, "Removing futurecache.db and resultcache.db...", "Exploring {} (job {})".format(k, i + 1))
 
-					if os.path.exists(os.path.join("workspace", experiment, k, "base", "futurecache.db.{}".format(i))):
-						os.remove(os.path.join("workspace", experiment, k, "base", "futurecache.db.{}".format(i)))
+				# The cache files are shared among all jobs (Lina locks them on access)
+				for cacheFile in ["futurecache.db", "resultcache.db"]:
+					if os.path.exists(os.path.join("workspace", experiment, k, "base", cacheFile)):
+						os.remove(os.path.join("workspace", experiment, k, "base", cacheFile))
 			else:
 				for i in range(noOfJobs):
 					console.setProgress(i, 0, "Preparing...", "Exploring {} (job {})".format(k, i + 1))
@@ -564,17 +574,18 @@ def explore(console, options, experiment, kernels):
 							#	outFs[j] = open(os.path.join("workspace", experiment, k, code, "lina.explore.out"), "w")
 
 							if "yes" == options["CACHE"][1]:
-								console.setProgress(j, int(100 * (totalScheduled / totalPoints)), "Creating cache soft-link...")
-								if os.path.lexists(os.path.join("workspace", experiment, k, code, "futurecache.db")):
-									os.remove(os.path.join("workspace", experiment, k, code, "futurecache.db"))
-								os.symlink(
-									os.path.join("..", "base", "futurecache.db.{}".format(j)),
-									os.path.join("workspace", experiment, k, code, "futurecache.db")
-								)
+								console.setProgress(j, int(100 * (totalScheduled / totalPoints)), "Creating cache soft-links...")
+								for cacheFile in ["futurecache.db", "resultcache.db"]:
+									if os.path.lexists(os.path.join("workspace", experiment, k, code, cacheFile)):
+										os.remove(os.path.join("workspace", experiment, k, code, cacheFile))
+									os.symlink(
+										os.path.join("..", "base", cacheFile),
+										os.path.join("workspace", experiment, k, code, cacheFile)
+									)
 
 								threads[j] = threading.Thread(target=lambda: subprocess.run(
 									linaBaseCmd + [
-										"-p", "-C", "-c", "config.cfg",
+										"-p", "-C", "--result-cache", "-c", "config.cfg",
 										"-l", loopIDStr, "-t", partStr, "-f", freqStr, "-u", uncStr,
 										"--f-argres", "--f-npla", "--mode", "estimation", "linked_opt.bc", k
 									],